@@ -0,0 +1,124 @@
+"""
+A directory of build artifacts (generated C files and compiled extension
+modules), keyed by a content hash of everything they were built from.
+
+The directory can be shared by concurrent builds: entries are written
+to a temporary file and renamed into place, so readers only ever see
+complete files, and reading an entry that was just evicted by another
+build is simply a cache miss.  Entries are evicted in least recently
+used order, where using an entry updates its modification time.
+"""
+
+import os
+import shutil
+
+from Cython.Utils import write_file_atomically
+
+try:
+    import gzip
+    gzip_open = gzip.open
+    gzip_ext = '.gz'
+except ImportError:
+    gzip_open = open
+    gzip_ext = ''
+
+default_cache_size = 1024 * 1024 * 100
+
+# leftovers of interrupted writes older than this are removed
+stale_tmp_age = 24 * 60 * 60
+
+
+def copy_file(source, target, open_source=open, open_target=open):
+    f = open_source(source, 'rb')
+    try:
+        write_file_atomically(
+            target, lambda g: shutil.copyfileobj(f, g), open_file=open_target)
+    finally:
+        f.close()
+
+
+class ArtifactCache(object):
+
+    def __init__(self, directory):
+        self.directory = directory
+
+    def entry_path(self, name, key):
+        base, ext = os.path.splitext(os.path.basename(name))
+        path = os.path.join(self.directory, '%s-%s%s' % (base, key, ext))
+        if self.compressed(name):
+            path += gzip_ext
+        return path
+
+    def compressed(self, name):
+        # Cython-generated C files are highly compressible.
+        # (E.g. a compression ratio of about 10 for Sage).
+        return os.path.splitext(name)[1] in ('.c', '.cpp')
+
+    def load(self, key, target):
+        """
+        Copy the entry for 'key' to the 'target' path.  Returns False if
+        there is no such entry.
+        """
+        path = self.entry_path(target, key)
+        try:
+            if self.compressed(target):
+                copy_file(path, target, open_source=gzip_open)
+            else:
+                copy_file(path, target)
+            os.utime(path, None)
+        except EnvironmentError:
+            return False
+        return True
+
+    def store(self, key, source):
+        """
+        Store the file 'source' as entry for 'key'.
+        """
+        if not os.path.isdir(self.directory):
+            try:
+                os.makedirs(self.directory)
+            except OSError:
+                if not os.path.isdir(self.directory):
+                    raise
+        path = self.entry_path(source, key)
+        if self.compressed(source):
+            copy_file(source, path, open_target=gzip_open)
+        else:
+            copy_file(source, path)
+
+    def cleanup(self, target_size=default_cache_size, ratio=.85):
+        """
+        Evict the least recently used entries until the cache is smaller
+        than 'ratio' times 'target_size', if it is larger than that.
+        """
+        if not os.path.isdir(self.directory):
+            return
+        now = None
+        total_size = 0
+        entries = []
+        for name in os.listdir(self.directory):
+            path = os.path.join(self.directory, name)
+            try:
+                s = os.stat(path)
+                if name.endswith('.tmp'):
+                    if now is None:
+                        import time
+                        now = time.time()
+                    if s.st_mtime < now - stale_tmp_age:
+                        os.unlink(path)
+                    continue
+            except OSError:
+                continue  # removed by a concurrent build
+            total_size += s.st_size
+            entries.append((s.st_mtime, s.st_size, path))
+        if total_size <= target_size:
+            return
+        entries.sort()
+        for mtime, size, path in entries:
+            try:
+                os.unlink(path)
+            except OSError:
+                pass
+            total_size -= size
+            if total_size < target_size * ratio:
+                break
@@ -3,15 +3,11 @@ from Cython import __version__
 
 from glob import glob
 import re, os, sys
+
 try:
-    import gzip
-    gzip_open = gzip.open
-    gzip_ext = '.gz'
+    import cPickle as pickle
 except ImportError:
-    gzip_open = open
-    gzip_ext = ''
-import shutil
-import subprocess
+    import pickle
 
 try:
     import hashlib
@@ -24,6 +20,9 @@ from distutils.extension import Extension
 from Cython import Utils
 from Cython.Utils import cached_function, cached_method, path_exists
 from Cython.Compiler.Main import Context, CompilationOptions, default_options
+from Cython.Compiler.CodeSplitting import part_files
+from Cython.Compiler import Timings
+from Cython.Build.Cache import ArtifactCache, default_cache_size
     
 join_path = cached_function(os.path.join)
 
@@ -61,14 +60,60 @@ def extended_iglob(pattern):
         for path in glob(pattern):
             yield path
 
-@cached_function
 def file_hash(filename):
+    # cached for as long as the file seems unchanged
+    s = os.stat(filename)
+    return _file_hash(filename, s.st_mtime, s.st_size)
+
+@cached_function
+def _file_hash(filename, mtime, size):
     path = os.path.normpath(filename.encode("UTF-8"))
-    m = hashlib.md5(str(len(path)) + ":")
+    m = hashlib.md5(("%d:" % len(path)).encode("ASCII"))
     m.update(path)
-    m.update(open(filename).read())
+    f = open(filename, 'rb')
+    try:
+        m.update(f.read())
+    finally:
+        f.close()
     return m.hexdigest()
 
+def options_fingerprint(options):
+    # everything in the compilation options that can change the C output
+    items = []
+    for name, value in sorted(options.__dict__.items()):
+        if name in ('output_file', 'fingerprint', 'cache', 'cache_size',
+                    'pxd_cache', 'quiet', 'verbose', 'timings'):
+            continue
+        if isinstance(value, dict):
+            value = sorted(value.items())
+        items.append((name, value))
+    from Cython.Compiler import Options
+    items.extend(sorted([
+        (name, value) for name, value in vars(Options).items()
+        if not name.startswith('_') and
+           isinstance(value, (basestring, int, long, float, bool, type(None)))]))
+    return repr(items)
+
+fingerprint_comment = re.compile(r'/\* Cython fingerprint: ([0-9a-f]+) \*/')
+
+def recorded_fingerprint(c_file):
+    """
+    Return the fingerprint of the inputs that a generated C file was
+    created from, or None if it is unknown.
+    """
+    try:
+        f = open(c_file)
+        try:
+            for line in (f.readline(), f.readline()):
+                match = fingerprint_comment.match(line)
+                if match:
+                    return match.group(1)
+        finally:
+            f.close()
+    except IOError:
+        pass
+    return None
+
 def parse_list(s):
     """
     >>> parse_list("a b c")
@@ -295,8 +340,7 @@ def normalize_existing0(base_dir, rel_paths):
             filtered.append(os.path.normpath(path))
     return filtered
 
-@cached_function
-def parse_dependencies(source_filename):
+def scan_dependencies(source_filename):
     # Actual parsing is way to slow, so we use regular expressions.
     # The only catch is that we must strip comments and string
     # literals ahead of time.
@@ -325,16 +369,155 @@ def parse_dependencies(source_filename):
             includes.append(literals[include])
     return cimports, includes, externs, distutils_info
 
+parse_dependencies = cached_function(scan_dependencies)
+
+def scan_dependencies_entry(filename):
+    # runs in the worker processes of cythonize()
+    try:
+        s = os.stat(filename)
+        return filename, (s.st_size, s.st_mtime, file_hash(filename),
+                          scan_dependencies(filename))
+    except EnvironmentError:
+        return filename, None  # reported when the file is used
+
+def default_dependency_index():
+    return os.path.join(Utils.get_cython_cache_dir(), 'dependencies')
+
+
+class DependencyIndex(object):
+    """
+    The results of parse_dependencies() for source files, stored in a file
+    so that later builds (cythonize() and pyximport) only scan the files
+    that changed.  An entry is reused while the size and modification time
+    of its file are unchanged, or otherwise while its content hash is.
+    """
+
+    def __init__(self, path=None):
+        self.path = path
+        self.entries = {}
+        self.new_entries = {}
+        if path is not None:
+            self.entries.update(self.load())
+
+    def load(self):
+        try:
+            f = open(self.path, 'rb')
+            try:
+                version, entries = pickle.load(f)
+            finally:
+                f.close()
+        except Exception:
+            return {}  # missing, unreadable or written by an older version
+        if version != __version__:
+            return {}
+        return entries
+
+    def save(self):
+        """
+        Merge the new entries into the index file, keeping those that
+        concurrent builds added since it was loaded.
+        """
+        if self.path is None or not self.new_entries:
+            return
+        entries = self.load()
+        entries.update(self.new_entries)
+        for filename in list(entries):
+            if not os.path.exists(filename):
+                del entries[filename]
+        directory = os.path.dirname(self.path)
+        try:
+            if directory and not os.path.isdir(directory):
+                os.makedirs(directory)
+            Utils.write_file_atomically(
+                self.path, lambda f: pickle.dump((__version__, entries), f, 2))
+        except EnvironmentError:
+            # the next build scans the files again
+            return
+        self.entries = entries
+        self.new_entries = {}
+
+    def key(self, filename):
+        return os.path.abspath(filename)
+
+    def lookup(self, filename):
+        """
+        Return the dependencies of the file if they are known, else None.
+        """
+        key = self.key(filename)
+        entry = self.entries.get(key)
+        if entry is None:
+            return None
+        size, mtime, hash, dependencies = entry
+        s = os.stat(filename)
+        if (size, mtime) == (s.st_size, s.st_mtime):
+            return dependencies
+        if size == s.st_size and hash == file_hash(filename):
+            # touched but unchanged, e.g. by a checkout
+            self.add(filename, (size, s.st_mtime, hash, dependencies))
+            return dependencies
+        return None
+
+    def add(self, filename, entry):
+        key = self.key(filename)
+        self.entries[key] = self.new_entries[key] = entry
+
+    def parse_dependencies(self, filename):
+        dependencies = self.lookup(filename)
+        if dependencies is None:
+            filename, entry = scan_dependencies_entry(filename)
+            if entry is None:
+                # raise the error of the file
+                return scan_dependencies(filename)
+            self.add(filename, entry)
+            dependencies = entry[3]
+        return dependencies
+
+    def missing(self, filenames):
+        missing = []
+        for filename in filenames:
+            try:
+                if self.lookup(filename) is None:
+                    missing.append(filename)
+            except EnvironmentError:
+                pass
+        return missing
+
 
 class DependencyTree(object):
 
-    def __init__(self, context, quiet=False):
+    def __init__(self, context, quiet=False, index=None):
         self.context = context
         self.quiet = quiet
+        self.index = index
         self._transitive_cache = {}
 
+    @cached_method
     def parse_dependencies(self, source_filename):
-        return parse_dependencies(source_filename)
+        if self.index is None:
+            return parse_dependencies(source_filename)
+        return self.index.parse_dependencies(source_filename)
+
+    def scan(self, filenames, map=map):
+        """
+        Scan the given files and everything they depend on for their
+        dependencies, one level of the dependency graph at a time, so
+        that 'map' (e.g. of a process pool) can scan the files of a level
+        that are not in the index in parallel.
+        """
+        seen = set()
+        while filenames:
+            seen.update(filenames)
+            for filename, entry in map(scan_dependencies_entry,
+                                       self.index.missing(filenames)):
+                if entry is not None:
+                    self.index.add(filename, entry)
+            next = set()
+            for filename in filenames:
+                try:
+                    next.update(self.immediate_dependencies(filename))
+                except EnvironmentError:
+                    pass
+            filenames = [filename for filename in next if filename not in seen]
 
     @cached_method
     def included_files(self, filename):
@@ -445,15 +628,15 @@ class DependencyTree(object):
 
     def transitive_fingerprint(self, filename, extra=None):
         try:
-            m = hashlib.md5(__version__)
-            m.update(file_hash(filename))
+            m = hashlib.md5(__version__.encode('ASCII'))
+            m.update(file_hash(filename).encode('ASCII'))
             for x in sorted(self.all_dependencies(filename)):
                 if os.path.splitext(x)[1] not in ('.c', '.cpp', '.h'):
-                    m.update(file_hash(x))
+                    m.update(file_hash(x).encode('ASCII'))
             if extra is not None:
-                m.update(str(extra))
+                m.update(str(extra).encode('UTF-8'))
             return m.hexdigest()
-        except IOError:
+        except EnvironmentError:
             return None
 
     def distutils_info0(self, filename):
@@ -505,14 +688,37 @@ class DependencyTree(object):
             del stack[node]
 
 _dep_tree = None
-def create_dependency_tree(ctx=None, quiet=False):
+def create_dependency_tree(ctx=None, quiet=False, index=None):
     global _dep_tree
     if _dep_tree is None:
         if ctx is None:
             ctx = Context(["."], CompilationOptions(default_options))
-        _dep_tree = DependencyTree(ctx, quiet=quiet)
+        _dep_tree = DependencyTree(ctx, quiet=quiet, index=index)
+    elif _dep_tree.index is None:
+        _dep_tree.index = index
     return _dep_tree
 
+def pattern_files(patterns, exclude=[]):
+    # the Cython source files matched by the arguments of cythonize()
+    to_exclude = set()
+    if not isinstance(exclude, list):
+        exclude = [exclude]
+    for pattern in exclude:
+        to_exclude.update(extended_iglob(pattern))
+    if not isinstance(patterns, list):
+        patterns = [patterns]
+    files = []
+    for pattern in patterns:
+        if isinstance(pattern, Extension):
+            pattern = pattern.sources[0]
+            if os.path.splitext(pattern)[1] not in ('.py', '.pyx'):
+                continue
+        if isinstance(pattern, str):
+            for file in extended_iglob(pattern):
+                if file not in to_exclude:
+                    files.append(file)
+    return files
+
 # This may be useful for advanced users?
 def create_extension_list(patterns, exclude=[], ctx=None, aliases=None, quiet=False, exclude_failures=False):
     explicit_modules = set([m.name for m in patterns if isinstance(m, Extension)])
@@ -606,13 +812,61 @@ def cythonize(module_list, exclude=[], nthreads=0, aliases=None, quiet=False, fo
     that this only really makes sense for compiling .py files which can also
     be used without compilation.
 
+    Modules are recompiled when the content of their sources or their options
+    changed.  Passing a directory as 'cache' (or True for a default location)
+    stores the generated C files there for reuse, as well as the extension
+    modules if they are built with Cython.Distutils.build_ext.
+
+    To reuse parsed .pxd files across runs, pass a cache directory as
+    'pxd_cache'.  It defaults to the 'cache' directory of the generated C
+    files, if one is used, so that both share its size limit.
+
+    Without 'nthreads', 'use_server=True' sends the modules to a running
+    compiler server ("cython --server") if there is one.  The server is
+    also used if the CYTHON_SERVER_SOCKET environment variable is set.
+
+    With 'split_c=N', the C code of each module is split into N files,
+    which are added to the sources of its extension.
+
+    With 'timings=True', the time spent in each compiler stage is reported
+    per module and in total on stderr, 'timings' can also be the name of a
+    file to write the report to as JSON.
+
+    The dependencies found in the sources are stored in an index file in
+    the Cython cache directory and only rescanned for changed files.  Pass
+    another path as 'dependency_cache' to use that file, or False to not
+    keep an index.  With 'nthreads', the files are scanned in parallel.
+
     Additional compilation options can be passed as keyword arguments.
     """
+    dependency_cache = options.pop('dependency_cache', True)
+    use_server = options.pop('use_server', False)
+    if dependency_cache is True:
+        dependency_cache = default_dependency_index()
     if 'include_path' not in options:
         options['include_path'] = ['.']
+    if options.get('cache') is True:
+        options['cache'] = os.path.join(Utils.get_cython_cache_dir(), 'build')
+    if 'cache' in options and 'pxd_cache' not in options:
+        options['pxd_cache'] = options['cache']
     c_options = CompilationOptions(**options)
     cpp_options = CompilationOptions(**options); cpp_options.cplus = True
     ctx = c_options.create_context()
+    index = None
+    if dependency_cache:
+        index = DependencyIndex(dependency_cache)
+    deps = create_dependency_tree(ctx, quiet=quiet, index=index)
+    pool = None
+    if nthreads:
+        # Requires multiprocessing (or Python >= 2.6)
+        try:
+            import multiprocessing
+            pool = multiprocessing.Pool(nthreads)
+        except ImportError:
+            print("multiprocessing required for parallel cythonization")
+            nthreads = 0
+    if pool is not None and deps.index is not None:
+        deps.scan(pattern_files(module_list, exclude), pool.map)
     module_list = create_extension_list(
         module_list,
         exclude=exclude,
@@ -620,7 +874,10 @@ def cythonize(module_list, exclude=[], nthreads=0, aliases=None, quiet=False, fo
         quiet=quiet,
         exclude_failures=exclude_failures,
         aliases=aliases)
-    deps = create_dependency_tree(ctx, quiet=quiet)
+    options_fingerprints = {
+        'c': options_fingerprint(c_options),
+        'c++': options_fingerprint(cpp_options),
+        }
     modules_by_cfile = {}
     to_compile = []
     for m in module_list:
@@ -631,14 +888,16 @@ def cythonize(module_list, exclude=[], nthreads=0, aliases=None, quiet=False, fo
                 if m.language == 'c++':
                     c_file = base + '.cpp'
                     options = cpp_options
+                    fingerprint = deps.transitive_fingerprint(source, options_fingerprints['c++'])
                 else:
                     c_file = base + '.c'
                     options = c_options
+                    fingerprint = deps.transitive_fingerprint(source, options_fingerprints['c'])
                 if os.path.exists(c_file):
                     c_timestamp = os.path.getmtime(c_file)
                 else:
                     c_timestamp = -1
-                    
+
                 # Priority goes first to modified files, second to direct
                 # dependents, and finally to indirect dependents.
                 if c_timestamp < deps.timestamp(source):
@@ -647,19 +906,24 @@ def cythonize(module_list, exclude=[], nthreads=0, aliases=None, quiet=False, fo
                 else:
                     dep_timestamp, dep = deps.newest_dependency(source)
                     priority = 2 - (dep in deps.immediate_dependencies(source))
-                if force or c_timestamp < dep_timestamp:
+                # Timestamps change on checkouts without changing the
+                # content, so they are only used if the content hash of
+                # the inputs of the existing C file is unknown.
+                c_fingerprint = c_timestamp >= 0 and recorded_fingerprint(c_file) or None
+                if c_fingerprint is not None and fingerprint is not None:
+                    outdated = c_fingerprint != fingerprint
+                else:
+                    outdated = c_timestamp < dep_timestamp
+                if force or outdated:
                     if not quiet:
-                        if source == dep:
+                        if c_timestamp >= dep_timestamp:
+                            print("Compiling %s because its dependencies or options changed." % source)
+                        elif source == dep:
                             print("Compiling %s because it changed." % source)
                         else:
                             print("Compiling %s because it depends on %s." % (source, dep))
-                    if not force and hasattr(options, 'cache'):
-                        extra = m.language
-                        fingerprint = deps.transitive_fingerprint(source, extra)
-                    else:
-                        fingerprint = None
                     to_compile.append((priority, source, c_file, fingerprint, quiet,
-                                       options, not exclude_failures))
+                                       options, not exclude_failures, not force))
                 new_sources.append(c_file)
                 if c_file not in modules_by_cfile:
                     modules_by_cfile[c_file] = [m]
@@ -668,22 +932,20 @@ def cythonize(module_list, exclude=[], nthreads=0, aliases=None, quiet=False, fo
             else:
                 new_sources.append(source)
         m.sources = new_sources
-    if hasattr(options, 'cache'):
-        if not os.path.exists(options.cache):
-            os.mkdir(options.cache)
+        if hasattr(c_options, 'cache'):
+            # used by Cython.Distutils.build_ext for the extension module
+            m.cython_cache = c_options.cache
+    if deps.index is not None:
+        deps.index.save()
     to_compile.sort()
+    timings = []
     if nthreads:
-        # Requires multiprocessing (or Python >= 2.6)
-        try:
-            import multiprocessing
-            pool = multiprocessing.Pool(nthreads)
-            pool.map(cythonize_one_helper, to_compile)
-        except ImportError:
-            print("multiprocessing required for parallel cythonization")
-            nthreads = 0
-    if not nthreads:
+        timings = pool.map(cythonize_one_helper, to_compile)
+    else:
         for args in to_compile:
-            cythonize_one(*args[1:])
+            timings.append(cythonize_one(use_server=use_server, *args[1:]))
+    if c_options.timings:
+        Timings.report(timings, c_options.timings)
     if exclude_failures:
         failed_modules = set()
         for c_file, modules in modules_by_cfile.iteritems():
@@ -691,54 +953,59 @@ def cythonize(module_list, exclude=[], nthreads=0, aliases=None, quiet=False, fo
                 failed_modules.update(modules)
         for module in failed_modules:
             module_list.remove(module)
-    if hasattr(options, 'cache'):
-        cleanup_cache(options.cache, getattr(options, 'cache_size', 1024 * 1024 * 100))
+    for m in module_list:
+        # add the files that the generated code was split into
+        sources = []
+        for source in m.sources:
+            sources.append(source)
+            if source in modules_by_cfile:
+                sources.extend(part_files(source))
+        m.sources = sources
+    if hasattr(c_options, 'cache'):
+        cleanup_cache(c_options.cache, getattr(c_options, 'cache_size', default_cache_size))
     # cythonize() is often followed by the (non-Python-buffered)
     # compiler output, flush now to avoid interleaving output.
     sys.stdout.flush()
     return module_list
 
 # TODO: Share context? Issue: pyx processing leaks into pxd module
-def cythonize_one(pyx_file, c_file, fingerprint, quiet, options=None, raise_on_failure=True):
+def cythonize_one(pyx_file, c_file, fingerprint, quiet, options=None, raise_on_failure=True,
+                  use_cache=True, use_server=False):
     from Cython.Compiler.Main import compile, default_options
+    from Cython.Compiler.Server import compile_on_server, client_socket_path
     from Cython.Compiler.Errors import CompileError, PyrexError
 
-    if fingerprint:
-        if not os.path.exists(options.cache):
-            try:
-                os.mkdir(options.cache)
-            except:
-                if not os.path.exists(options.cache):
-                    raise
-        # Cython-generated c files are highly compressible.
-        # (E.g. a compression ratio of about 10 for Sage).
-        fingerprint_file = join_path(
-            options.cache, "%s-%s%s" % (os.path.basename(c_file), fingerprint, gzip_ext))
-        if os.path.exists(fingerprint_file):
-            if not quiet:
-                print("Found compiled %s in cache" % pyx_file)
-            os.utime(fingerprint_file, None)
-            g = gzip_open(fingerprint_file, 'rb')
-            try:
-                f = open(c_file, 'wb')
-                try:
-                    shutil.copyfileobj(g, f)
-                finally:
-                    f.close()
-            finally:
-                g.close()
-            return
-    if not quiet:
-        print("Cythonizing %s" % pyx_file)
     if options is None:
         options = CompilationOptions(default_options)
+    cache = None
+    if fingerprint and hasattr(options, 'cache'):
+        cache = ArtifactCache(options.cache)
+        if use_cache and cache.load(fingerprint, c_file):
+            for part_file in part_files(c_file):
+                if not cache.load(fingerprint, part_file):
+                    break
+            else:
+                if not quiet:
+                    print("Found compiled %s in cache" % pyx_file)
+                return
+    if not quiet:
+        print("Cythonizing %s" % pyx_file)
     options.output_file = c_file
+    options.fingerprint = fingerprint
 
     any_failures = 0
+    timings = None
     try:
-        result = compile([pyx_file], options)
+        result = None
+        socket_path = client_socket_path(use_server)
+        if socket_path:
+            result = compile_on_server([pyx_file], options, socket_path=socket_path)
+        if result is None:
+            result = compile([pyx_file], options)
         if result.num_errors > 0:
             any_failures = 1
+        for module_result in result.values():
+            timings = getattr(module_result, "timings", None)
     except (EnvironmentError, PyrexError), e:
         sys.stderr.write('%s\n' % e)
         any_failures = 1
@@ -753,40 +1020,16 @@ def cythonize_one(pyx_file, c_file, fingerprint, quiet, options=None, raise_on_f
             raise CompileError(None, pyx_file)
         elif os.path.exists(c_file):
             os.remove(c_file)
-    elif fingerprint:
-        f = open(c_file, 'rb')
+    elif cache is not None:
         try:
-            g = gzip_open(fingerprint_file, 'wb')
-            try:
-                shutil.copyfileobj(f, g)
-            finally:
-                g.close()
-        finally:
-            f.close()
+            for path in [c_file] + part_files(c_file):
+                cache.store(fingerprint, path)
+        except EnvironmentError:
+            pass  # e.g. cache on a full disk, not worth failing the build
+    return timings
 
 def cythonize_one_helper(m):
     return cythonize_one(*m[1:])
 
 def cleanup_cache(cache, target_size, ratio=.85):
-    try:
-        p = subprocess.Popen(['du', '-s', '-k', os.path.abspath(cache)], stdout=subprocess.PIPE)
-        res = p.wait()
-        if res == 0:
-            total_size = 1024 * int(p.stdout.read().strip().split()[0])
-            if total_size < target_size:
-                return
-    except (OSError, ValueError):
-        pass
-    total_size = 0
-    all = []
-    for file in os.listdir(cache):
-        path = join_path(cache, file)
-        s = os.stat(path)
-        total_size += s.st_size
-        all.append((s.st_atime, s.st_size, path))
-    if total_size > target_size:
-        for time, size, file in reversed(sorted(all)):
-            os.unlink(file)
-            total_size -= size
-            if total_size < target_size * ratio:
-                break
+    ArtifactCache(cache).cleanup(target_size, ratio)
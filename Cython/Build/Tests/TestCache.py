@@ -0,0 +1,161 @@
+import os
+import time
+import unittest
+from distutils.dist import Distribution
+from distutils.extension import Extension
+
+from Cython.Build import cythonize
+from Cython.Build.Cache import ArtifactCache
+from Cython.Build.Dependencies import recorded_fingerprint
+from Cython.Compiler.CodeSplitting import part_files_comment
+from Cython.Distutils.build_ext import build_ext, cpu_count
+from Cython.TestUtils import FileTestCase
+from Cython.Utils import write_file_atomically
+
+
+class TestArtifactCache(FileTestCase):
+
+    directory_prefix = 'cython_cache_'
+
+    def setUp(self):
+        FileTestCase.setUp(self)
+        self.cache = ArtifactCache(self.path('cache'))
+
+    def test_store_and_load(self):
+        for name in ('module.c', 'module.so'):
+            content = ('content of %s' % name).encode('ASCII')
+            self.write(name, content, 'wb')
+            self.assert_(not self.cache.load('1234', self.path(name)))
+            self.cache.store('1234', self.path(name))
+            os.remove(self.path(name))
+            self.assert_(self.cache.load('1234', self.path(name)))
+            self.assertEqual(content, self.read(name, 'rb'))
+            self.assert_(not self.cache.load('5678', self.path(name)))
+
+    def test_failed_write(self):
+        def write(f):
+            f.write('partial'.encode('ASCII'))
+            raise IOError("disk full")
+        self.assertRaises(IOError, write_file_atomically, self.path('module.c'), write)
+        self.assertEqual([], os.listdir(self.directory))
+
+    def test_cleanup(self):
+        self.write('module.so', 'x'.encode('ASCII') * 1000, 'wb')
+        for key in ('1', '2', '3', '4'):
+            self.cache.store(key, self.path('module.so'))
+        # make '1' the most recently used entry
+        now = time.time()
+        for age, key in [(30, '2'), (20, '3'), (10, '4')]:
+            path = self.cache.entry_path('module.so', key)
+            os.utime(path, (now - age, now - age))
+        self.cache.cleanup(target_size=2500)
+        self.assertEqual(
+            sorted([os.path.basename(self.cache.entry_path('module.so', key))
+                    for key in ('1', '4')]),
+            sorted(os.listdir(self.cache.directory)))
+
+
+class TestExtensionFingerprint(FileTestCase):
+
+    directory_prefix = 'cython_fingerprint_'
+
+    def setUp(self):
+        FileTestCase.setUp(self)
+        self.command = build_ext(Distribution())
+        self.command.finalize_options()
+
+    def fingerprint(self, code):
+        self.write('module.c', code)
+        return self.command.extension_fingerprint(
+            Extension('module', [self.path('module.c')]))
+
+    def test_generated_header(self):
+        fingerprint = self.fingerprint('/* Generated by Cython 0.19 on Mon */\nint x;\n')
+        self.assert_(fingerprint)
+        # the time of the compilation is ignored, the code is not
+        self.assertEqual(fingerprint,
+                         self.fingerprint('/* Generated by Cython 0.19 on Tue */\nint x;\n'))
+        self.assertNotEqual(fingerprint,
+                            self.fingerprint('/* Generated by Cython 0.19 on Tue */\nint y;\n'))
+
+
+class TestCompileJobs(FileTestCase):
+
+    directory_prefix = 'cython_c_jobs_'
+
+    def setUp(self):
+        FileTestCase.setUp(self)
+        self.command = build_ext(Distribution())
+        self.command.finalize_options()
+        self.write('module.c', '/* Generated by Cython */\nint x;\n')
+        self.write('split.c', '/* Generated by Cython */\n%s\nint x;\n'
+                   % part_files_comment(['split.part1.c']))
+        self.write('split.part1.c', 'int y;\n')
+
+    def c_jobs(self, *names):
+        return self.command.c_jobs(
+            Extension('module', [self.path(name) for name in names]))
+
+    def test_default(self):
+        # the files of an extension are only compiled in parallel if it is split
+        self.assertEqual(1, self.c_jobs('module.c', 'split.part1.c'))
+        self.assertEqual(cpu_count(), self.c_jobs('split.c', 'split.part1.c'))
+
+    def test_option(self):
+        self.command.cython_c_jobs = 3
+        self.assertEqual(3, self.c_jobs('module.c'))
+        self.command.cython_c_jobs = 1
+        self.assertEqual(1, self.c_jobs('split.c', 'split.part1.c'))
+
+
+class TestContentHashRebuild(FileTestCase):
+
+    directory_prefix = 'cython_rebuild_'
+
+    def setUp(self):
+        FileTestCase.setUp(self)
+        self.cwd = os.getcwd()
+        os.chdir(self.directory)
+        self.write('rebuild.pyx', 'include "rebuild.pxi"\ndef f():\n    return X\n')
+        self.write('rebuild.pxi', 'DEF X = 1\n')
+
+    def tearDown(self):
+        os.chdir(self.cwd)
+        FileTestCase.tearDown(self)
+
+    def cythonize(self, **options):
+        cythonize(['rebuild.pyx'], quiet=True, **options)
+        return recorded_fingerprint('rebuild.c'), os.path.getmtime('rebuild.c')
+
+    def touch_sources(self):
+        future = time.time() + 100
+        for name in ('rebuild.pyx', 'rebuild.pxi'):
+            os.utime(name, (future, future))
+
+    def test_touched_sources(self):
+        fingerprint, mtime = self.cythonize()
+        self.assert_(fingerprint)
+        self.touch_sources()
+        self.assertEqual((fingerprint, mtime), self.cythonize())
+
+    def test_changed_include(self):
+        fingerprint, _ = self.cythonize()
+        self.write('rebuild.pxi', 'DEF X = 2\n')
+        self.touch_sources()
+        self.assertNotEqual(fingerprint, self.cythonize()[0])
+
+    def test_changed_options(self):
+        fingerprint, _ = self.cythonize()
+        self.assertNotEqual(fingerprint, self.cythonize(compiler_directives={'boundscheck': False})[0])
+
+    def test_cache(self):
+        cache = self.path('cache')
+        fingerprint, _ = self.cythonize(cache=cache)
+        code = self.read('rebuild.c')
+        os.remove('rebuild.c')
+        self.assertEqual(fingerprint, self.cythonize(cache=cache)[0])
+        self.assertEqual(code, self.read('rebuild.c'))
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,60 @@
+import os
+import time
+import unittest
+
+from Cython.Build.Dependencies import DependencyIndex, DependencyTree
+from Cython.Compiler.Main import Context, CompilationOptions, default_options
+from Cython.TestUtils import FileTestCase
+
+
+class TestDependencyIndex(FileTestCase):
+
+    directory_prefix = 'cython_dependencies_'
+
+    def setUp(self):
+        FileTestCase.setUp(self)
+        self.index_file = self.path('index')
+        self.write('a.pyx', 'cimport b\ninclude "c.pxi"\n')
+        self.write('b.pxd', 'cdef int x\n')
+        self.write('c.pxi', 'from d cimport y\n')
+
+    def test_reuse(self):
+        index = DependencyIndex(self.index_file)
+        cimports, includes = index.parse_dependencies(self.path('a.pyx'))[:2]
+        self.assertEqual((['b'], ['c.pxi']), (cimports, includes))
+        index.save()
+        index = DependencyIndex(self.index_file)
+        self.assertEqual((['b'], ['c.pxi']), index.lookup(self.path('a.pyx'))[:2])
+        # touching the file keeps the entry
+        future = time.time() + 100
+        os.utime(self.path('a.pyx'), (future, future))
+        self.assertEqual((['b'], ['c.pxi']), index.lookup(self.path('a.pyx'))[:2])
+        self.write('a.pyx', 'cimport e\n')
+        self.assertEqual(None, index.lookup(self.path('a.pyx')))
+        self.assertEqual(['e'], index.parse_dependencies(self.path('a.pyx'))[0])
+
+    def test_missing_files_are_dropped(self):
+        index = DependencyIndex(self.index_file)
+        index.parse_dependencies(self.path('b.pxd'))
+        index.parse_dependencies(self.path('c.pxi'))
+        os.remove(self.path('b.pxd'))
+        index.save()
+        self.assertEqual([os.path.abspath(self.path('c.pxi'))],
+                         list(DependencyIndex(self.index_file).entries))
+
+    def test_scan(self):
+        context = Context([self.directory], CompilationOptions(default_options))
+        tree = DependencyTree(context, quiet=True, index=DependencyIndex())
+        scanned = []
+        def scan_map(function, filenames):
+            scanned.append(sorted([os.path.basename(f) for f in filenames]))
+            return map(function, filenames)
+        tree.scan([self.path('a.pyx')], scan_map)
+        self.assertEqual([['a.pyx'], ['b.pxd']], scanned)
+        self.assertEqual(
+            sorted([self.path(name) for name in ('a.pyx', 'b.pxd', 'c.pxi')]),
+            sorted(tree.index.entries))
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -63,6 +63,10 @@ class AnnotationCCodeWriter(CCodeWriter):
                 line = line.replace(c, cc)
             lines[k] = line
         f.close()
+        notes = {}
+        for pos, item in self.annotations:
+            if item.style == 'infer_nogil' and pos[0].filename == source_filename:
+                notes.setdefault(pos[1], []).append(item.text)
         all = []
         if False:
             for pos, item in self.annotations:
@@ -116,6 +120,8 @@ body { font-family: courier; font-size: 12; }
 
 .line { margin: 0em }
 
+.infer_nogil { color: #0000FF; font-style: italic; }
+
 </style>
 <script>
 function toggleDiv(id) {
@@ -167,6 +173,9 @@ function toggleDiv(id) {
             for c, cc, html in special_chars:
                 line = line.replace(cc, html)
             f.write(line.rstrip())
+            for text in notes.get(k, ()):
+                text = text.replace(u'&', u'&amp;').replace(u'<', u'&lt;').replace(u'>', u'&gt;')
+                f.write(u"  <span class='infer_nogil'># %s</span>" % text)
 
             f.write(u'</pre>\n')
             code = re.sub(line_pos_comment, '', code) # inline annotations are redundant
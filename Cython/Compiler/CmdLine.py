@@ -41,6 +41,13 @@ Options:
   --warning-errors, -Werror      Make all warnings into errors
   --warning-extra, -Wextra       Enable extra warnings
   -X, --directive <name>=<value>[,<name=value,...] Overrides a compiler directive
+  --pxd-cache <directory>        Cache parsed .pxd files in the given directory
+  --server                       Run a compiler server for cythonize and pyximport
+  --split-c <N>                  Split the generated C code into N files
+  --shared-runtime               Share Cython's function and generator types between modules
+  --timings[=<file>]             Report the time spent in each compiler stage, as JSON
+                                 in the given file or as text on stderr
+  --function-jobs <N>            Generate the code of the module level functions in N processes
 """
 
 # The following is broken http://trac.cython.org/cython_trac/ticket/379
@@ -137,6 +144,20 @@ def parse_command_line(args):
                 Options.warning_errors = True
             elif option in ('-Wextra', '--warning-extra'):
                 options.compiler_directives.update(Options.extra_warnings)
+            elif option == "--pxd-cache":
+                options.pxd_cache = pop_arg()
+            elif option == "--server":
+                options.server = True
+            elif option == "--split-c":
+                options.split_c = int(pop_arg())
+            elif option == "--function-jobs":
+                options.function_jobs = int(pop_arg())
+            elif option == "--shared-runtime":
+                options.shared_runtime = True
+            elif option == "--timings":
+                options.timings = True
+            elif option.startswith("--timings="):
+                options.timings = option[len("--timings="):]
             elif option == "--old-style-globals":
                 Options.old_style_globals = True
             elif option == "--directive" or option.startswith('-X'):
@@ -171,7 +192,7 @@ def parse_command_line(args):
         sys.stderr.write(
             "cython: Only one source file allowed when using -o\n")
         sys.exit(1)
-    if len(sources) == 0 and not options.show_version:
+    if len(sources) == 0 and not (options.show_version or options.server):
         bad_usage()
     if Options.embed and len(sources) > 1:
         sys.stderr.write(
@@ -23,6 +23,7 @@ from Cython import Utils
 from Scanning import SourceDescriptor
 from Cython.StringIOTree import StringIOTree
 import DebugFlags
+import UtilityBundle
 
 try:
     from __builtin__ import basestring
@@ -137,6 +138,11 @@ class UtilityCodeBase(object):
         if utilities:
             return utilities
 
+        utilities = UtilityBundle.get_utilities(path)
+        if utilities:
+            cls._utility_cache[path] = utilities
+            return utilities
+
         filename = os.path.join(get_utility_dir(), path)
         _, ext = os.path.splitext(path)
         if ext in ('.pyx', '.py', '.pxd', '.pxi'):
@@ -236,6 +242,8 @@ class UtilityCodeBase(object):
 
         if tags:
             orig_kwargs = kwargs.copy()
+            # an init section only belongs to the requested utility code
+            orig_kwargs.pop('init', None)
             for name, values in tags.items():
                 if name in kwargs:
                     continue
@@ -422,8 +430,15 @@ def sub_tempita(s, context, file=None, name=None):
     elif name:
         context['__name'] = name
 
-    from Cython.Tempita import sub
-    return sub(s, **context)
+    # only specialise a template again for a different context
+    key = UtilityBundle.tempita_key(s, context)
+    result = UtilityBundle.tempita_cache.get(key)
+    if result is None:
+        from Cython.Tempita import sub
+        result = sub(s, **context)
+        if key is not None:
+            UtilityBundle.tempita_cache[key] = result
+    return result
 
 class TempitaUtilityCode(UtilityCode):
     def __init__(self, name=None, proto=None, impl=None, init=None, file=None, context=None, **kwargs):
@@ -1231,7 +1246,7 @@ class GlobalState(object):
             elif Utils.long_literal(value):
                 function = '%s = PyInt_FromString((char *)"%s", 0, 0); %s;'
             else:
-                function = "%s = PyInt_FromLong(%s); %s;"
+                function = "%s = __Pyx_PyInt_FromLong(%s); %s;"
             init_globals = self.parts['init_globals']
             init_globals.putln(function % (
                 cname,
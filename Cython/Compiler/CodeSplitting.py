@@ -0,0 +1,395 @@
+#
+#   Splitting the generated C code of a module into several files
+#
+#   The code of a module is normally one translation unit in which
+#   nearly everything is declared 'static'.  To compile it in parallel,
+#   the function definitions of the module body can be moved into
+#   additional files that repeat the declarations of the main file.
+#
+#   Every top level item that is needed by another file is then given
+#   hidden external linkage instead: variables are defined in the file
+#   that defined them before and declared 'extern' in the others, and
+#   functions are defined once and declared in all files.  Functions
+#   that are defined in the repeated declarations stay static, each
+#   file gets its own copy.
+#
+
+import os
+import re
+
+identifier = re.compile(r'[A-Za-z_][A-Za-z0-9_]*')
+static_prefix = re.compile(r'static\s+((CYTHON_INLINE|inline|__inline__)\s+)?')
+trailing_brackets = re.compile(r'(\s*\[[^\]]*\])+\s*$')
+
+hidden_macro = '__PYX_SPLIT_HIDDEN'
+
+hidden_macro_definition = '''
+#ifndef %(macro)s
+  #if defined(__GNUC__) && !(defined(_WIN32) || defined(__CYGWIN__))
+    #define %(macro)s __attribute__((visibility("hidden")))
+  #else
+    #define %(macro)s
+  #endif
+#endif
+''' % {'macro': hidden_macro}
+
+
+class Item(object):
+    # A top level item of C code.
+    #
+    # kind         'trivia', 'decl' or 'func'
+    # text         string   the exact source text
+    # name         string   declared name of a 'static' item, or None
+    # is_function  boolean
+    # declarator   string   declaration without 'static' and initializer
+    # body         string   function body or initializer, or ''
+    # external     string   declaration of an initialised non-static variable
+
+    name = None
+    is_function = False
+    declarator = None
+    body = ''
+    external = None
+
+    def __init__(self, kind, text):
+        self.kind = kind
+        self.text = text
+        if kind != 'trivia' and text.startswith('static'):
+            self.analyse()
+        elif kind == 'decl' and '#' not in text and not re.match(r'(typedef|extern)\b', text):
+            head, body = split_at_top_level(text, '=')
+            if body:
+                self.external = 'extern %s;' % strip_comments(head).strip()
+
+    def analyse(self):
+        if self.kind == 'func':
+            head, self.body = split_at_top_level(self.text, '{')
+            self.is_function = True
+            if '#' in head:
+                return  # not worth handling
+        else:
+            head, self.body = split_at_top_level(self.text.rstrip().rstrip(';'), '=')
+            head = strip_comments(head).rstrip()
+            if split_at_top_level(head, ',')[1]:
+                return  # several declarators
+            paren = head.find('(')
+            if paren >= 0 and head.endswith(')') and not head[paren+1:].lstrip().startswith('*'):
+                self.is_function = True
+        head = strip_comments(head).strip()
+        match = static_prefix.match(head)
+        if match is None:
+            return
+        self.declarator = head[match.end():]
+        if self.is_function:
+            names = identifier.findall(self.declarator[:self.declarator.find('(')])
+        else:
+            names = identifier.findall(trailing_brackets.sub('', self.declarator))
+        if names:
+            self.name = names[-1]
+
+    def hidden(self, extern=False):
+        # this item with hidden external linkage
+        if self.is_function:
+            if self.kind == 'func':
+                return '%s %s %s' % (hidden_macro, self.declarator, self.body)
+            return '%s %s;' % (hidden_macro, self.declarator)
+        elif extern:
+            return 'extern %s %s;' % (hidden_macro, self.declarator)
+        else:
+            return '%s %s' % (hidden_macro, static_prefix.sub('', self.text.lstrip(), 1))
+
+    def declaration(self):
+        # declaration for other files
+        if self.is_function:
+            return '%s %s;' % (hidden_macro, self.declarator)
+        return 'extern %s %s;' % (hidden_macro, self.declarator)
+
+    def used_names(self):
+        # names that are used by the definition (not just declared)
+        if self.kind == 'func' or self.body:
+            return set(identifier.findall(strip_comments(self.body)))
+        return set()
+
+
+def strip_comments(code):
+    return re.sub(r'/\*.*?\*/|//[^\n]*', ' ', code)
+
+def split_at_top_level(code, char):
+    # split at the first 'char' outside of brackets, comments and literals
+    depth = 0
+    i = 0
+    end = len(code)
+    while i < end:
+        c = code[i]
+        if c == '/' and code[i+1:i+2] == '*':
+            i = code.find('*/', i+2)
+            if i < 0:
+                break
+            i += 1
+        elif c in '"\'':
+            i = skip_literal(code, i)
+        elif c == char and depth == 0:
+            return code[:i], code[i:]
+        elif c in '([{':
+            depth += 1
+        elif c in ')]}':
+            depth -= 1
+        i += 1
+    return code, ''
+
+def skip_literal(code, i):
+    quote = code[i]
+    i += 1
+    while i < len(code) and code[i] != quote:
+        if code[i] == '\\':
+            i += 1
+        i += 1
+    return i
+
+
+def parse_items(code):
+    """
+    Split C code into a list of top level items.  Joining their text
+    gives back the code.
+    """
+    items = []
+    start = 0       # of the current item
+    depth = 0
+    func = False    # current item is a function definition
+    i = 0
+    end = len(code)
+    line_start = True
+    conditionals = []   # [depth at '#if', depth at end of first branch]
+    while i < end:
+        c = code[i]
+        if c == '\n':
+            line_start = True
+            i += 1
+            continue
+        if c in ' \t\r\f\v':
+            i += 1
+            continue
+        if line_start and c == '#':
+            # preprocessor directive, including continuation lines
+            pending = depth == 0 and is_blank(code[start:i])
+            directive = preprocessor_directive.match(code, i)
+            directive = directive and directive.group(1)
+            # follow only the first branch of conditional code, the
+            # others need not have balanced brackets on their own
+            if directive in ('if', 'ifdef', 'ifndef'):
+                conditionals.append([depth, None])
+            elif directive in ('elif', 'else') and conditionals:
+                if conditionals[-1][1] is None:
+                    conditionals[-1][1] = depth
+                depth = conditionals[-1][0]
+            elif directive == 'endif' and conditionals:
+                start_depth, first_depth = conditionals.pop()
+                if first_depth is not None:
+                    depth = first_depth
+            while True:
+                i = code.find('\n', i)
+                if i < 0:
+                    i = end
+                    break
+                if code[i-1] != '\\':
+                    break
+                i += 1
+            if pending:
+                items.append(Item('trivia', code[start:i]))
+                start = i
+            continue
+        line_start = False
+        if c == '/' and code[i+1:i+2] == '*':
+            i = code.find('*/', i+2)
+            i = i < 0 and end or i + 2
+            continue
+        if c == '/' and code[i+1:i+2] == '/':
+            i = code.find('\n', i)
+            if i < 0:
+                i = end
+            continue
+        if c in '"\'':
+            i = skip_literal(code, i) + 1
+            continue
+        if c == '{':
+            if depth == 0:
+                head = strip_preprocessor(strip_comments(code[start:i])).strip()
+                if re.match(r'extern\s+"C"$', head):
+                    # not a nested scope
+                    i += 1
+                    items.append(Item('trivia', code[start:i]))
+                    start = i
+                    continue
+                func = head.endswith(')') and not split_at_top_level(head, '=')[1]
+            depth += 1
+        elif c in '([':
+            depth += 1
+        elif c in ')]':
+            depth -= 1
+        elif c == '}':
+            if depth == 0:
+                # closing 'extern "C" {'
+                i += 1
+                items.append(Item('trivia', code[start:i]))
+                start = i
+                continue
+            depth -= 1
+            if depth == 0 and func:
+                i += 1
+                items.append(Item('func', code[start:i]))
+                start = i
+                func = False
+                continue
+        elif c == ';' and depth == 0:
+            i += 1
+            items.append(Item('decl', code[start:i]))
+            start = i
+            continue
+        i += 1
+    if start < end:
+        items.append(Item('trivia', code[start:]))
+    # separate leading whitespace and comments from the items
+    result = []
+    for item in items:
+        if item.kind != 'trivia':
+            trivia = leading_trivia.match(item.text).end()
+            if trivia:
+                result.append(Item('trivia', item.text[:trivia]))
+                item = Item(item.kind, item.text[trivia:])
+        result.append(item)
+    return result
+
+preprocessor_line = re.compile(r'(?m)^[ \t]*#(?:.*\\\n)*.*$')
+preprocessor_directive = re.compile(r'#\s*([a-z]+)')
+leading_trivia = re.compile(r'(\s+|/\*.*?\*/|//[^\n]*)*', re.S)
+
+def is_blank(code):
+    return not strip_preprocessor(strip_comments(code)).strip()
+
+def strip_preprocessor(code):
+    return re.sub(r'(?m)^[ \t]*#.*$', '', code)
+
+
+def split_code(declarations, main_code, parts_code):
+    """
+    Return the code of the main file and of the part files, given the
+    declarations at the start of every file, the remaining code of the
+    main file and the code of the parts.
+    """
+    decl_items = parse_items(declarations)
+    main_items = parse_items(main_code)
+    part_items = [parse_items(code) for code in parts_code]
+
+    # names that are defined in every file
+    private = set([item.name for item in decl_items
+                   if item.kind == 'func' and item.name])
+    # where the other names are defined: definitions with a body or
+    # initializer first, then variables of the repeated declarations
+    # (defined in the main file), then tentative definitions
+    owners = {}
+    files = [main_items] + part_items
+    for owner, items in enumerate(files):
+        for item in items:
+            if item.name and item.name not in private and (item.kind == 'func' or item.body):
+                owners.setdefault(item.name, owner)
+    for item in decl_items:
+        if item.name and not item.is_function:
+            owners.setdefault(item.name, 0)
+    for owner, items in enumerate(files):
+        for item in items:
+            if item.name and not item.is_function:
+                owners.setdefault(item.name, owner)
+
+    # names that are used by a file other than their owner
+    # (including the names that macros expand to)
+    decl_uses = set(identifier.findall(''.join(preprocessor_line.findall(declarations))))
+    for item in decl_items:
+        decl_uses.update(item.used_names())
+    shared = set([name for name in owners if name in decl_uses])
+    for owner, items in enumerate(files):
+        uses = set(decl_uses)
+        for item in items:
+            uses.update(identifier.findall(strip_comments(item.text)))
+        for name in uses:
+            if owners.get(name, owner) != owner:
+                shared.add(name)
+    for item in decl_items:
+        if item.name and not item.is_function:
+            shared.add(item.name)
+
+    # declarations of shared items that are defined after the repeated declarations
+    exported = []
+    seen = set()
+    for items in files:
+        for item in items:
+            if item.name in shared and item.name not in seen and item.declarator:
+                if item.kind == 'func' or item.body or not item.is_function:
+                    exported.append(item.declaration())
+                    seen.add(item.name)
+
+    def convert(items, owner, repeated=False):
+        code = []
+        for item in items:
+            if item.name in shared and item.declarator:
+                code.append(item.hidden(extern=owners.get(item.name) != owner))
+            elif item.is_function and item.name in owners and owners[item.name] != owner:
+                pass  # unused declaration of a static function of another file
+            elif item.external and repeated and owner:
+                code.append(item.external)
+            elif item.name in private and repeated and owner:
+                # the copies need not be used
+                code.append(item.text.replace('static', 'static CYTHON_UNUSED', 1))
+            else:
+                code.append(item.text)
+        return ''.join(code)
+
+    header_end = '\n/* Declarations shared between the files of the module */\n%s\n' % '\n'.join(exported)
+    main = convert(decl_items, 0, True) + header_end + convert(main_items, 0)
+    parts = []
+    for owner, items in enumerate(part_items):
+        parts.append(convert(decl_items, owner + 1, True) + header_end + convert(items, owner + 1))
+    return main, parts
+
+
+#
+#   The part files of a module
+#
+
+part_files_prefix = '/* Cython part files: '
+
+def part_file_names(c_file, count):
+    base, ext = os.path.splitext(c_file)
+    return ['%s.part%d%s' % (base, i, ext) for i in range(1, count + 1)]
+
+def part_files_comment(part_files):
+    return '%s%s */' % (part_files_prefix, ' '.join(
+        [os.path.basename(path) for path in part_files]))
+
+def part_files(c_file):
+    """
+    The part files of a generated C file, as recorded at its start.
+    """
+    try:
+        f = open(c_file)
+        try:
+            lines = [f.readline() for _ in range(3)]
+        finally:
+            f.close()
+    except IOError:
+        return []
+    directory = os.path.dirname(c_file)
+    for line in lines:
+        if line.startswith(part_files_prefix):
+            names = line[len(part_files_prefix):].split('*/')[0].split()
+            return [os.path.join(directory, name) for name in names]
+    return []
+
+def remove_part_files(c_file, count):
+    # left over from an earlier compilation into more parts
+    base, ext = os.path.splitext(c_file)
+    while True:
+        count += 1
+        path = '%s.part%d%s' % (base, count, ext)
+        if not os.path.exists(path):
+            break
+        os.remove(path)
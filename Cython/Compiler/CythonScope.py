@@ -1,6 +1,7 @@
 from Symtab import ModuleScope
 from PyrexTypes import *
 from UtilityCode import CythonUtilityCode
+from Code import UtilityCode
 from Errors import error
 from Scanning import StringSourceDescriptor
 import MemoryView
@@ -120,6 +121,63 @@ class CythonScope(ModuleScope):
 
         # self.entries["array"] = view_utility_scope.entries.pop("array")
 
+        #
+        # The atomic sub-scope
+        #
+        self.atomicscope = atomicscope = ModuleScope(u'atomic', self, None)
+        self.declare_module('atomic', atomicscope, None).as_module = atomicscope
+        atomicscope.is_cython_builtin = True
+        atomicscope.pxd_file_loaded = True
+        populate_atomic_scope(atomicscope)
+
+        #
+        # The ringbuffer sub-scope
+        #
+        self.ringbufferscope = ringbufferscope = ModuleScope(u'ringbuffer', self, None)
+        self.declare_module('ringbuffer', ringbufferscope, None).as_module = ringbufferscope
+        ringbufferscope.is_cython_builtin = True
+        ringbufferscope.pxd_file_loaded = True
+        ringbuffer_utility_code.declare_in_scope(ringbufferscope, cython_scope=self)
+
+
+atomic_types = (
+    ('int', c_int_type),
+    ('uint', c_uint_type),
+    ('long', c_long_type),
+    ('ulong', c_ulong_type),
+    ('llong', c_longlong_type),
+    ('ullong', c_ulonglong_type),
+    ('ssize_t', c_py_ssize_t_type),
+    ('size_t', c_size_t_type),
+    ('float', c_float_type),
+    ('double', c_double_type),
+    ('ptr', c_void_ptr_type),
+)
+
+atomic_memory_orders = (
+    ('relaxed', 0),
+    ('consume', 1),
+    ('acquire', 2),
+    ('release', 3),
+    ('acq_rel', 4),
+    ('seq_cst', 5),
+)
+
+atomic_ops = ('load', 'store', 'exchange', 'compare_exchange',
+              'fetch_add', 'fetch_sub', 'fetch_and', 'fetch_or', 'fetch_xor')
+
+def populate_atomic_scope(scope):
+    for name, base_type in atomic_types:
+        cname = '__Pyx_atomic_%s' % name
+        scope.declare_type(name, CAtomicType('atomic.%s' % name, base_type, cname),
+                           None, cname=cname)
+    # the values of the __ATOMIC_* macros of gcc and clang
+    for name, value in atomic_memory_orders:
+        scope.declare_const(name, c_int_type, None, None, cname=str(value))
+    for op in atomic_ops:
+        entry = scope.declare(op, None, CAtomicOpType(op), None, 'extern')
+        entry.is_cfunction = 1
+
 
 def create_cython_scope(context):
     # One could in fact probably make it a singleton,
@@ -153,3 +211,7 @@ cython_test_extclass_utility_code = \
                                      test_cython_utility_dep])
 
 cythonview_testscope_utility_code = load_testscope_utility("View.TestScope")
+
+ringbuffer_utility_code = CythonUtilityCode.load(
+    "RingBuffer", "RingBuffer.pyx",
+    requires=[UtilityCode.load("RingBuffer", "Parallel.c")])
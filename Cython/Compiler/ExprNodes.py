@@ -1424,6 +1424,21 @@ class NewExprNode(AtomicExprNode):
         return "new " + self.class_type.declaration_code("")
 
 
+def module_global_lookup_code(code, entry, result):
+    # Returns the C statement that looks up the module global 'entry'
+    # (or the builtin of the same name) into 'result'.  With the
+    # 'frozen_globals' directive, globals that no function declares
+    # 'global' are looked up only once after the module init function.
+    interned_cname = code.intern_identifier(entry.name)
+    if code.globalstate.directives['frozen_globals'] and not entry.is_function_global:
+        code.globalstate.use_utility_code(
+            UtilityCode.load_cached("GetFrozenModuleGlobalName", "ObjectHandling.c"))
+        return '__Pyx_GetFrozenModuleGlobalName(%s, %s);' % (result, interned_cname)
+    code.globalstate.use_utility_code(
+        UtilityCode.load_cached("GetModuleGlobalName", "ObjectHandling.c"))
+    return '__Pyx_GetModuleGlobalName(%s, %s);' % (result, interned_cname)
+
+
 class NameNode(AtomicExprNode):
     #  Reference to a local or global variable name.
     #
@@ -1754,7 +1769,7 @@ class NameNode(AtomicExprNode):
             code.globalstate.use_utility_code(
                 UtilityCode.load_cached("GetModuleGlobalName", "ObjectHandling.c"))
             code.putln(
-                '%s = __Pyx_GetModuleGlobalName(%s);' % (
+                '__Pyx_GetModuleGlobalName(%s, %s);' % (
                     self.result(),
                     interned_cname))
             if not self.cf_is_null:
@@ -1778,13 +1793,9 @@ class NameNode(AtomicExprNode):
             assert entry.type.is_pyobject, "Python global or builtin not a Python object"
             interned_cname = code.intern_identifier(self.entry.name)
             if entry.scope.is_module_scope:
-                code.globalstate.use_utility_code(
-                    UtilityCode.load_cached("GetModuleGlobalName", "ObjectHandling.c"))
-                code.putln(
-                    '%s = __Pyx_GetModuleGlobalName(%s); %s' % (
-                        self.result(),
-                        interned_cname,
-                        code.error_goto_if_null(self.result(), self.pos)))
+                code.putln('%s %s' % (
+                    module_global_lookup_code(code, entry, self.result()),
+                    code.error_goto_if_null(self.result(), self.pos)))
             else:
                 # FIXME: is_pyglobal is also used for class namespace
                 code.globalstate.use_utility_code(
@@ -2569,6 +2580,152 @@ class ParallelThreadIdNode(AtomicExprNode): #, Nodes.ParallelNode):
         return self.temp_code
 
 
+#-------------------------------------------------------------------
+#
+#  Atomic operations (cython.atomic)
+#
+#-------------------------------------------------------------------
+
+atomic_op_binops = {
+    'fetch_add': '+',
+    'fetch_sub': '-',
+    'fetch_and': '&',
+    'fetch_or': '|',
+    'fetch_xor': '^',
+}
+
+def put_atomic_ops_init(code, pos):
+    # allocates the lock of the fallback implementation
+    code.putln("if (unlikely(__Pyx_atomic_init() < 0)) %s" % code.error_goto(pos))
+
+atomic_ops_utility_code = UtilityCode.load(
+    "AtomicOps", "Atomic.c", init=put_atomic_ops_init)
+
+def atomic_op_function(env, op, value_type):
+    """
+    Returns the name of the C function that implements the atomic
+    operation 'op' on a location of type 'value_type' and makes sure
+    it gets generated.
+    """
+    if value_type.is_atomic:
+        value_type = value_type.typedef_base_type
+    name = value_type.specialization_name()
+    env.use_utility_code(atomic_ops_utility_code)
+    env.use_utility_code(TempitaUtilityCode.load(
+        "AtomicOp", "Atomic.c",
+        context={'OP': op, 'TYPE': value_type.declaration_code(''), 'NAME': name,
+                 'BINOP': atomic_op_binops.get(op, ''),
+                 'IS_FLOAT': int(bool(value_type.is_float))}))
+    return "__Pyx_atomic_%s_%s" % (op, name)
+
+def check_atomic_value_type(pos, op, value_type):
+    """
+    Reports an error if the atomic operation 'op' is not supported
+    for locations of type 'value_type'.
+    """
+    if value_type.is_atomic:
+        value_type = value_type.typedef_base_type
+    if value_type.is_error:
+        return False
+    if not (value_type.is_int or value_type.is_float or value_type.is_ptr) or (
+            value_type is PyrexTypes.c_longdouble_type):
+        error(pos, "Atomic operations are not supported for type '%s'" % value_type)
+        return False
+    if op in ('fetch_add', 'fetch_sub') and value_type.is_ptr:
+        error(pos, "Atomic %s() is not supported for pointers" % op)
+        return False
+    if op in ('fetch_and', 'fetch_or', 'fetch_xor') and not value_type.is_int:
+        error(pos, "Atomic %s() is only supported for integers" % op)
+        return False
+    return True
+
+
+class AtomicOpNode(ExprNode):
+    """
+    Implements the operations of cython.atomic, e.g.
+
+        atomic.fetch_add(&counter, 1, atomic.relaxed)
+
+    The first argument is a pointer to the location to operate on,
+    the last one an optional memory order (sequentially consistent
+    by default).
+    """
+    #  op      string      load, store, exchange, compare_exchange or fetch_<op>
+    #  args    [ExprNode]
+
+    subexprs = ['args']
+
+    def value_type(self, ptr_type):
+        value_type = ptr_type.base_type
+        if value_type.is_atomic:
+            value_type = value_type.typedef_base_type
+        return value_type
+
+    def infer_type(self, env):
+        if self.op == 'store':
+            return PyrexTypes.c_void_type
+        elif self.op == 'compare_exchange':
+            return PyrexTypes.c_bint_type
+        elif self.args:
+            ptr_type = self.args[0].infer_type(env)
+            if ptr_type.is_ptr:
+                return self.value_type(ptr_type)
+        return PyrexTypes.error_type
+
+    def analyse_types(self, env):
+        if self.op == 'load':
+            min_args = 1
+        elif self.op == 'compare_exchange':
+            min_args = 3
+        else:
+            min_args = 2
+        if not min_args <= len(self.args) <= min_args + 1:
+            error(self.pos, "atomic.%s() takes %d or %d arguments (%d given)" % (
+                self.op, min_args, min_args + 1, len(self.args)))
+            self.type = PyrexTypes.error_type
+            return self
+
+        self.args = [arg.analyse_types(env) for arg in self.args]
+        ptr = self.args[0]
+        if not ptr.type.is_ptr:
+            if not ptr.type.is_error:
+                error(ptr.pos, "atomic.%s() requires a pointer to the value, got '%s'" % (
+                    self.op, ptr.type))
+            self.type = PyrexTypes.error_type
+            return self
+        value_type = self.value_type(ptr.type)
+        if not check_atomic_value_type(ptr.pos, self.op, value_type):
+            self.type = PyrexTypes.error_type
+            return self
+
+        self.args[0] = ptr.coerce_to(PyrexTypes.c_ptr_type(value_type), env)
+        if self.op == 'compare_exchange':
+            self.args[1] = self.args[1].coerce_to(PyrexTypes.c_ptr_type(value_type), env)
+            self.args[2] = self.args[2].coerce_to(value_type, env)
+        elif self.op != 'load':
+            self.args[1] = self.args[1].coerce_to(value_type, env)
+        if len(self.args) > min_args:
+            self.args[-1] = self.args[-1].coerce_to(PyrexTypes.c_int_type, env)
+        else:
+            self.args.append(IntNode(self.pos, value='5', type=PyrexTypes.c_int_type))
+
+        if self.op == 'store':
+            self.type = PyrexTypes.c_void_type
+        elif self.op == 'compare_exchange':
+            self.type = PyrexTypes.c_bint_type
+        else:
+            self.type = value_type
+        self.function_name = atomic_op_function(env, self.op, value_type)
+        return self
+
+    def calculate_result_code(self):
+        return "%s(%s)" % (
+            self.function_name, ', '.join([arg.result() for arg in self.args]))
+
+    def generate_result_code(self, code):
+        pass
+
+
 #-------------------------------------------------------------------
 #
 #  Trailer nodes
@@ -4004,6 +4161,145 @@ class CallNode(ExprNode):
 
     gil_message = "Calling gil-requiring function"
 
+    # Python calls with explicit arguments pass them as a C array to
+    # __Pyx_PyObject_VectorCall() instead of building an argument tuple
+    # and keyword dict.  Only the function and the argument values are
+    # evaluated then, the tuple and dict nodes are skipped.
+    #
+    # Constant argument tuples are built once at module initialisation,
+    # so calls with only literal positional arguments keep passing them
+    # (empty argument lists need no tuple either way).
+    #
+    # For method calls obj.name(...), the attribute node is skipped as
+    # well.  The method is looked up through the type of 'obj' and, if it
+    # is a plain function, called with 'obj' as first argument instead of
+    # creating a bound method object.
+
+    method_temp = None
+    is_unbound_temp = None
+
+    def vectorcall_args(self):
+        # -> ([ExprNode], [keyword name]) or None
+        return None
+
+    def method_call_obj(self):
+        # -> ExprNode or None
+        function = self.function
+        if (function.is_attribute and function.is_py_attr and
+                function.obj.type.is_pyobject and self.vectorcall_args() is not None):
+            return function.obj
+        return None
+
+    def generate_subexpr_evaluation_code(self, code):
+        vectorcall_args = self.vectorcall_args()
+        if vectorcall_args is None:
+            ExprNode.generate_subexpr_evaluation_code(self, code)
+            return
+        obj = self.method_call_obj()
+        if obj is None:
+            self.function.generate_evaluation_code(code)
+        else:
+            obj.generate_evaluation_code(code)
+            code.globalstate.use_utility_code(
+                UtilityCode.load_cached("PyObjectGetMethod", "ObjectHandling.c"))
+            self.method_temp = code.funcstate.allocate_temp(py_object_type, manage_ref=True)
+            self.is_unbound_temp = code.funcstate.allocate_temp(
+                PyrexTypes.c_int_type, manage_ref=False)
+            code.putln('__Pyx_PyObject_GetMethodCached(%s, %s, %s, %s); %s' % (
+                self.is_unbound_temp,
+                self.method_temp,
+                obj.py_result(),
+                code.intern_identifier(self.function.attribute),
+                code.error_goto_if_null(self.method_temp, self.function.pos)))
+            code.put_gotref(self.method_temp)
+        for arg in vectorcall_args[0]:
+            arg.generate_evaluation_code(code)
+
+    def generate_subexpr_disposal_code(self, code):
+        vectorcall_args = self.vectorcall_args()
+        if vectorcall_args is None:
+            ExprNode.generate_subexpr_disposal_code(self, code)
+            return
+        obj = self.method_call_obj()
+        if obj is None:
+            self.function.generate_disposal_code(code)
+        else:
+            obj.generate_disposal_code(code)
+            code.put_decref_clear(self.method_temp, py_object_type)
+        for arg in vectorcall_args[0]:
+            arg.generate_disposal_code(code)
+
+    def free_subexpr_temps(self, code):
+        vectorcall_args = self.vectorcall_args()
+        if vectorcall_args is None:
+            ExprNode.free_subexpr_temps(self, code)
+            return
+        obj = self.method_call_obj()
+        if obj is None:
+            self.function.free_temps(code)
+        else:
+            obj.free_temps(code)
+            code.funcstate.release_temp(self.method_temp)
+            code.funcstate.release_temp(self.is_unbound_temp)
+            self.method_temp = self.is_unbound_temp = None
+        for arg in vectorcall_args[0]:
+            arg.free_temps(code)
+
+    def generate_vectorcall_code(self, code):
+        args, kwnames = self.vectorcall_args()
+        code.globalstate.use_utility_code(
+            UtilityCode.load_cached("PyObjectVectorCall", "ObjectHandling.c"))
+        if kwnames:
+            kwnames_tuple = code.get_py_const(py_object_type, 'tuple_', cleanup_level=2)
+            const_code = code.get_cached_constants_writer()
+            const_code.mark_pos(self.pos)
+            const_code.putln('%s = PyTuple_Pack(%d, %s); %s' % (
+                kwnames_tuple, len(kwnames),
+                ', '.join([ code.intern_identifier(name) for name in kwnames ]),
+                const_code.error_goto_if_null(kwnames_tuple, self.pos)))
+            const_code.put_gotref(kwnames_tuple)
+            const_code.put_giveref(kwnames_tuple)
+        else:
+            kwnames_tuple = 'NULL'
+        obj = self.method_call_obj()
+        if obj is not None:
+            # slot 0 holds 'obj' for unbound methods
+            args = [obj] + list(args)
+        # the array only holds borrowed references, so we must own a
+        # reference to arguments that the call could otherwise free
+        borrowed_args = [ '%s[%d]' % (Naming.callargs_cname, i)
+                          for i, arg in enumerate(args)
+                          if not arg.result_in_temp() and not arg.nonlocally_immutable() ]
+        code.putln('{')
+        if args:
+            callargs = Naming.callargs_cname
+            code.putln('PyObject *%s[%d];' % (callargs, len(args)))
+            for i, arg in enumerate(args):
+                code.putln('%s[%d] = %s;' % (callargs, i, arg.py_result()))
+        else:
+            callargs = 'NULL'
+        for arg in borrowed_args:
+            code.put_incref(arg, py_object_type)
+        if obj is None:
+            code.putln('%s = __Pyx_PyObject_VectorCall(%s, %s, %d, %s);' % (
+                self.result(),
+                self.function.py_result(),
+                callargs,
+                len(args) - len(kwnames),
+                kwnames_tuple))
+        else:
+            code.putln('%s = __Pyx_PyObject_VectorCall(%s, %s+1-%s, %d+%s, %s);' % (
+                self.result(),
+                self.method_temp,
+                callargs, self.is_unbound_temp,
+                len(args) - 1 - len(kwnames), self.is_unbound_temp,
+                kwnames_tuple))
+        for arg in borrowed_args:
+            code.put_decref(arg, py_object_type)
+        code.putln('}')
+        code.putln(code.error_goto_if_null(self.result(), self.pos))
+        code.put_gotref(self.py_result())
+
 
 class SimpleCallNode(CallNode):
     #  Function call without keyword, * or ** args.
@@ -4050,6 +4346,12 @@ class SimpleCallNode(CallNode):
     def explicit_args_kwds(self):
         return self.args, None
 
+    def infer_type(self, env):
+        func_type = self.function.infer_type(env)
+        if func_type.is_atomic_op:
+            return AtomicOpNode(self.pos, op=func_type.op, args=self.args).infer_type(env)
+        return super(SimpleCallNode, self).infer_type(env)
+
     def analyse_types(self, env):
         if self.analyse_as_type_constructor(env):
             return self
@@ -4060,6 +4362,10 @@ class SimpleCallNode(CallNode):
         self.function = self.function.analyse_types(env)
         function = self.function
 
+        if function.type.is_atomic_op:
+            node = AtomicOpNode(self.pos, op=function.type.op, args=self.args)
+            return node.analyse_types(env)
+
         if function.is_attribute and function.entry and function.entry.is_cmethod:
             # Take ownership of the object from which the attribute
             # was obtained, because we need to pass it as 'self'.
@@ -4110,6 +4416,14 @@ class SimpleCallNode(CallNode):
 
         return func_type
 
+    def vectorcall_args(self):
+        arg_tuple = self.arg_tuple
+        if (self.function_type().is_pyobject and isinstance(arg_tuple, TupleNode)
+                and not arg_tuple.mult_factor
+                and not (arg_tuple.is_literal and arg_tuple.args)):
+            return arg_tuple.args, []
+        return None
+
     def analyse_c_function_call(self, env):
         if self.function.type is error_type:
             self.type = error_type
@@ -4340,7 +4654,9 @@ class SimpleCallNode(CallNode):
         if self.function.is_name or self.function.is_attribute:
             if self.function.entry and self.function.entry.utility_code:
                 code.globalstate.use_utility_code(self.function.entry.utility_code)
-        if func_type.is_pyobject:
+        if func_type.is_pyobject and self.vectorcall_args() is not None:
+            self.generate_vectorcall_code(code)
+        elif func_type.is_pyobject:
             arg_code = self.arg_tuple.py_result()
             code.putln(
                 "%s = PyObject_Call(%s, %s, NULL); %s" % (
@@ -4436,6 +4752,9 @@ class InlinedDefNodeCallNode(CallNode):
     function = None
     function_name = None
 
+    nogil_check = Node.gil_error
+    gil_message = "Calling Python function"
+
     def can_be_inlined(self):
         func_type= self.function.def_node
         if func_type.star_arg or func_type.starstar_arg:
@@ -4628,6 +4947,25 @@ class GeneralCallNode(CallNode):
         self.is_temp = 1
         return self
 
+    def vectorcall_args(self):
+        positional_args = self.positional_args
+        keyword_args = self.keyword_args
+        if (self.type.is_error or not isinstance(positional_args, TupleNode)
+                or positional_args.mult_factor):
+            return None
+        if keyword_args is None:
+            if positional_args.is_literal and positional_args.args:
+                return None
+            return positional_args.args, []
+        if (not isinstance(keyword_args, DictNode) or keyword_args.type is not dict_type
+                or keyword_args.exclude_null_values):
+            return None
+        for item in keyword_args.key_value_pairs:
+            if not isinstance(item.key, IdentifierStringNode):
+                return None
+        return (positional_args.args + [ item.value for item in keyword_args.key_value_pairs ],
+                [ item.key.value for item in keyword_args.key_value_pairs ])
+
     def map_to_simple_call_node(self):
         """
         Tries to map keyword arguments to declared positional arguments.
@@ -4768,6 +5106,9 @@ class GeneralCallNode(CallNode):
 
     def generate_result_code(self, code):
         if self.type.is_error: return
+        if self.vectorcall_args() is not None:
+            self.generate_vectorcall_code(code)
+            return
         if self.keyword_args:
             kwargs = self.keyword_args.py_result()
         else:
@@ -5214,9 +5555,9 @@ class AttributeNode(ExprNode):
     def generate_result_code(self, code):
         if self.is_py_attr:
             code.globalstate.use_utility_code(
-                UtilityCode.load_cached("PyObjectGetAttrStr", "ObjectHandling.c"))
+                UtilityCode.load_cached("PyObjectGetAttrStrCached", "ObjectHandling.c"))
             code.putln(
-                '%s = __Pyx_PyObject_GetAttrStr(%s, %s); %s' % (
+                '__Pyx_PyObject_GetAttrStrCached(%s, %s, %s); %s' % (
                     self.result(),
                     self.obj.py_result(),
                     code.intern_identifier(self.attribute),
@@ -7004,6 +7345,9 @@ class PyCFunctionNode(ExprNode, ModuleNameMixin):
     def analyse_types(self, env):
         if self.binding:
             self.analyse_default_args(env)
+            if (self.def_node.py_wrapper and not self.specialized_cpdefs
+                    and not self.is_specialization):
+                self.def_node.py_wrapper.request_vectorcall()
         #TODO(craig,haoyu) This should be moved to a better place
         self.set_qualified_name(env, self.def_node.name)
         return self
@@ -7225,6 +7569,9 @@ class PyCFunctionNode(ExprNode, ModuleNameMixin):
         if self.annotations_dict:
             code.putln('__Pyx_CyFunction_SetAnnotationsDict(%s, %s);' % (
                 self.result(), self.annotations_dict.py_result()))
+        if def_node.py_wrapper and def_node.py_wrapper.uses_vectorcall():
+            code.putln('__Pyx_CyFunction_SetVectorcall(%s, %s);' % (
+                self.result(), def_node.py_wrapper.vectorcall_cname))
 
 
 class InnerFunctionNode(PyCFunctionNode):
@@ -54,6 +54,12 @@ class ControlBlock(object):
 
     """
 
+    # the flow graphs of large modules have many blocks and names,
+    # these classes do without an instance dict
+    __slots__ = ('children', 'parents', 'positions', 'stats', 'gen', 'bounded',
+                 'input', 'output', 'i_input', 'i_output', 'i_gen', 'i_kill',
+                 'i_state')
+
     def __init__(self):
         self.children = set()
         self.parents = set()
@@ -89,11 +95,15 @@ class ControlBlock(object):
 class ExitBlock(ControlBlock):
     """Non-empty exit point block."""
 
+    __slots__ = ()
+
     def empty(self):
         return False
 
 
 class AssignmentList(object):
+    __slots__ = ('bit', 'mask', 'stats')
+
     def __init__(self):
         self.stats = []
 
@@ -308,6 +318,8 @@ class ExceptionDescr(object):
 
 
 class NameAssignment(object):
+    __slots__ = ('lhs', 'rhs', 'entry', 'pos', 'refs', 'is_arg', 'is_deletion', 'bit')
+
     def __init__(self, lhs, rhs, entry):
         if lhs.cf_state is None:
             lhs.cf_state = set()
@@ -331,6 +343,8 @@ class NameAssignment(object):
 
 class StaticAssignment(NameAssignment):
     """Initialised at declaration time, e.g. stack allocation."""
+    __slots__ = ()
+
     def __init__(self, entry):
         if not entry.type.is_pyobject:
             may_be_none = False
@@ -348,12 +362,16 @@ class StaticAssignment(NameAssignment):
 
 
 class Argument(NameAssignment):
+    __slots__ = ()
+
     def __init__(self, lhs, rhs, entry):
         NameAssignment.__init__(self, lhs, rhs, entry)
         self.is_arg = True
 
 
 class NameDeletion(NameAssignment):
+    __slots__ = ()
+
     def __init__(self, lhs, entry):
         NameAssignment.__init__(self, lhs, lhs, entry)
         self.is_deletion = True
@@ -375,6 +393,8 @@ class Unknown(object):
 
 
 class NameReference(object):
+    __slots__ = ('node', 'entry', 'pos')
+
     def __init__(self, node, entry):
         if node.cf_state is None:
             node.cf_state = set()
@@ -393,11 +413,12 @@ class ControlFlowState(list):
     # cf_maybe_null     [boolean] May be uninitialized
     # is_single         [boolean] Has only one assignment at this point
 
-    cf_maybe_null = False
-    cf_is_null = False
-    is_single = False
+    __slots__ = ('cf_maybe_null', 'cf_is_null', 'is_single')
 
     def __init__(self, state):
+        self.cf_maybe_null = False
+        self.cf_is_null = False
+        self.is_single = False
         if Uninitialized in state:
             state.discard(Uninitialized)
             self.cf_maybe_null = True
@@ -19,6 +19,7 @@ from Errors import PyrexError, CompileError, error, warning
 from Symtab import ModuleScope
 from Cython import Utils
 import Options
+import Timings
 
 module_name_pattern = re.compile(r"[A-Za-z_][A-Za-z0-9_]*(\.[A-Za-z_][A-Za-z0-9_]*)*$")
 
@@ -422,7 +423,13 @@ def run_pipeline(source, options, full_module_name=None, context=None):
         pipeline = Pipeline.create_pyx_pipeline(context, options, result)
 
     context.setup_errors(options, result)
-    err, enddata = Pipeline.run_pipeline(pipeline, source)
+    if options.timings:
+        Timings.start_module(full_module_name)
+    try:
+        err, enddata = Pipeline.run_pipeline(pipeline, source)
+    finally:
+        if options.timings:
+            result.timings = Timings.end_module()
     context.teardown_errors(err, options, result)
     return result
 
@@ -464,6 +471,16 @@ class CompilationOptions(object):
     compiler_directives  dict      Overrides for pragma options (see Options.py)
     evaluate_tree_assertions boolean  Test support: evaluate parse tree assertions
     language_level    integer   The Python language level: 2 or 3
+    pxd_cache         string    Directory for caching parsed .pxd files
+    server            boolean   Run a compiler server (see Server.py)
+    fingerprint       string    Hash of the inputs, recorded in the C file
+    split_c           integer   Number of C files to split the module into
+    shared_runtime    boolean   Share the runtime types of Cython with other modules
+    timings           boolean or string  Record the timings of the compiler stages,
+                                and report them on stderr (True) or as JSON
+                                in the given file (see Timings.py)
+    function_jobs     integer   Number of processes that generate the code of
+                                the module level functions (POSIX only)
 
     cplus             boolean   Compile as c++ code
     """
@@ -509,6 +526,7 @@ class CompilationResult(object):
     extension_file   string or None   Result of linking the object file
     num_errors       integer          Number of compilation errors
     compilation_source CompilationSource
+    timings          dict or None     Timings of the compiler stages
     """
 
     def __init__(self):
@@ -520,6 +538,7 @@ class CompilationResult(object):
         self.object_file = None
         self.extension_file = None
         self.main_source_file = None
+        self.timings = None
 
 
 class CompilationResultSet(dict):
@@ -631,10 +650,24 @@ def main(command_line = 0):
         sys.stderr.write("Cython version %s\n" % Version.version)
     if options.working_path!="":
         os.chdir(options.working_path)
+    if options.server:
+        import Server
+        try:
+            Server.serve()
+        except EnvironmentError, e:
+            sys.stderr.write(str(e) + '\n')
+            sys.exit(1)
+        return
     try:
         result = compile(sources, options)
         if result.num_errors > 0:
             any_failures = 1
+        if options.timings:
+            if isinstance(result, CompilationResult):
+                results = [result]
+            else:
+                results = [result[source] for source in sorted(result)]
+            Timings.report([r.timings for r in results], options.timings)
     except (EnvironmentError, PyrexError), e:
         sys.stderr.write(str(e) + '\n')
         any_failures = 1
@@ -671,4 +704,11 @@ default_options = dict(
     language_level = 2,
     gdb_debug = False,
     compile_time_env = None,
+    pxd_cache = None,
+    server = False,
+    fingerprint = None,
+    split_c = 0,
+    shared_runtime = False,
+    timings = None,
+    function_jobs = 0,
 )
@@ -13,9 +13,11 @@ import Future
 
 import Annotate
 import Code
+import CodeSplitting
 import Naming
 import Nodes
 import Options
+import ParallelFunctions
 import TypeSlots
 import Version
 import PyrexTypes
@@ -23,11 +25,30 @@ import PyrexTypes
 from Errors import error, warning
 from PyrexTypes import py_object_type
 from Cython.Utils import open_new_file, replace_suffix, decode_filename
+from Cython import StringIOTree
 from Code import UtilityCode
 from StringEncoding import EncodedString
+from Visitor import TreeVisitor
 
 
 
+class ReleaseFunctionBodies(TreeVisitor):
+    """
+    Drops the bodies of the functions in a tree after their C code was
+    generated.  The function nodes themselves are still needed for the
+    module init code (e.g. for the default arguments).
+    """
+    def __call__(self, node):
+        self.visit(node)
+
+    def visit_Node(self, node):
+        self.visitchildren(node)
+
+    def visit_FuncDefNode(self, node):
+        self.visitchildren(node, [attr for attr in node.child_attrs if attr != 'body'])
+        node.body = None
+
+
 def check_c_declarations_pxd(module_node):
     module_node.scope.check_c_classes_pxd()
     return module_node
@@ -47,9 +68,11 @@ class ModuleNode(Nodes.Node, Nodes.BlockNode):
     #  scope                The module scope.
     #  compilation_source   A CompilationSource (see Main)
     #  directives           Top-level compiler directives
+    #  nogil_inference_notes  [(pos, string)]  decisions of the 'infer_nogil' directive
 
     child_attrs = ["body"]
     directives = None
+    nogil_inference_notes = ()
 
     def merge_in(self, tree, scope, merge_scope=False):
         # Merges in the contents of another tree, and possibly scope. With the
@@ -317,7 +340,10 @@ class ModuleNode(Nodes.Node, Nodes.BlockNode):
         globalstate.initialize_main_c_code()
         h_code = globalstate['h_code']
 
-        self.generate_module_preamble(env, modules, h_code)
+        # the line numbers of annotations and debug information refer to a single file
+        split = (getattr(options, 'split_c', 0) > 1 and
+                 not (Options.annotate or options.annotate or options.gdb_debug))
+        self.generate_module_preamble(env, options, modules, h_code, split)
 
         globalstate.module_pos = self.pos
         globalstate.directives = self.directives
@@ -336,7 +362,18 @@ class ModuleNode(Nodes.Node, Nodes.BlockNode):
         self.generate_lambda_definitions(env, code)
         # generate normal variable and function definitions
         self.generate_variable_definitions(env, code)
-        self.body.generate_function_definitions(env, code)
+        # the annotations are generated from the function bodies at the end
+        release = not (Options.annotate or options.annotate)
+        chunks = spill_file = None
+        if split:
+            chunks = []
+        elif release:
+            spill_file = StringIOTree.spill_file()
+        jobs = 0
+        if not (Options.annotate or options.annotate or options.gdb_debug):
+            jobs = getattr(options, 'function_jobs', 0)
+        self.generate_function_definition_chunks(
+            env, code, chunks, release, spill_file, jobs)
         code.mark_pos(None)
         self.generate_typeobj_definitions(env, code)
         self.generate_method_table(env, code)
@@ -358,16 +395,101 @@ class ModuleNode(Nodes.Node, Nodes.BlockNode):
             globalstate.use_utility_code(utilcode)
         globalstate.finalize_main_c_code()
 
-        f = open_new_file(result.c_file)
-        rootwriter.copyto(f)
-        if options.gdb_debug:
-            self._serialize_lineno_map(env, rootwriter)
-        f.close()
+        if split:
+            self.write_split_c_files(globalstate, chunks, options.split_c - 1, result.c_file)
+        else:
+            f = open_new_file(result.c_file)
+            rootwriter.copyto(f)
+            if options.gdb_debug:
+                self._serialize_lineno_map(env, rootwriter)
+            f.close()
+            if spill_file is not None:
+                spill_file.close()
+            CodeSplitting.remove_part_files(result.c_file, 0)
         result.c_file_generated = 1
         if Options.annotate or options.annotate:
             self.annotate(rootwriter)
             rootwriter.save_annotation(result.main_source_file, result.c_file)
 
+    def generate_function_definition_chunks(self, env, code, chunks, release,
+                                            spill_file=None, jobs=0):
+        # Generate the function definitions of each top level statement,
+        # into a separate writer if they are collected as chunks that can
+        # be written to different files.  To keep the memory use of the
+        # tree and of the code from adding up, the bodies of the functions
+        # are dropped with 'release' as soon as their code is generated,
+        # and the finished code is moved to the spill file if there is one.
+        # With more than one job, the code is generated in worker processes
+        # and merged here in the order of the statements.
+        units = []
+        self.collect_function_definition_units(
+            self.body, code.globalstate.directives, units)
+        if chunks is None:
+            new_writer = code.insertion_point
+        else:
+            new_writer = code.new_writer
+        function_jobs = ParallelFunctions.start(units, env, code, jobs, new_writer)
+        directives = code.globalstate.directives
+        for index, (node, unit_directives) in enumerate(units):
+            code.globalstate.directives = unit_directives
+            writer = new_writer()
+            if function_jobs is None or not function_jobs.merge(index, writer):
+                node.generate_function_definitions(env, writer)
+            if chunks is not None:
+                chunks.append(writer.getvalue())
+            elif spill_file is not None:
+                writer.buffer.spill(spill_file)
+            if release:
+                ReleaseFunctionBodies()(node)
+        code.globalstate.directives = directives
+
+    def collect_function_definition_units(self, node, directives, units):
+        # the top level statements with the directives they are generated with
+        if type(node) is Nodes.StatListNode:  # not a subclass like FusedCFuncDefNode
+            for stat in node.stats:
+                self.collect_function_definition_units(stat, directives, units)
+        elif isinstance(node, Nodes.CompilerDirectivesNode):
+            self.collect_function_definition_units(node.body, node.directives, units)
+        else:
+            units.append((node, directives))
+
+    def write_split_c_files(self, globalstate, chunks, max_parts, c_file):
+        # distribute the chunks over the parts by size, keeping their order
+        chunks = [(i, chunk) for i, chunk in enumerate(chunks) if chunk.strip()]
+        parts = [[] for _ in range(min(max_parts, len(chunks)) or 1)]
+        sizes = [0] * len(parts)
+        for size, i, chunk in sorted([(-len(chunk), i, chunk) for i, chunk in chunks]):
+            smallest = sizes.index(min(sizes))
+            parts[smallest].append((i, chunk))
+            sizes[smallest] -= size
+        parts_code = [''.join([chunk for i, chunk in sorted(part)]) for part in parts]
+
+        part_files = CodeSplitting.part_file_names(c_file, len(parts_code))
+        self.split_comment.putln(CodeSplitting.part_files_comment(part_files))
+
+        layout = globalstate.code_layout
+        end_of_declarations = layout.index('decls') + 1
+        declarations = ''.join([globalstate.parts[part].getvalue()
+                                for part in layout[:end_of_declarations]
+                                if part in globalstate.parts])
+        main_code = ''.join([globalstate.parts[part].getvalue()
+                             for part in layout[end_of_declarations:]
+                             if part in globalstate.parts])
+        main_code, parts_code = CodeSplitting.split_code(declarations, main_code, parts_code)
+        # close the conditional blocks of the declarations
+        end = globalstate.parts['end'].getvalue()
+        parts_code = [code + end for code in parts_code]
+        for path, code in [(c_file, main_code)] + zip(part_files, parts_code):
+            f = open_new_file(path)
+            f.write(code)
+            f.close()
+        CodeSplitting.remove_part_files(c_file, len(part_files))
+
+    def annotate(self, code):
+        for pos, text in self.nogil_inference_notes:
+            code.annotate(pos, Annotate.AnnotationItem('infer_nogil', text))
+        self.body.annotate(code)
+
     def _serialize_lineno_map(self, env, ccodewriter):
         tb = env.context.gdb_debug_outputwriter
         markers = ccodewriter.buffer.allmarkers()
@@ -502,28 +624,32 @@ class ModuleNode(Nodes.Node, Nodes.BlockNode):
             self.generate_cvariable_declarations(module, modulecode, defined_here)
             self.generate_cfunction_declarations(module, modulecode, defined_here)
 
-    def generate_module_preamble(self, env, cimported_modules, code):
+    def generate_module_preamble(self, env, options, cimported_modules, code, split=False):
         code.putln("/* Generated by Cython %s */" % Version.watermark)
+        if options.fingerprint:
+            code.putln("/* Cython fingerprint: %s */" % options.fingerprint)
+        if split:
+            # the names of the part files are known at the end
+            self.split_comment = code.insertion_point()
+            code.put(CodeSplitting.hidden_macro_definition)
         code.putln("")
         code.putln("#define PY_SSIZE_T_CLEAN")
+        if options.shared_runtime:
+            code.putln("#ifndef CYTHON_SHARED_RUNTIME")
+            code.putln("#define CYTHON_SHARED_RUNTIME 1")
+            code.putln("#endif")
 
-        # sizeof(PyLongObject.ob_digit[0]) may have been determined dynamically
-        # at compile time in CPython, in which case we can't know the correct
-        # storage size for an installed system.  We can rely on it only if
-        # pyconfig.h defines it statically, i.e. if it was set by "configure".
-        # Once we include "Python.h", it will come up with its own idea about
-        # a suitable value, which may or may not match the real one.
+        # sizeof(PyLongObject.ob_digit[0]) is either set by "configure" in
+        # pyconfig.h or derived by pyport.h from the integer types that
+        # pyconfig.h declares, so the installed headers of CPython agree
+        # with the interpreter about it.  Only a PYLONG_BITS_IN_DIGIT that
+        # is defined before including "Python.h" could make them disagree.
         code.putln("#ifndef CYTHON_USE_PYLONG_INTERNALS")
         code.putln("#ifdef PYLONG_BITS_IN_DIGIT")
         # assume it's an incorrect left-over
         code.putln("#define CYTHON_USE_PYLONG_INTERNALS 0")
         code.putln("#else")
-        code.putln('#include "pyconfig.h"')
-        code.putln("#ifdef PYLONG_BITS_IN_DIGIT")
         code.putln("#define CYTHON_USE_PYLONG_INTERNALS 1")
-        code.putln("#else")
-        code.putln("#define CYTHON_USE_PYLONG_INTERNALS 0")
-        code.putln("#endif")
         code.putln("#endif")
         code.putln("#endif")
 
@@ -537,6 +663,8 @@ class ModuleNode(Nodes.Node, Nodes.BlockNode):
         code.globalstate["end"].putln("#endif /* Py_PYTHON_H */")
 
         code.put(UtilityCode.load_as_string("CModulePreamble", "ModuleSetupCode.c")[1])
+        # modules of other Cython versions use another runtime module
+        code.putln('#define CYTHON_ABI "%s"' % Version.version.replace('.', '_'))
 
         code.put("""
 #if PY_MAJOR_VERSION >= 3
@@ -1428,7 +1556,7 @@ class ModuleNode(Nodes.Node, Nodes.BlockNode):
         code.putln(
                 "PyObject *r;")
         code.putln(
-                "PyObject *x = PyInt_FromSsize_t(i); if(!x) return 0;")
+                "PyObject *x = __Pyx_PyInt_FromSsize_t(i); if(!x) return 0;")
         code.putln(
                 "r = Py_TYPE(o)->tp_as_mapping->mp_subscript(o, x);")
         code.putln(
@@ -2020,6 +2148,11 @@ class ModuleNode(Nodes.Node, Nodes.BlockNode):
                 UtilityCode.load_cached("RegisterModuleCleanup", "ModuleSetupCode.c"))
             code.putln("if (__Pyx_RegisterCleanup()) %s;" % code.error_goto(self.pos))
 
+        if env.directives['frozen_globals']:
+            code.globalstate.use_utility_code(
+                UtilityCode.load_cached("GlobalsFrozen", "ObjectHandling.c"))
+            code.putln("%s = 1;" % Naming.globals_frozen_cname)
+
         code.put_goto(code.return_label)
         code.put_label(code.error_label)
         for cname, type in code.funcstate.all_managed_temps():
@@ -20,6 +20,7 @@ enum_prefix       = pyrex_prefix + "e_"
 func_prefix       = pyrex_prefix + "f_"
 pyfunc_prefix     = pyrex_prefix + "pf_"
 pywrap_prefix     = pyrex_prefix + "pw_"
+pyvectorcall_prefix = pyrex_prefix + "vc_"
 genbody_prefix    = pyrex_prefix + "gb_"
 gstab_prefix      = pyrex_prefix + "getsets_"
 prop_get_prefix   = pyrex_prefix + "getprop_"
@@ -54,13 +55,18 @@ defaults_struct_prefix = pyrex_prefix + "defaults"
 dynamic_args_cname = pyrex_prefix + "dynamic_args"
 
 args_cname       = pyrex_prefix + "args"
+nargs_cname      = pyrex_prefix + "nargs"
+kwnames_cname    = pyrex_prefix + "kwnames"
+callargs_cname   = pyrex_prefix + "callargs"
 generator_cname  = pyrex_prefix + "generator"
 sent_value_cname = pyrex_prefix + "sent_value"
 pykwdlist_cname  = pyrex_prefix + "pyargnames"
+pykwhash_cname   = pyrex_prefix + "pyarghash"
 obj_base_cname   = pyrex_prefix + "base"
 builtins_cname   = pyrex_prefix + "b"
 preimport_cname  = pyrex_prefix + "i"
 moddict_cname    = pyrex_prefix + "d"
+globals_frozen_cname = pyrex_prefix + "globals_frozen"
 dummy_cname      = pyrex_prefix + "dummy"
 filename_cname   = pyrex_prefix + "filename"
 modulename_cname = pyrex_prefix + "modulename"
@@ -124,6 +130,18 @@ parallel_filename = pyrex_prefix + "parallel_filename"
 parallel_lineno = pyrex_prefix + "parallel_lineno"
 parallel_clineno = pyrex_prefix + "parallel_clineno"
 parallel_why = pyrex_prefix + "parallel_why"
+parallel_why_local = pyrex_prefix + "parallel_why_local"
+parallel_gilstate = pyrex_prefix + "parallel_gilstate"
+parallel_thread_state = pyrex_prefix + "parallel_thread_state"
+parallel_profile_section_prefix = pyrex_prefix + "parallel_profile_section"
+parallel_profile_start = pyrex_prefix + "parallel_profile_start"
+parallel_profile_t0 = pyrex_prefix + "parallel_profile_t0"
+parallel_profile_t1 = pyrex_prefix + "parallel_profile_t1"
+parallel_profile_iterations = pyrex_prefix + "parallel_profile_iterations"
+parallel_profile_chunks = pyrex_prefix + "parallel_profile_chunks"
+parallel_profile_last = pyrex_prefix + "parallel_profile_last"
+parallel_adaptive_schedule_prefix = pyrex_prefix + "adaptive_schedule"
+parallel_adaptive_call = pyrex_prefix + "adaptive_call"
 
 exc_vars = (exc_type_name, exc_value_name, exc_tb_name)
 
@@ -75,6 +75,45 @@ def embed_position(pos, docstring):
     return doc
 
 
+# def functions with at least this many named arguments look up
+# their keyword arguments in a hash table
+keyword_hash_table_min_args = 8
+
+def keyword_hash(name, multiplier):
+    # must match __Pyx_KwHashTable_Lookup() in FunctionArguments.c
+    h = len(name)
+    for c in (name[0], name[len(name) // 2], name[-1]):
+        h = (h * multiplier + ord(c)) & 0xffffffff
+    return h
+
+def keyword_hash_table(names):
+    """
+    Find a multiplier and a table size for which the names collide
+    as little as possible under keyword_hash().  Returns the
+    multiplier, the mask of the table size and the table slots, which
+    hold the index of a name plus one, or 0 for unused slots.
+    """
+    size = 1
+    while size < 2 * len(names):
+        size *= 2
+    best = None
+    for size in (size, size * 2, size * 4):
+        for multiplier in range(1, 2048, 2):
+            slots = [0] * size
+            collisions = 0
+            for i, name in enumerate(names):
+                h = keyword_hash(name, multiplier) & (size - 1)
+                if slots[h]:
+                    collisions += 1
+                else:
+                    slots[h] = i + 1
+            if best is None or collisions < best[0]:
+                best = (collisions, multiplier, size - 1, slots)
+                if not collisions:
+                    return best[1:]
+    return best[1:]
+
+
 def write_func_call(func, codewriter_class):
     def f(*args, **kwds):
         if len(args) > 1 and isinstance(args[1], codewriter_class):
@@ -934,6 +973,8 @@ class CSimpleBaseTypeNode(CBaseTypeNode):
             type = PyrexTypes.c_double_complex_type
             type.create_declaration_utility_code(env)
             self.complex = True
+        elif type and type.is_atomic:
+            type.create_declaration_utility_code(env)
         if type:
             return type
         else:
@@ -1353,7 +1394,7 @@ class CEnumDefNode(StatNode):
         if self.visibility == 'public' or self.api:
             temp = code.funcstate.allocate_temp(PyrexTypes.py_object_type, manage_ref=True)
             for item in self.entry.enum_values:
-                code.putln("%s = PyInt_FromLong(%s); %s" % (
+                code.putln("%s = __Pyx_PyInt_FromLong(%s); %s" % (
                         temp,
                         item.cname,
                         code.error_goto_if_null(temp, item.pos)))
@@ -2876,6 +2917,8 @@ class DefNodeWrapper(FuncDefNode):
 
     defnode = None
     target = None # Target DefNode
+    vectorcall_cname = None
+    vectorcall_requested = False
 
     def __init__(self, *args, **kwargs):
         FuncDefNode.__init__(self, *args, **kwargs)
@@ -2891,9 +2934,36 @@ class DefNodeWrapper(FuncDefNode):
         prefix = env.next_id(env.scope_prefix)
         target_entry.func_cname = Naming.pywrap_prefix + prefix + name
         target_entry.pymethdef_cname = Naming.pymethdef_prefix + prefix + name
+        self.vectorcall_cname = Naming.pyvectorcall_prefix + prefix + name
 
         self.signature = target_entry.signature
 
+    def request_vectorcall(self):
+        # called for functions that become CyFunction objects
+        self.vectorcall_requested = True
+
+    def uses_vectorcall(self):
+        # Functions with only positional-or-keyword arguments get a second
+        # wrapper that receives its arguments as a C array from
+        # __Pyx_PyObject_VectorCall() and passes everything it does not
+        # handle itself on to the tuple based wrapper.
+        if not self.vectorcall_requested or not self.target.py_wrapper_required:
+            return False
+        sig = self.signature
+        if not (sig.has_generic_args and sig.has_dummy_arg and
+                self.signature_has_nongeneric_args()):
+            return False
+        if (self.target.entry.is_special or self.star_arg or self.starstar_arg or
+                self.num_kwonly_args or self.self_in_stararg):
+            return False
+        for arg in self.args:
+            if not arg.is_generic or arg.is_self_arg or arg.is_type_arg:
+                return False
+            if not arg.type.is_pyobject and (
+                    arg.type.is_memoryviewslice or not arg.type.from_py_function):
+                return False
+        return True
+
     def prepare_argument_coercion(self, env):
         # This is only really required for Cython utility code at this time,
         # everything else can be done during code generation.  But we expand
@@ -2937,10 +3007,18 @@ class DefNodeWrapper(FuncDefNode):
             self.target.entry.pyfunc_cname, args))
 
     def generate_function_definitions(self, env, code):
+        self.generate_wrapper_function(env, code)
+        if self.uses_vectorcall():
+            self.generate_wrapper_function(env, code, vectorcall=True)
+
+    def generate_wrapper_function(self, env, code, vectorcall=False):
         lenv = self.target.local_scope
         # Generate C code for header and body of function
         code.putln("")
-        code.putln("/* Python wrapper */")
+        if vectorcall:
+            code.putln("/* Python wrapper for vectorcalls */")
+        else:
+            code.putln("/* Python wrapper */")
         preprocessor_guard = self.target.get_preprocessor_guard()
         if preprocessor_guard:
             code.putln(preprocessor_guard)
@@ -2948,9 +3026,12 @@ class DefNodeWrapper(FuncDefNode):
         code.enter_cfunc_scope()
         code.return_from_error_cleanup_label = code.new_label()
 
-        with_pymethdef = (self.target.needs_assignment_synthesis(env, code) or
-                          self.target.pymethdef_required)
-        self.generate_function_header(code, with_pymethdef)
+        if vectorcall:
+            self.generate_vectorcall_header(code)
+        else:
+            with_pymethdef = (self.target.needs_assignment_synthesis(env, code) or
+                              self.target.pymethdef_required)
+            self.generate_function_header(code, with_pymethdef)
         self.generate_argument_declarations(lenv, code)
         tempvardecl_code = code.insertion_point()
 
@@ -2965,7 +3046,10 @@ class DefNodeWrapper(FuncDefNode):
         code.put_declare_refcount_context()
         code.put_setup_refcount_context('%s (wrapper)' % self.name)
 
-        self.generate_argument_parsing_code(lenv, code)
+        if vectorcall:
+            self.generate_vectorcall_parsing_code(lenv, code)
+        else:
+            self.generate_argument_parsing_code(lenv, code)
         self.generate_argument_type_tests(code)
         self.generate_function_body(code)
 
@@ -3072,6 +3156,14 @@ class DefNodeWrapper(FuncDefNode):
             code.put_pymethoddef(self.target.entry, ";", allow_skip=False)
         code.putln("%s {" % header)
 
+    def generate_vectorcall_header(self, code):
+        header = "static %s(PyObject *%s, PyObject **%s, Py_ssize_t %s, PyObject *%s)" % (
+            self.return_type.declaration_code(self.vectorcall_cname),
+            Naming.self_cname, Naming.args_cname,
+            Naming.nargs_cname, Naming.kwnames_cname)
+        code.putln("%s; /*proto*/" % header)
+        code.putln("%s {" % header)
+
     def generate_argument_declarations(self, env, code):
         for arg in self.args:
             if arg.is_generic:
@@ -3129,6 +3221,63 @@ class DefNodeWrapper(FuncDefNode):
         if code.label_used(end_label):
             code.put_label(end_label)
 
+    def generate_vectorcall_parsing_code(self, env, code):
+        # Unpack the C array of a vectorcall.  Keywords that are not found
+        # by identity, missing arguments and all other argument errors are
+        # left to the tuple based wrapper.
+        old_error_label = code.new_error_label()
+        our_error_label = code.error_label
+        end_label = code.new_label("argument_unpacking_done")
+        fallback_label = code.new_label("vectorcall_fallback")
+        args = self.args
+
+        code.putln('{')
+        kwhash = self.generate_argnames_declaration(args, code)
+        self.generate_argument_values_setup_code(args, code)
+
+        code.putln('switch (%s) {' % Naming.nargs_cname)
+        for i in range(len(args)-1, -1, -1):
+            code.put('case %2d: ' % (i+1))
+            code.putln("values[%d] = %s[%d];" % (i, Naming.args_cname, i))
+        code.putln('case  0: break;')
+        code.put('default: ')
+        code.put_goto(fallback_label)
+        code.putln('}')
+
+        code.globalstate.use_utility_code(
+            UtilityCode.load_cached("MatchVectorcallKeywords", "FunctionArguments.c"))
+        code.put('if (unlikely(%s) && unlikely(__Pyx_MatchVectorcallKeywords(%s, %s + %s, %s, %s, values, %s) < 0)) ' % (
+            Naming.kwnames_cname, Naming.kwnames_cname,
+            Naming.args_cname, Naming.nargs_cname,
+            Naming.pykwdlist_cname, kwhash, Naming.nargs_cname))
+        code.put_goto(fallback_label)
+        missing = [ 'unlikely(!values[%d])' % i
+                    for i, arg in enumerate(args) if not arg.default ]
+        if missing:
+            code.put('if (%s) ' % ' || '.join(missing))
+            code.put_goto(fallback_label)
+
+        for i, arg in enumerate(args):
+            self.generate_arg_assignment(arg, "values[%d]" % i, code)
+        code.putln('}')
+        code.put_goto(end_label)
+
+        code.put_label(fallback_label)
+        code.globalstate.use_utility_code(
+            UtilityCode.load_cached("VectorcallViaTuple", "FunctionArguments.c"))
+        code.put_finish_refcount_context()
+        code.putln("return __Pyx_VectorcallViaTuple((PyCFunctionWithKeywords)%s, %s, %s, %s, %s);" % (
+            self.target.entry.func_cname, Naming.self_cname,
+            Naming.args_cname, Naming.nargs_cname, Naming.kwnames_cname))
+
+        code.error_label = old_error_label
+        if code.label_used(our_error_label):
+            code.put_label(our_error_label)
+            code.put_add_traceback(self.target.entry.qualified_name)
+            code.put_finish_refcount_context()
+            code.putln("return %s;" % self.error_value())
+        code.put_label(end_label)
+
     def generate_arg_xdecref(self, arg, code):
         if arg:
             code.put_var_xdecref_clear(arg.entry)
@@ -3249,10 +3398,7 @@ class DefNodeWrapper(FuncDefNode):
 
         code.putln('{')
         all_args = tuple(positional_args) + tuple(kw_only_args)
-        code.putln("static PyObject **%s[] = {%s,0};" % (
-            Naming.pykwdlist_cname,
-            ','.join([ '&%s' % code.intern_identifier(arg.name)
-                        for arg in all_args ])))
+        kwhash = self.generate_argnames_declaration(all_args, code)
 
         # Before being converted and assigned to the target variables,
         # borrowed references to all unpacked argument values are
@@ -3271,7 +3417,7 @@ class DefNodeWrapper(FuncDefNode):
         self.generate_keyword_unpacking_code(
             min_positional_args, max_positional_args,
             has_fixed_positional_count, has_kw_only_args,
-            all_args, argtuple_error_label, code)
+            all_args, kwhash, argtuple_error_label, code)
 
         # --- optimised code when we do not receive any keyword arguments
         if (self.num_required_kw_args and min_positional_args > 0) or min_positional_args == max_positional_args:
@@ -3416,6 +3562,25 @@ class DefNodeWrapper(FuncDefNode):
             code.put_incref(Naming.empty_tuple, py_object_type)
             code.putln('}')
 
+    def generate_argnames_declaration(self, args, code):
+        # Declare the array of interned argument names and, for functions
+        # with many arguments, a hash table over them.  Returns the C
+        # expression that points to the hash table.
+        code.putln("static PyObject **%s[] = {%s,0};" % (
+            Naming.pykwdlist_cname,
+            ','.join([ '&%s' % code.intern_identifier(arg.name)
+                        for arg in args ])))
+        if len(args) < keyword_hash_table_min_args:
+            return '0'
+        code.globalstate.use_utility_code(
+            UtilityCode.load_cached("KeywordHashTable", "FunctionArguments.c"))
+        multiplier, mask, slots = keyword_hash_table([arg.name for arg in args])
+        code.putln("static const short %s_slots[] = {%s};" % (
+            Naming.pykwhash_cname, ','.join(map(str, slots))))
+        code.putln("static const __Pyx_KwHashTable %s = {%dU, %dU, %s_slots};" % (
+            Naming.pykwhash_cname, multiplier, mask, Naming.pykwhash_cname))
+        return '&%s' % Naming.pykwhash_cname
+
     def generate_argument_values_setup_code(self, args, code):
         max_args = len(args)
         # the 'values' array collects borrowed references to arguments
@@ -3437,7 +3602,7 @@ class DefNodeWrapper(FuncDefNode):
 
     def generate_keyword_unpacking_code(self, min_positional_args, max_positional_args,
                                         has_fixed_positional_count, has_kw_only_args,
-                                        all_args, argtuple_error_label, code):
+                                        all_args, kwhash, argtuple_error_label, code):
         code.putln('Py_ssize_t kw_args;')
         code.putln('const Py_ssize_t pos_args = PyTuple_GET_SIZE(%s);' % Naming.args_cname)
         # copy the values from the args tuple and check that it's not too long
@@ -3543,9 +3708,10 @@ class DefNodeWrapper(FuncDefNode):
         code.globalstate.use_utility_code(
             UtilityCode.load_cached("ParseKeywords", "FunctionArguments.c"))
         code.putln(
-            'if (unlikely(__Pyx_ParseOptionalKeywords(%s, %s, %s, values, %s, "%s") < 0)) %s' % (
+            'if (unlikely(__Pyx_ParseOptionalKeywords(%s, %s, %s, %s, values, %s, "%s") < 0)) %s' % (
                 Naming.kwds_cname,
                 Naming.pykwdlist_cname,
+                kwhash,
                 self.starstar_arg and self.starstar_arg.entry.cname or '0',
                 pos_arg_count,
                 self.name,
@@ -3875,9 +4041,9 @@ class OverrideCheckNode(StatNode):
         self.func_node.set_cname(func_node_temp)
         # need to get attribute manually--scope would return cdef method
         code.globalstate.use_utility_code(
-            UtilityCode.load_cached("PyObjectGetAttrStr", "ObjectHandling.c"))
+            UtilityCode.load_cached("PyObjectGetAttrStrCached", "ObjectHandling.c"))
         err = code.error_goto_if_null(func_node_temp, self.pos)
-        code.putln("%s = __Pyx_PyObject_GetAttrStr(%s, %s); %s" % (
+        code.putln("__Pyx_PyObject_GetAttrStrCached(%s, %s, %s); %s" % (
             func_node_temp, self_arg, interned_attr_cname, err))
         code.put_gotref(func_node_temp)
         is_builtin_function_or_method = "PyCFunction_Check(%s)" % func_node_temp
@@ -4678,6 +4844,7 @@ class InPlaceAssignmentNode(AssignmentNode):
     #  (it must be a NameNode, AttributeNode, or IndexNode).
 
     child_attrs = ["lhs", "rhs"]
+    atomic_function = None
 
     def analyse_declarations(self, env):
         self.lhs.analyse_target_declaration(env)
@@ -4688,12 +4855,27 @@ class InPlaceAssignmentNode(AssignmentNode):
         self.rhs = self.rhs.analyse_types(env)
         self.lhs = self.lhs.analyse_target_types(env)
 
+        if self.lhs.type.is_atomic:
+            return self.analyse_atomic_operation(env)
+
         # When assigning to a fully indexed buffer or memoryview, coerce the rhs
         if (isinstance(self.lhs, ExprNodes.IndexNode) and
                 (self.lhs.memslice_index or self.lhs.is_buffer_access)):
             self.rhs = self.rhs.coerce_to(self.lhs.type, env)
         return self
 
+    def analyse_atomic_operation(self, env):
+        # 'a += b' on a cython.atomic variable is 'atomic.fetch_add(&a, b)'
+        import ExprNodes
+        op = atomic_inplace_operators.get(self.operator)
+        if op is None:
+            error(self.pos, "In-place operator '%s=' not supported for atomic type '%s'" % (
+                self.operator, self.lhs.type))
+        elif ExprNodes.check_atomic_value_type(self.pos, op, self.lhs.type):
+            self.rhs = self.rhs.coerce_to(self.lhs.type.typedef_base_type, env)
+            self.atomic_function = ExprNodes.atomic_op_function(env, op, self.lhs.type)
+        return self
+
     def generate_execution_code(self, code):
         import ExprNodes
         self.rhs.generate_evaluation_code(code)
@@ -4703,7 +4885,10 @@ class InPlaceAssignmentNode(AssignmentNode):
             c_op = "/"
         elif c_op == "**":
             error(self.pos, "No C inplace power operator")
-        if isinstance(self.lhs, ExprNodes.IndexNode) and self.lhs.is_buffer_access:
+        if self.atomic_function:
+            code.putln("(void) %s(&%s, %s, __Pyx_atomic_seq_cst);" % (
+                self.atomic_function, self.lhs.result(), self.rhs.result()))
+        elif isinstance(self.lhs, ExprNodes.IndexNode) and self.lhs.is_buffer_access:
             if self.lhs.type.is_pyobject:
                 error(self.pos, "In-place operators not allowed on object buffers in this release.")
             if (c_op in ('/', '%') and self.lhs.type.is_int
@@ -4728,6 +4913,15 @@ class InPlaceAssignmentNode(AssignmentNode):
         return ExprNodes.binop_node(self.pos, self.operator, self.lhs, self.rhs)
 
 
+atomic_inplace_operators = {
+    '+': 'fetch_add',
+    '-': 'fetch_sub',
+    '&': 'fetch_and',
+    '|': 'fetch_or',
+    '^': 'fetch_xor',
+}
+
+
 class PrintStatNode(StatNode):
     #  print statement
     #
@@ -5748,19 +5942,18 @@ class ForFromStatNode(LoopNode, StatNode):
                 # We know target is a NameNode, this is the only ugly case.
                 target_node = ExprNodes.PyTempNode(self.target.pos, None)
                 target_node.allocate(code)
-                interned_cname = code.intern_identifier(self.target.entry.name)
                 if self.target.entry.scope.is_module_scope:
-                    code.globalstate.use_utility_code(
-                        UtilityCode.load_cached("GetModuleGlobalName", "ObjectHandling.c"))
-                    lookup_func = '__Pyx_GetModuleGlobalName(%s)'
+                    lookup_code = ExprNodes.module_global_lookup_code(
+                        code, self.target.entry, target_node.result())
                 else:
                     code.globalstate.use_utility_code(
                         UtilityCode.load_cached("GetNameInClass", "ObjectHandling.c"))
-                    lookup_func = '__Pyx_GetNameInClass(%s, %%s)' % (
-                        self.target.entry.scope.namespace_cname)
-                code.putln("%s = %s; %s" % (
-                    target_node.result(),
-                    lookup_func % interned_cname,
+                    lookup_code = '%s = __Pyx_GetNameInClass(%s, %s);' % (
+                        target_node.result(),
+                        self.target.entry.scope.namespace_cname,
+                        code.intern_identifier(self.target.entry.name))
+                code.putln("%s %s" % (
+                    lookup_code,
                     code.error_goto_if_null(target_node.result(), self.target.pos)))
                 code.put_gotref(target_node.result())
             else:
@@ -6681,15 +6874,14 @@ class FromCImportStatNode(StatNode):
                     local_name = as_name or name
                     env.add_imported_entry(local_name, entry, pos)
 
-        if self.module_name.startswith('cpython'): # enough for now
-            if self.module_name in utility_code_for_cimports:
+        if self.module_name in utility_code_for_cimports:
+            env.use_utility_code(UtilityCode.load_cached(
+                *utility_code_for_cimports[self.module_name]))
+        for _, name, _, _ in self.imported_names:
+            fqname = '%s.%s' % (self.module_name, name)
+            if fqname in utility_code_for_cimports:
                 env.use_utility_code(UtilityCode.load_cached(
-                    *utility_code_for_cimports[self.module_name]))
-            for _, name, _, _ in self.imported_names:
-                fqname = '%s.%s' % (self.module_name, name)
-                if fqname in utility_code_for_cimports:
-                    env.use_utility_code(UtilityCode.load_cached(
-                        *utility_code_for_cimports[fqname]))
+                    *utility_code_for_cimports[fqname]))
 
     def declaration_matches(self, entry, kind):
         if not entry.is_type:
@@ -6874,6 +7066,10 @@ class ParallelStatNode(StatNode, ParallelNode):
 
     critical_section_counter = 0
 
+    profile = False
+    profile_section = None
+    profile_section_counter = 0
+
     def __init__(self, pos, **kwargs):
         super(ParallelStatNode, self).__init__(pos, **kwargs)
 
@@ -6893,6 +7089,7 @@ class ParallelStatNode(StatNode, ParallelNode):
 
     def analyse_declarations(self, env):
         self.body.analyse_declarations(env)
+        self.profile = env.directives['parallel_profile']
 
         self.num_threads = None
 
@@ -7072,10 +7269,17 @@ class ParallelStatNode(StatNode, ParallelNode):
         code.putln("%s = %s;" % (cname, entry.cname))
         entry.cname = cname
 
+    def sorted_privates(self):
+        """
+        The items of self.privates ordered by C name, so that the generated
+        OpenMP clauses do not depend on the iteration order of the dict.
+        """
+        return sorted(self.privates.iteritems(), key=lambda item: item[0].cname)
+
     def initialize_privates_to_nan(self, code, exclude=None):
         first = True
 
-        for entry, (op, lastprivate) in self.privates.iteritems():
+        for entry, (op, lastprivate) in self.sorted_privates():
             if not op and (not exclude or entry != exclude):
                 invalid_value = entry.type.invalid_value()
 
@@ -7117,7 +7321,7 @@ class ParallelStatNode(StatNode, ParallelNode):
         """
         self.modified_entries = []
 
-        for entry in self.assignments:
+        for entry in sorted(self.assignments, key=lambda entry: entry.cname):
             if entry.from_closure or entry.in_closure:
                 self._allocate_closure_temp(code, entry)
 
@@ -7142,7 +7346,7 @@ class ParallelStatNode(StatNode, ParallelNode):
 
             self.temps = temps = code.funcstate.stop_collecting_temps()
             privates, firstprivates = [], []
-            for temp, type in temps:
+            for temp, type in sorted(temps):
                 if type.is_pyobject or type.is_memoryviewslice:
                     firstprivates.append(temp)
                 else:
@@ -7162,15 +7366,29 @@ class ParallelStatNode(StatNode, ParallelNode):
                 c.put(" shared(%s)" % ', '.join(shared_vars))
 
     def cleanup_temps(self, code):
-        # Now clean up any memoryview slice and object temporaries
+        """
+        Now clean up any memoryview slice and object temporaries. The GIL is
+        only acquired if an object temporary was left behind, i.e. if an
+        exception occurred in this thread.
+        """
         if self.is_parallel and not self.is_nested_prange:
             code.putln("/* Clean up any temporaries */")
-            for temp, type in self.temps:
+            object_temps = []
+            for temp, type in sorted(self.temps):
                 if type.is_memoryviewslice:
                     code.put_xdecref_memoryviewslice(temp, have_gil=False)
                 elif type.is_pyobject:
+                    object_temps.append((temp, type))
+
+            if object_temps:
+                code.putln("if (%s) {" % " || ".join(
+                                        [temp for temp, type in object_temps]))
+                code.put_ensure_gil()
+                for temp, type in object_temps:
                     code.put_xdecref(temp, type)
                     code.putln("%s = NULL;" % temp)
+                code.put_release_ensured_gil()
+                code.putln("}")
 
     def setup_parallel_control_flow_block(self, code):
         """
@@ -7187,11 +7405,10 @@ class ParallelStatNode(StatNode, ParallelNode):
                 goto end_parallel;
 
             new_return_label:
-                why = 3;
+                why = 3; # an atomic store
                 goto end_parallel;
 
             end_parallel:;
-                #pragma omp flush(why) # we need to flush for every iteration
             }
 
             if (why == 3)
@@ -7208,48 +7425,163 @@ class ParallelStatNode(StatNode, ParallelNode):
         self.begin_of_parallel_control_block_point_after_decls = code.insertion_point()
 
         self.undef_builtin_expect_apple_gcc_bug(code)
+        self.begin_profile_section(code)
+
+    def begin_profile_section(self, code):
+        """
+        With the parallel_profile directive, each parallel section gets a
+        static __Pyx_ParallelProfileSection that is registered at module
+        initialization. The thread that starts an OpenMP parallel section
+        measures its wall time, all threads record their iterations, chunks,
+        busy time and time spent waiting at the closing barrier.
+
+        Closely nested pranges are executed sequentially and are accounted
+        to the outer prange.
+        """
+        if not self.profile or self.is_nested_prange:
+            return
+
+        import ExprNodes
+        for op in ('load', 'store', 'fetch_add'):
+            for value_type in (PyrexTypes.c_longlong_type, PyrexTypes.c_double_type):
+                ExprNodes.atomic_op_function(code.globalstate, op, value_type)
+        for op in ('load', 'store', 'compare_exchange'):
+            ExprNodes.atomic_op_function(code.globalstate, op, PyrexTypes.c_int_type)
+        code.globalstate.use_utility_code(parallel_profile_utility_code)
+
+        cname = "%s%d" % (Naming.parallel_profile_section_prefix,
+                          ParallelStatNode.profile_section_counter)
+        ParallelStatNode.profile_section_counter += 1
+        self.profile_section = cname
+
+        if self.is_prange:
+            kind = "prange"
+        else:
+            kind = "parallel"
+
+        code.globalstate['decls'].putln(
+            "static __Pyx_ParallelProfileSection %s;" % cname)
+        code.globalstate['init_globals'].putln(
+            '__Pyx_ParallelProfile_Register(&%s, %s[%d], %d, "%s");' % (
+                cname, Naming.filetable_cname,
+                code.lookup_filename(self.pos[0]), self.pos[1], kind))
+
+        if self.is_parallel:
+            self.begin_of_parallel_control_block_point.putln(
+                "double %s;" % Naming.parallel_profile_start)
+            code.putln("%s = __Pyx_ParallelProfile_Now();" %
+                                            Naming.parallel_profile_start)
+
+    def end_profile_section(self, code):
+        """
+        Record the wall time of the parallel section. Call this after the
+        OpenMP parallel section.
+        """
+        if self.profile_section and self.is_parallel:
+            code.putln("__Pyx_ParallelProfile_EndSection(&%s, %s);" % (
+                self.profile_section, Naming.parallel_profile_start))
+
+    def begin_profile_thread(self, code, index_type=None):
+        """
+        Start a block with the thread-private profiling counters. This must
+        be called inside the OpenMP parallel section.
+        """
+        if not self.profile_section:
+            return
+
+        code.begin_block() # profile block
+        code.putln("double %s, %s;" % (Naming.parallel_profile_t0,
+                                       Naming.parallel_profile_t1))
+        if index_type is not None:
+            code.putln("PY_LONG_LONG %s = 0, %s = 0;" % (
+                Naming.parallel_profile_iterations,
+                Naming.parallel_profile_chunks))
+            code.putln("%s = 0;" % index_type.declaration_code(
+                Naming.parallel_profile_last))
+        code.putln("%s = __Pyx_ParallelProfile_Now();" %
+                                            Naming.parallel_profile_t0)
+
+    def count_profile_iteration(self, code, index):
+        """
+        Count the iterations of a worksharing loop executed by this thread. A
+        new chunk starts whenever the iteration does not directly follow the
+        previous one.
+        """
+        if not self.profile_section:
+            return
+
+        fmt_dict = {
+            'iterations': Naming.parallel_profile_iterations,
+            'chunks': Naming.parallel_profile_chunks,
+            'last': Naming.parallel_profile_last,
+            'i': index,
+        }
+        code.putln("if (!%(iterations)s || %(i)s != %(last)s + 1) "
+                   "%(chunks)s++;" % fmt_dict)
+        code.putln("%(last)s = %(i)s; %(iterations)s++;" % fmt_dict)
+
+    def end_profile_thread(self, code, count_iterations=False):
+        """
+        Measure the time this thread waits for the others at an explicit
+        barrier and record the statistics of the thread.
+        """
+        if not self.profile_section:
+            return
+
+        if count_iterations:
+            counts = (Naming.parallel_profile_iterations,
+                      Naming.parallel_profile_chunks)
+        else:
+            counts = ('0', '0')
+
+        code.putln("%s = __Pyx_ParallelProfile_Now();" %
+                                            Naming.parallel_profile_t1)
+        code.putln_openmp("#pragma omp barrier")
+        code.putln(
+            "__Pyx_ParallelProfile_RecordThread(&%s, %s, %s, %s - %s, "
+            "__Pyx_ParallelProfile_Now() - %s);" % (
+                (self.profile_section,) + counts +
+                (Naming.parallel_profile_t1, Naming.parallel_profile_t0,
+                 Naming.parallel_profile_t1)))
+        code.end_block() # end profile block
 
     def begin_parallel_block(self, code):
         """
         Each OpenMP thread in a parallel section that contains a with gil block
-        must have the thread-state initialized. The call to
-        PyGILState_Release() then deallocates our threadstate. If we wouldn't
-        do this, each with gil block would allocate and deallocate one, thereby
-        losing exception information before it can be saved before leaving the
+        must have the thread-state initialized. If we wouldn't do this, each
+        with gil block would allocate and deallocate one, thereby losing
+        exception information before it can be saved before leaving the
         parallel section.
         """
         self.begin_of_parallel_block = code.insertion_point()
 
     def end_parallel_block(self, code):
         """
-        To ensure all OpenMP threads have thread states, we ensure the GIL
-        in each thread (which creates a thread state if it doesn't exist),
-        after which we release the GIL.
-        On exit, reacquire the GIL and release the thread state.
-
-        If compiled without OpenMP support (at the C level), then we still have
-        to acquire the GIL to decref any object temporaries.
+        To ensure all OpenMP threads have thread states, the threads that have
+        none create one on entry and delete it again on exit. The threads
+        that already have a thread state, like the one that started the
+        parallel section, only acquire the GIL when an exception needs to be
+        saved or object temporaries need to be cleaned up.
         """
         if self.error_label_used:
-            begin_code = self.begin_of_parallel_block
-            end_code = code
+            code.globalstate.use_utility_code(
+                UtilityCode.load_cached("ParallelThreadState", "Parallel.c"))
 
-            begin_code.putln("#ifdef _OPENMP")
-            begin_code.put_ensure_gil(declare_gilstate=True)
-            begin_code.putln("Py_BEGIN_ALLOW_THREADS")
+            begin_code = self.begin_of_parallel_block
+            begin_code.putln("#if defined(_OPENMP) && defined(WITH_THREAD)")
+            begin_code.putln("PyGILState_STATE %s = PyGILState_UNLOCKED;" %
+                                                    Naming.parallel_gilstate)
+            begin_code.putln(
+                "int %s = __Pyx_Parallel_EnsureThreadState(&%s);" % (
+                    Naming.parallel_thread_state, Naming.parallel_gilstate))
             begin_code.putln("#endif /* _OPENMP */")
 
-            end_code.putln("#ifdef _OPENMP")
-            end_code.putln("Py_END_ALLOW_THREADS")
-            end_code.putln("#else")
-            end_code.put_safe("{\n")
-            end_code.put_ensure_gil()
-            end_code.putln("#endif /* _OPENMP */")
-            self.cleanup_temps(end_code)
-            end_code.put_release_ensured_gil()
-            end_code.putln("#ifndef _OPENMP")
-            end_code.put_safe("}\n")
-            end_code.putln("#endif /* _OPENMP */")
+            self.cleanup_temps(code)
+
+            code.putln("#if defined(_OPENMP) && defined(WITH_THREAD)")
+            code.putln("__Pyx_Parallel_ReleaseThreadState(%s, %s);" % (
+                Naming.parallel_thread_state, Naming.parallel_gilstate))
+            code.putln("#endif /* _OPENMP */")
 
     def trap_parallel_exit(self, code, should_flush=False):
         """
@@ -7299,7 +7631,11 @@ class ParallelStatNode(StatNode, ParallelNode):
                     self.error_label_used = True
                     self.fetch_parallel_exception(code)
 
-                code.putln("%s = %d;" % (Naming.parallel_why, i + 1))
+                self.put_store_parallel_why(code, i + 1)
+                if should_flush:
+                    # The other threads pick up the new value in the guard
+                    # around the loop body
+                    code.putln("%s = %d;" % (Naming.parallel_why_local, i + 1))
 
             if (self.breaking_label_used and self.is_prange and not
                     is_continue_label):
@@ -7315,8 +7651,17 @@ class ParallelStatNode(StatNode, ParallelNode):
 
             code.put_label(dont_return_label)
 
-            if should_flush and self.breaking_label_used:
-                code.putln_openmp("#pragma omp flush(%s)" % Naming.parallel_why)
+    def put_store_parallel_why(self, code, why):
+        """
+        Other threads of the team may read or write the control flow
+        variable at the same time, the end of the parallel section makes
+        the final value visible to the master thread.
+        """
+        import ExprNodes
+        store = ExprNodes.atomic_op_function(
+            code.globalstate, 'store', PyrexTypes.c_int_type)
+        code.putln("%s(&%s, %d, __Pyx_atomic_relaxed);" % (
+            store, Naming.parallel_why, why))
 
     def save_parallel_vars(self, code):
         """
@@ -7337,7 +7682,7 @@ class ParallelStatNode(StatNode, ParallelNode):
         c = self.begin_of_parallel_control_block_point
 
         temp_count = 0
-        for entry, (op, lastprivate) in self.privates.iteritems():
+        for entry, (op, lastprivate) in self.sorted_privates():
             if not lastprivate or entry.type.is_pyobject:
                 continue
 
@@ -7389,18 +7734,28 @@ class ParallelStatNode(StatNode, ParallelNode):
 
                 deallocate threadstate  deallocate threadstate
         """
+        import ExprNodes
+        compare_exchange = ExprNodes.atomic_op_function(
+            code.globalstate, 'compare_exchange', py_object_type)
+
         code.begin_block()
+        code.putln("PyObject *__pyx_exc_type, *__pyx_exc_value, *__pyx_exc_tb, *__pyx_no_exc = NULL;")
         code.put_ensure_gil(declare_gilstate=True)
 
-        code.putln_openmp("#pragma omp flush(%s)" % Naming.parallel_exc_type)
+        # The first thread that stores its exception type in the shared
+        # slot saves its exception, the others discard theirs
+        code.putln("__Pyx_ErrFetch(&__pyx_exc_type, &__pyx_exc_value, &__pyx_exc_tb);")
         code.putln(
-            "if (!%s) {" % Naming.parallel_exc_type)
-
-        code.putln("__Pyx_ErrFetch(&%s, &%s, &%s);" % self.parallel_exc)
+            "if (__pyx_exc_type && %s(&%s, &__pyx_no_exc, __pyx_exc_type, __Pyx_atomic_acq_rel)) {" % (
+                compare_exchange, Naming.parallel_exc_type))
+        code.putln("%s = __pyx_exc_value; %s = __pyx_exc_tb;" % self.parallel_exc[1:])
         pos_info = chain(*zip(self.parallel_pos_info, self.pos_info))
         code.putln("%s = %s; %s = %s; %s = %s;" % tuple(pos_info))
         code.putln('__Pyx_GOTREF(%s);' % Naming.parallel_exc_type)
 
+        code.putln(
+            "} else {")
+        code.putln("Py_XDECREF(__pyx_exc_type); Py_XDECREF(__pyx_exc_value); Py_XDECREF(__pyx_exc_tb);")
         code.putln(
             "}")
 
@@ -7543,7 +7898,7 @@ class ParallelWithBlockNode(ParallelStatNode):
         code.put("#pragma omp parallel ")
 
         if self.privates:
-            privates = [e.cname for e in self.privates
+            privates = [e.cname for e, _ in self.sorted_privates()
                                     if not e.type.is_pyobject]
             code.put('private(%s)' % ', '.join(privates))
 
@@ -7556,12 +7911,14 @@ class ParallelWithBlockNode(ParallelStatNode):
         code.begin_block() # parallel block
         self.begin_parallel_block(code)
         self.initialize_privates_to_nan(code)
+        self.begin_profile_thread(code)
         code.funcstate.start_collecting_temps()
-        self.body.generate_execution_code(code)
-        self.trap_parallel_exit(code)
+        self.generate_parallel_body(code)
+        self.end_profile_thread(code)
         self.privatize_temps(code)
         self.end_parallel_block(code)
         code.end_block() # end parallel block
+        self.end_profile_section(code)
 
         continue_ = code.label_used(code.continue_label)
         break_ = code.label_used(code.break_label)
@@ -7571,6 +7928,118 @@ class ParallelWithBlockNode(ParallelStatNode):
                                              continue_=continue_)
         self.release_closure_privates(code)
 
+    def generate_parallel_body(self, code):
+        self.body.generate_execution_code(code)
+        self.trap_parallel_exit(code)
+
+
+class ParallelSectionsNode(ParallelWithBlockNode):
+    """
+    This node represents a 'with cython.parallel.sections():' block. The body
+    consists of 'with cython.parallel.section():' blocks, which are executed
+    concurrently by the threads of the team, each section by one thread:
+
+        #pragma omp parallel
+        {
+            #pragma omp sections
+            {
+                #pragma omp section
+                { ... }
+                #pragma omp section
+                { ... }
+            }
+        }
+
+    Control may not leave a section through a goto, so every section traps
+    break, continue, return and exceptions itself.
+    """
+
+    def analyse_declarations(self, env):
+        super(ParallelSectionsNode, self).analyse_declarations(env)
+
+        if isinstance(self.body, StatListNode):
+            stats = self.body.stats
+        else:
+            stats = [self.body]
+
+        for stat in stats:
+            if not isinstance(stat, (ParallelSectionNode, PassStatNode)):
+                error(stat.pos, "Only cython.parallel.section() blocks are "
+                                "allowed in a cython.parallel.sections() block")
+                break
+
+    def generate_parallel_body(self, code):
+        any_label_used = breaking_label_used = error_label_used = False
+        section_labels = code.get_all_labels()
+
+        code.putln_openmp("#pragma omp sections")
+        code.begin_block() # sections block
+
+        for stat in self.body.stats:
+            if not isinstance(stat, ParallelSectionNode):
+                continue
+
+            code.putln_openmp("#pragma omp section")
+            code.begin_block() # section block
+
+            # new labels for every section, as they are placed inside it
+            code.all_new_labels()
+
+            stat.generate_execution_code(code)
+            self.trap_parallel_exit(code)
+
+            for label, section_label in zip(code.get_all_labels(),
+                                            section_labels):
+                if code.label_used(label):
+                    code.use_label(section_label)
+
+            any_label_used = any_label_used or self.any_label_used
+            breaking_label_used = (breaking_label_used or
+                                   self.breaking_label_used)
+            error_label_used = error_label_used or self.error_label_used
+
+            code.set_all_labels(section_labels)
+            code.end_block() # end section block
+
+        code.end_block() # end sections block
+
+        self.any_label_used = any_label_used
+        self.breaking_label_used = breaking_label_used
+        self.error_label_used = error_label_used
+
+
+class ParallelSectionNode(StatNode):
+    """
+    This node represents a 'with cython.parallel.section():' block, which
+    may only be used directly in a 'with cython.parallel.sections():' block.
+    Code generation is driven by the ParallelSectionsNode.
+    """
+
+    child_attrs = ['body']
+
+    body = None
+    args = None
+    kwargs = None
+
+    def analyse_declarations(self, env):
+        if self.args or self.kwargs:
+            error(self.pos, "cython.parallel.section() does not take "
+                            "arguments")
+        self.body.analyse_declarations(env)
+
+    def analyse_expressions(self, env):
+        self.body = self.body.analyse_expressions(env)
+        return self
+
+    def generate_function_definitions(self, env, code):
+        self.body.generate_function_definitions(env, code)
+
+    def generate_execution_code(self, code):
+        self.body.generate_execution_code(code)
+
+    def annotate(self, code):
+        self.body.annotate(code)
+
 
 class ParallelRangeNode(ParallelStatNode):
     """
@@ -7591,8 +8060,17 @@ class ParallelRangeNode(ParallelStatNode):
 
     nogil = None
     schedule = None
+    simd = False
+    safelen = None
+
+    adaptive_schedule_counter = 0
+
+    # after a break, return or exception, the other threads skip the
+    # remaining iterations within this many iterations
+    stop_check_interval = 64
 
-    valid_keyword_arguments = ['schedule', 'nogil', 'num_threads', 'chunksize']
+    valid_keyword_arguments = ['schedule', 'nogil', 'num_threads', 'chunksize',
+                               'simd', 'safelen']
 
     def __init__(self, pos, **kwds):
         super(ParallelRangeNode, self).__init__(pos, **kwds)
@@ -7620,10 +8098,16 @@ class ParallelRangeNode(ParallelStatNode):
             self.schedule = self.schedule.decode('ascii')
 
         if self.schedule not in (None, 'static', 'dynamic', 'guided',
-                                 'runtime'):
+                                 'runtime', 'adaptive'):
             error(self.pos, "Invalid schedule argument to prange: %s" %
                                                         (self.schedule,))
 
+        if self.safelen is not None:
+            if not isinstance(self.safelen, (int, long)) or self.safelen <= 0:
+                error(self.pos, "safelen must be a positive integer constant")
+            elif not self.simd:
+                error(self.pos, "Must provide simd=True with safelen")
+
     def analyse_expressions(self, env):
         was_nogil = env.nogil
         if self.nogil:
@@ -7688,9 +8172,9 @@ class ParallelRangeNode(ParallelStatNode):
             if not node.schedule:
                 error(node.chunksize.pos,
                       "Must provide schedule with chunksize")
-            elif node.schedule == 'runtime':
+            elif node.schedule in ('runtime', 'adaptive'):
                 error(node.chunksize.pos,
-                      "Chunksize not valid for the schedule runtime")
+                      "Chunksize not valid for the schedule %s" % node.schedule)
             elif (node.chunksize.type.is_int and
                   node.chunksize.is_literal and
                   node.chunksize.compile_time_value(env) <= 0):
@@ -7699,6 +8183,10 @@ class ParallelRangeNode(ParallelStatNode):
             node.chunksize = node.chunksize.coerce_to(
                 PyrexTypes.c_int_type, env).coerce_to_temp(env)
 
+        if node.schedule == 'adaptive' and not node.is_parallel:
+            error(node.pos, "The schedule adaptive is not supported for "
+                            "prange() in a parallel() block")
+
         if node.nogil:
             env.nogil = was_nogil
 
@@ -7808,8 +8296,11 @@ class ParallelRangeNode(ParallelStatNode):
         # target index uninitialized
         code.putln("if (%(nsteps)s > 0)" % fmt_dict)
         code.begin_block() # if block
+        self.begin_adaptive_schedule(code, fmt_dict)
         self.generate_loop(code, fmt_dict)
+        self.end_adaptive_schedule(code)
         code.end_block() # end if block
+        self.end_profile_section(code)
 
         self.restore_labels(code)
 
@@ -7838,6 +8329,10 @@ class ParallelRangeNode(ParallelStatNode):
         self.release_closure_privates(code)
 
     def generate_loop(self, code, fmt_dict):
+        if not self.is_parallel:
+            self.begin_profile_thread(code, self.index_type)
+            stop_check_block_point = code.insertion_point()
+
         if self.is_nested_prange:
             code.putln("#if 0")
         else:
@@ -7845,6 +8340,7 @@ class ParallelRangeNode(ParallelStatNode):
 
         if not self.is_parallel:
             code.put("#pragma omp for")
+            self.simd_insertion_point = code.insertion_point()
             self.privatization_insertion_point = code.insertion_point()
             reduction_codepoint = self.parent.privatization_insertion_point
         else:
@@ -7858,14 +8354,17 @@ class ParallelRangeNode(ParallelStatNode):
 
             # Initialize the GIL if needed for this thread
             self.begin_parallel_block(code)
+            self.begin_profile_thread(code, self.index_type)
+            stop_check_block_point = code.insertion_point()
 
             if self.is_nested_prange:
                 code.putln("#if 0")
             else:
                 code.putln("#ifdef _OPENMP")
             code.put("#pragma omp for")
+            self.simd_insertion_point = code.insertion_point()
 
-        for entry, (op, lastprivate) in self.privates.iteritems():
+        for entry, (op, lastprivate) in self.sorted_privates():
             # Don't declare the index variable as a reduction
             if op and op in "+*-&^|" and entry != self.target.entry:
                 if entry.type.is_pyobject:
@@ -7896,7 +8395,16 @@ class ParallelRangeNode(ParallelStatNode):
             else:
                 chunksize = ""
 
-            code.put(" schedule(%s%s)" % (self.schedule, chunksize))
+            if self.schedule == 'adaptive':
+                schedule = 'runtime'
+            else:
+                schedule = self.schedule
+
+            code.put(" schedule(%s%s)" % (schedule, chunksize))
+
+        if self.profile_section:
+            # the implicit barrier is made explicit to measure the wait time
+            code.put(" nowait")
 
         self.put_num_threads(reduction_codepoint)
 
@@ -7905,6 +8413,7 @@ class ParallelRangeNode(ParallelStatNode):
 
         code.put("for (%(i)s = 0; %(i)s < %(nsteps)s; %(i)s++)" % fmt_dict)
         code.begin_block() # for loop block
+        self.count_profile_iteration(code, fmt_dict['i'])
 
         guard_around_body_codepoint = code.insertion_point()
 
@@ -7921,20 +8430,248 @@ class ParallelRangeNode(ParallelStatNode):
         self.body.generate_execution_code(code)
         self.trap_parallel_exit(code, should_flush=True)
         self.privatize_temps(code)
+        self.put_simd(self.simd_insertion_point)
 
         if self.breaking_label_used:
             # Put a guard around the loop body in case return, break or
-            # exceptions might be used
-            guard_around_body_codepoint.putln("if (%s < 2)" % Naming.parallel_why)
+            # exceptions might be used. Each thread keeps a private copy of
+            # the control flow variable and only rereads the shared one
+            # every stop_check_interval iterations.
+            import ExprNodes
+            load = ExprNodes.atomic_op_function(
+                code.globalstate, 'load', PyrexTypes.c_int_type)
+            fmt_dict['why'] = Naming.parallel_why
+            fmt_dict['why_local'] = Naming.parallel_why_local
+            fmt_dict['load'] = load
+            fmt_dict['mask'] = self.stop_check_interval - 1
+            stop_check_block_point.putln("{")
+            stop_check_block_point.putln(
+                "int %(why_local)s = 0;" % fmt_dict)
+            guard_around_body_codepoint.putln(
+                "if (!(%(i)s & %(mask)d) && %(why_local)s < 2) "
+                "%(why_local)s = %(load)s(&%(why)s, __Pyx_atomic_relaxed);" % fmt_dict)
+            guard_around_body_codepoint.putln(
+                "if (%(why_local)s < 2)" % fmt_dict)
 
         code.end_block() # end guard around loop body
         code.end_block() # end for loop block
+        if self.breaking_label_used:
+            code.putln("}")
+        self.end_profile_thread(code, count_iterations=True)
 
         if self.is_parallel:
             # Release the GIL and deallocate the thread state
             self.end_parallel_block(code)
             code.end_block() # pragma omp parallel end block
 
+    def begin_adaptive_schedule(self, code, fmt_dict):
+        """
+        schedule='adaptive' runs the loop with schedule(runtime), after
+        selecting the schedule and chunk size through omp_set_schedule() from
+        the timings of previous executions of this prange. The history is kept
+        in static storage for each prange. The runtime schedule of the calling
+        thread is restored afterwards.
+        """
+        if self.schedule != 'adaptive' or self.is_nested_prange:
+            return
+
+        code.globalstate.use_utility_code(
+            UtilityCode.load_cached("AdaptiveSchedule", "Parallel.c"))
+
+        self.adaptive_schedule_cname = "%s%d" % (
+            Naming.parallel_adaptive_schedule_prefix,
+            ParallelRangeNode.adaptive_schedule_counter)
+        ParallelRangeNode.adaptive_schedule_counter += 1
+
+        code.globalstate['decls'].putln("static __Pyx_AdaptiveSchedule %s;" %
+                                                self.adaptive_schedule_cname)
+        code.putln("__Pyx_AdaptiveScheduleCall %s;" % Naming.parallel_adaptive_call)
+        code.putln("__Pyx_AdaptiveSchedule_Begin(&%s, &%s, (double) %s);" % (
+            self.adaptive_schedule_cname, Naming.parallel_adaptive_call,
+            fmt_dict['nsteps']))
+
+    def end_adaptive_schedule(self, code):
+        if self.schedule != 'adaptive' or self.is_nested_prange:
+            return
+
+        code.putln("__Pyx_AdaptiveSchedule_End(&%s, &%s);" % (
+            self.adaptive_schedule_cname, Naming.parallel_adaptive_call))
+
+    def put_simd(self, code):
+        """
+        Turn the worksharing loop into a 'for simd' loop. The simd
+        construct is only understood by OpenMP 4.0 and later, so it is hidden
+        behind a macro that expands to nothing for older implementations.
+
+        The loop body of a simd construct must not contain the exception
+        and break propagation code (which uses critical sections and
+        flushes), so we only vectorize loops that don't need it.
+        """
+        if not self.simd:
+            return
+
+        if self.breaking_label_used:
+            warning(self.pos, "prange() body may exit the loop through "
+                              "break, return or an exception, not vectorizing",
+                    level=1)
+            return
+
+        code.globalstate.use_utility_code(
+            UtilityCode.load_cached("OpenMPSimd", "ModuleSetupCode.c"))
+        code.put(" __PYX_OMP_SIMD")
+        if self.safelen is not None:
+            code.put(" __PYX_OMP_SIMD_CLAUSE(safelen(%d))" % self.safelen)
+
+
+class SimdRangeNode(ParallelRangeNode):
+    """
+    This node represents a 'for i in cython.parallel.simd():' loop. It is
+    a sequential loop that is annotated with '#pragma omp simd'. It shares
+    the privatization and reduction analysis with prange(), but does not
+    start a thread team and may be used with the GIL held.
+
+    The pragma is only emitted if the loop body turns out to be a
+    structured block, i.e. it does not break, return or propagate
+    exceptions out of the loop.
+    """
+
+    child_attrs = ['body', 'target', 'else_clause', 'args']
+
+    valid_keyword_arguments = ['safelen']
+
+    simd = True
+
+    def nogil_check(self, env):
+        # Start, stop and step are verified to be numeric by
+        # analyse_expressions(), no GIL is needed for the loop itself
+        pass
+
+    def generate_execution_code(self, code):
+        self.declare_closure_privates(code)
+
+        fmt_dict = {
+            'target': self.target.entry.cname,
+        }
+
+        start_stop_step = self.start, self.stop, self.step
+        defaults = '0', '0', '1'
+        for node, name, default in zip(start_stop_step, self.names, defaults):
+            if node is None:
+                result = default
+            elif node.is_literal:
+                result = node.get_constant_c_result_code()
+            else:
+                node.generate_evaluation_code(code)
+                result = node.result()
+
+            fmt_dict[name] = result
+
+        fmt_dict['i'] = code.funcstate.allocate_temp(self.index_type, False)
+        fmt_dict['nsteps'] = code.funcstate.allocate_temp(self.index_type, False)
+
+        code.putln("if (%(step)s == 0) abort();" % fmt_dict)
+        code.putln("%(nsteps)s = (%(stop)s - %(start)s) / %(step)s;" % fmt_dict)
+
+        old_loop_labels = code.new_loop_labels()
+        old_error_label = code.new_error_label()
+        old_return_label = code.return_label
+        code.return_label = code.new_label(name="return")
+
+        code.putln("if (%(nsteps)s > 0)" % fmt_dict)
+        code.begin_block() # if block
+        pragma_codepoint = code.insertion_point()
+
+        code.put("for (%(i)s = 0; %(i)s < %(nsteps)s; %(i)s++)" % fmt_dict)
+        code.begin_block() # for loop block
+        code.putln("%(target)s = %(start)s + %(step)s * %(i)s;" % fmt_dict)
+        self.initialize_privates_to_nan(code, exclude=self.target.entry)
+
+        code.funcstate.start_collecting_temps()
+        self.body.generate_execution_code(code)
+        temps = code.funcstate.stop_collecting_temps()
+        if code.funcstate.collect_temps_stack:
+            # make them visible to an enclosing prange()
+            code.funcstate.collect_temps_stack[-1].update(temps)
+
+        if code.label_used(code.continue_label):
+            code.put_label(code.continue_label)
+        code.end_block() # end for loop block
+        code.end_block() # end if block
+
+        break_label = code.break_label
+        exit_labels = [(code.return_label, old_return_label),
+                       (code.error_label, old_error_label)]
+        used_exit_labels = [(label, old_label)
+                            for label, old_label in exit_labels
+                            if code.label_used(label)]
+
+        if used_exit_labels or code.label_used(break_label):
+            warning(self.pos, "simd loop body may exit the loop through "
+                              "break, return or an exception, not vectorizing",
+                    level=1)
+        else:
+            self.put_simd_pragma(pragma_codepoint, temps)
+
+        if used_exit_labels:
+            skip_label = code.new_label()
+            code.put_goto(skip_label)
+            for label, old_label in used_exit_labels:
+                code.put_label(label)
+                code.put_goto(old_label)
+            code.put_label(skip_label)
+
+        code.set_all_labels(old_loop_labels + (old_return_label,
+                                               old_error_label))
+
+        if self.else_clause:
+            code.putln("/* else */")
+            code.begin_block() # else block
+            self.else_clause.generate_execution_code(code)
+            code.end_block() # end else block
+
+        if code.label_used(break_label):
+            code.put_label(break_label)
+
+        for temp in start_stop_step:
+            if temp is not None:
+                temp.generate_disposal_code(code)
+                temp.free_temps(code)
+
+        code.funcstate.release_temp(fmt_dict['i'])
+        code.funcstate.release_temp(fmt_dict['nsteps'])
+
+        self.release_closure_privates(code)
+
+    def put_simd_pragma(self, code, temps):
+        """
+        Write the '#pragma omp simd' line. Variables assigned to in the loop
+        body are lastprivate (or reductions), as for prange(). Temporaries
+        are private to each SIMD lane.
+        """
+        code.putln("#if defined(_OPENMP) && _OPENMP >= 201307")
+        code.put("#pragma omp simd")
+
+        for entry, (op, lastprivate) in self.sorted_privates():
+            if entry.type.is_pyobject:
+                continue
+            if op and op in "+*-&^|" and entry != self.target.entry:
+                code.put(" reduction(%s:%s)" % (op, entry.cname))
+            elif entry == self.target.entry or lastprivate:
+                code.put(" lastprivate(%s)" % entry.cname)
+            else:
+                code.put(" private(%s)" % entry.cname)
+
+        privates = [temp for temp, type in temps
+                    if not (type.is_pyobject or type.is_memoryviewslice)]
+        if privates:
+            code.put(" private(%s)" % ", ".join(sorted(privates)))
+
+        if self.safelen is not None:
+            code.put(" safelen(%d)" % self.safelen)
+
+        code.putln("")
+        code.putln("#endif")
+
 
 class CnameDecoratorNode(StatNode):
     """
@@ -8056,6 +8793,14 @@ else:
 
 #------------------------------------------------------------------------------------
 
+def put_parallel_profile_init(code, pos):
+    # exports __pyx_parallel_profile__() and registers the atexit dump
+    code.putln("if (unlikely(__Pyx_ParallelProfile_Init(%s) < 0)) %s" % (
+        Naming.module_cname, code.error_goto(pos)))
+
+parallel_profile_utility_code = UtilityCode.load(
+    "ParallelProfile", "Parallel.c", init=put_parallel_profile_init)
+
 printing_utility_code = UtilityCode.load_cached("Print", "Printing.c")
 printing_one_utility_code = UtilityCode.load_cached("PrintOne", "Printing.c")
 
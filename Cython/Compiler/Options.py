@@ -102,6 +102,10 @@ directive_defaults = {
     'c_string_type': 'bytes',
     'c_string_encoding': '',
     'type_version_tag': True,   # enables Py_TPFLAGS_HAVE_VERSION_TAG on extension types
+    'parallel_profile': False,  # record per-thread statistics of parallel sections
+    'infer_nogil': False,  # declare cdef functions nogil and release the GIL around loops where possible
+    'infer_nogil_loop_cost': 10000,  # minimum estimated cost of a loop to release the GIL around it
+    'frozen_globals': False,  # look up module globals only once after the module init function
 
     # set __file__ and/or __path__ to known source/target path at import time (instead of not having them available)
     'set_initial_path' : None,  # SOURCEFILE or "/full/path/to/module"
@@ -220,6 +224,7 @@ directive_scopes = { # defaults to available everywhere
     'c_string_type': ('module',),
     'c_string_encoding': ('module',),
     'type_version_tag': ('module', 'cclass'),
+    'frozen_globals': ('module',),
 }
 
 def parse_directive_value(name, value, relaxed_bool=False):
@@ -0,0 +1,517 @@
+#
+#   Parallel code generation of the module level functions
+#
+#   With the function_jobs option, the C code of the top level
+#   statements of a module (its functions and classes) is generated by
+#   forked worker processes once the whole module has been analysed.
+#   Worker n generates every n-th statement and records what each of
+#   them does to the state that the statements share: the constants,
+#   the utility code, the filename table, the writes to the global
+#   parts of the C file and the utility code of the module scope.
+#
+#   The main process then goes through the statements in their order
+#   and replays the recording of each one on its own global state, as
+#   if it had generated the code itself.  The constants and filename
+#   indexes that a worker creates get numbers from a separate range, and
+#   are renamed to those of the main process, so that the C file is the
+#   same as the one of a serial run.
+#
+#   A statement is generated again by the main process if its recording
+#   cannot be replayed exactly, i.e. if it reported errors or warnings,
+#   depended on code state that a statement of another worker changed,
+#   or refers to new objects that cannot be pickled.
+#
+
+import os
+import re
+import gc
+import sys
+import tempfile
+
+try:
+    import cPickle as pickle
+except ImportError:
+    import pickle
+
+try:
+    from cStringIO import StringIO
+except ImportError:
+    from StringIO import StringIO
+
+# the pickled units are bytes, also in Python 3
+if sys.version_info[0] >= 3:
+    from io import BytesIO
+else:
+    BytesIO = StringIO
+
+import Code
+import Errors
+import ExprNodes
+import Naming
+import Nodes
+import Symtab
+import PyrexTypes
+from Scanning import SourceDescriptor
+
+# the names of worker n are numbered from (n+1) * name_range on
+name_range = 10 ** 9
+
+placeholder_cname = re.compile(r'\b%s[A-Za-z0-9_]*?\d{10,}\b' % Naming.pyrex_prefix)
+placeholder_filename = re.compile(r'\b%s\[(\d{10,})\]' % re.escape(Naming.filetable_cname))
+
+# the global state methods whose calls are replayed
+recorded_methods = [
+    'add_cached_builtin_decl',
+    'get_int_const',
+    'get_py_const',
+    'get_string_const',
+    'get_pyunicode_ptr_const',
+    'get_py_string_const',
+    'get_interned_identifier',
+    ]
+
+# objects of these classes that exist before the fork are passed by
+# reference, new ones are only passed (by value) if they are utility code
+shared_classes = (Code.UtilityCodeBase, Symtab.Entry, Symtab.Scope,
+                  PyrexTypes.BaseType, SourceDescriptor,
+                  ExprNodes.ExprNode, Nodes.CArgDeclNode)
+
+# node attributes that are set while generating the code of a function
+# and read by the module code, e.g. the names of constant literals
+recorded_attributes = [
+    (ExprNodes.ExprNode, 'result_code'),
+    (ExprNodes.DefaultLiteralArgNode, 'evaluated'),
+    (Nodes.CArgDeclNode, 'default_value'),
+    ]
+
+# class level counters that name global C code, a unit that uses them
+# is generated by the main process
+global_counters = [
+    (Nodes.ParallelStatNode, 'profile_section_counter'),
+    (Nodes.ParallelStatNode, 'critical_section_counter'),
+    (Nodes.ParallelRangeNode, 'adaptive_schedule_counter'),
+    ]
+
+# the formatting state of a writer that its output depends on
+writer_fields = ('level', 'bol', 'call_level', 'marker')
+line_fields = ('last_marker_line', 'source_desc')
+
+
+def start(units, env, code, jobs, new_writer):
+    """
+    Start generating the code of the units, a list of (node, directives)
+    pairs, in 'jobs' worker processes.  Returns None if the code cannot
+    be generated in parallel.
+    """
+    if jobs < 2 or len(units) < 2 or not hasattr(os, 'fork'):
+        return None
+    function_jobs = FunctionJobs(units, env, code, new_writer)
+    function_jobs.start(min(jobs, len(units)))
+    return function_jobs
+
+
+def result_names(result):
+    # the names of a constant (or filename index) that end up in the code
+    if result is None:
+        return []
+    elif isinstance(result, (basestring, int, long)):
+        return [result]
+    else:
+        return [result.cname]
+
+
+def writer_state(writer, line_state):
+    state = [getattr(writer, name) for name in writer_fields]
+    if line_state:
+        state.extend([getattr(writer, name) for name in line_fields])
+    return tuple(state)
+
+
+def funcstate_counters(writer):
+    funcstate = writer.funcstate
+    if funcstate is None:
+        return None
+    return (funcstate.label_counter, funcstate.temp_counter,
+            len(funcstate.temps_allocated), funcstate.error_label)
+
+
+def global_counter_values():
+    return [getattr(cls, name) for cls, name in global_counters]
+
+
+class Unsafe(Exception):
+    pass
+
+
+class Recorder(object):
+    """
+    Records the effects of generating the code of a unit on the global
+    state in a worker process.
+    """
+
+    def __init__(self, globalstate, env, base, shared_ids):
+        self.globalstate = globalstate
+        self.shared_ids = shared_ids
+        self.env = env
+        self.base = base
+        self.depth = 0
+        self.line_state = globalstate.emit_linenums
+        globalstate.const_cname_counter = base
+        for name in recorded_methods:
+            setattr(globalstate, name, self.recording(name, getattr(globalstate, name)))
+        globalstate.use_utility_code = self.use_utility_code
+        globalstate.lookup_filename = self.lookup_filename
+        for name, part in globalstate.parts.items():
+            part.write = self.recording_write(name, part)
+            part.mark_pos = self.recording_mark_pos(name, part)
+        env.use_utility_code = self.recording_env(env.use_utility_code)
+        # generators keep their temps in the scope of their closure class
+        Code.ClosureTempAllocator.allocate_temp = self.recording_allocate_temp(
+            Code.ClosureTempAllocator.allocate_temp)
+        recording_setattr = self.recording_setattr(
+            set([name for cls, name in recorded_attributes]))
+        for cls, name in recorded_attributes:
+            cls.__setattr__ = recording_setattr
+        self.messages = StringIO()
+        Errors.listing_file = Errors.echo_file = self.messages
+
+    def start_unit(self):
+        globalstate = self.globalstate
+        self.events = []
+        self.touched = set()
+        self.dirty = set()
+        self.marks = {}
+        self.recorded_utility_codes = set()
+        self.utility_codes = set(globalstate.utility_codes)
+        self.unsafe = None
+        self.num_errors = Errors.num_errors
+        self.global_counters = global_counter_values()
+        self.states = {}
+        self.counters = {}
+        self.labels = {}
+        for name, part in globalstate.parts.items():
+            self.states[name] = writer_state(part, True)
+            self.counters[name] = funcstate_counters(part)
+            if part.funcstate is not None:
+                self.labels[name] = set(part.funcstate.labels_used)
+        self.known_states = dict(self.states)
+
+    def finish_unit(self, text):
+        """
+        Return the recording of the unit with the code of its functions.
+        """
+        globalstate = self.globalstate
+        if Errors.num_errors != self.num_errors or self.messages.tell():
+            raise Unsafe("errors or warnings")
+        if global_counter_values() != self.global_counters:
+            raise Unsafe("global counters")
+        if self.unsafe:
+            raise Unsafe(self.unsafe)
+        self.flush_states(self.touched)
+        expected = {}
+        for name in self.touched:
+            part = globalstate.parts[name]
+            if funcstate_counters(part) != self.counters[name]:
+                raise Unsafe("labels or temps in a global part")
+            state = self.states[name]
+            expected[name] = (state[:len(writer_fields)],
+                              self.line_state and state[len(writer_fields):] or None,
+                              self.marks.get(name))
+        utility_keys = [key for key in globalstate.utility_codes
+                        if key not in self.utility_codes
+                        and key not in self.recorded_utility_codes]
+        return expected, utility_keys, self.events, text
+
+    def record(self, event):
+        self.flush_states(self.dirty)
+        self.events.append(event)
+
+    def flush_states(self, names):
+        parts = self.globalstate.parts
+        for name in sorted(names):
+            part = parts[name]
+            state = writer_state(part, True)
+            known = self.known_states[name]
+            if state != known:
+                fields = dict([(field, value) for field, value, old
+                               in zip(writer_fields + line_fields, state, known)
+                               if value != old])
+                self.events.append(('state', name, fields, ()))
+                self.known_states[name] = state
+            if part.funcstate is not None:
+                labels = part.funcstate.labels_used
+                if labels != self.labels[name]:
+                    self.events.append(('state', name, {}, tuple(labels - self.labels[name])))
+                    self.labels[name] = set(labels)
+        self.dirty.clear()
+
+    def recording(self, name, method):
+        def call(*args, **kwargs):
+            if self.depth:
+                return method(*args, **kwargs)
+            self.depth += 1
+            try:
+                result = method(*args, **kwargs)
+            finally:
+                self.depth -= 1
+            self.record(('call', name, args, kwargs, result_names(result)))
+            return result
+        return call
+
+    def use_utility_code(self, utility_code):
+        # the code itself is only written by the main process
+        utility_codes = self.globalstate.utility_codes
+        if utility_code not in utility_codes:
+            utility_codes.add(utility_code)
+            self.recorded_utility_codes.add(utility_code)
+            if not self.depth:
+                self.record(('call', 'use_utility_code', (utility_code,), {}, []))
+
+    def lookup_filename(self, source_desc):
+        table = self.globalstate.filename_table
+        try:
+            index = table[source_desc]
+        except KeyError:
+            index = table[source_desc] = self.base + len(table)
+        if index >= name_range and not self.depth:
+            self.record(('call', 'lookup_filename', (source_desc,), {}, [index]))
+        return index
+
+    def recording_write(self, name, part):
+        write = Code.CCodeWriter.write
+        def recording_write(s):
+            if not self.depth:
+                self.touched.add(name)
+                self.dirty.add(name)
+                self.events.append(('write', name, s))
+            write(part, s)
+        return recording_write
+
+    def recording_mark_pos(self, name, part):
+        mark_pos = Code.CCodeWriter.mark_pos
+        def recording_mark_pos(pos):
+            if not self.depth and pos is not None:
+                self.touched.add(name)
+                self.dirty.add(name)
+                if name not in self.marks:
+                    # the first position of the unit is skipped if it is
+                    # on the same line as the last one of the writer
+                    self.marks[name] = (pos[1], part.last_marker_line == pos[1])
+            mark_pos(part, pos)
+        return recording_mark_pos
+
+    def recording_allocate_temp(self, allocate_temp):
+        def recording_allocate_temp(allocator, type):
+            count = allocator.temps_count
+            cname = allocate_temp(allocator, type)
+            if allocator.temps_count != count:
+                self.record(('declare', allocator.klass, cname, type))
+            return cname
+        return recording_allocate_temp
+
+    def recording_setattr(self, recorded_names):
+        setattr = object.__setattr__
+        shared_ids = self.shared_ids
+        def recording_setattr(obj, name, value):
+            setattr(obj, name, value)
+            if name in recorded_names and id(obj) in shared_ids:
+                if value is not None and not isinstance(value, (basestring, bool)):
+                    self.unsafe = "%s of %s" % (name, type(obj).__name__)
+                self.record(('setattr', obj, name, value))
+        return recording_setattr
+
+    def recording_env(self, use_utility_code):
+        def recording_env(utility_code):
+            if not self.depth:
+                self.record(('env', utility_code))
+            use_utility_code(utility_code)
+        return recording_env
+
+
+class FunctionJobs(object):
+    """
+    Generates the code of the units in worker processes and merges it
+    in the main process.
+    """
+
+    def __init__(self, units, env, code, new_writer):
+        self.units = units
+        self.env = env
+        self.code = code
+        self.new_writer = new_writer
+        self.workers = []
+        self.results = None
+        self.cnames = {}
+        self.filenames = {}
+
+    def start(self, jobs):
+        # keep the objects that workers can refer to alive in all processes
+        self.shared = [obj for obj in gc.get_objects()
+                       if isinstance(obj, shared_classes)]
+        self.shared_ids = dict([(id(obj), obj) for obj in self.shared])
+        sys.stdout.flush()
+        sys.stderr.flush()
+        for n in range(jobs):
+            output = tempfile.TemporaryFile()
+            pid = os.fork()
+            if not pid:
+                status = 1
+                try:
+                    try:
+                        self.run_worker(n, jobs, output)
+                        status = 0
+                    except BaseException:
+                        pass
+                finally:
+                    output.close()
+                    os._exit(status)
+            self.workers.append((pid, output))
+
+    def run_worker(self, n, jobs, output):
+        globalstate = self.code.globalstate
+        recorder = Recorder(globalstate, self.env, (n + 1) * name_range, self.shared_ids)
+        def persistent_id(obj):
+            if id(obj) in self.shared_ids:
+                return id(obj)
+            if isinstance(obj, shared_classes) and not isinstance(obj, Code.UtilityCodeBase):
+                raise pickle.PicklingError("new %s" % type(obj).__name__)
+            return None
+        for index in range(n, len(self.units), jobs):
+            node, directives = self.units[index]
+            globalstate.directives = directives
+            recorder.start_unit()
+            writer = self.new_writer()
+            node.generate_function_definitions(self.env, writer)
+            try:
+                recording = recorder.finish_unit(writer.getvalue())
+                data = BytesIO()
+                pickler = pickle.Pickler(data, pickle.HIGHEST_PROTOCOL)
+                pickler.persistent_id = persistent_id
+                pickler.dump(recording)
+            except (Unsafe, pickle.PicklingError, TypeError):
+                continue
+            pickle.dump((index, data.getvalue()), output, pickle.HIGHEST_PROTOCOL)
+            output.flush()
+
+    def load_results(self):
+        self.results = {}
+        for pid, output in self.workers:
+            os.waitpid(pid, 0)
+            output.seek(0)
+            try:
+                while True:
+                    index, data = pickle.load(output)
+                    self.results[index] = data
+            except Exception:
+                # end of the output, or an incomplete record of a failed worker
+                pass
+            output.close()
+        self.workers = []
+
+    def merge(self, index, writer):
+        """
+        Write the code of the unit with the given index to the writer and
+        replay the effects of generating it.  Returns False if the unit
+        has to be generated by the main process.
+        """
+        if self.results is None:
+            self.load_results()
+        data = self.results.pop(index, None)
+        if data is None:
+            return False
+        try:
+            unpickler = pickle.Unpickler(BytesIO(data))
+            unpickler.persistent_load = self.shared_ids.__getitem__
+            expected, utility_keys, events, text = unpickler.load()
+        except Exception:
+            return False
+        if not self.replayable(expected, utility_keys, events, text):
+            return False
+        globalstate = self.code.globalstate
+        parts = globalstate.parts
+        for event in events:
+            kind = event[0]
+            if kind == 'write':
+                Code.CCodeWriter.write(parts[event[1]], self.rename(event[2]))
+            elif kind == 'state':
+                name, fields, labels = event[1:]
+                part = parts[name]
+                for field, value in fields.items():
+                    setattr(part, field, value)
+                if labels:
+                    part.funcstate.labels_used.update(labels)
+            elif kind == 'call':
+                name, args, kwargs, names = event[1:]
+                result = getattr(globalstate, name)(*args, **kwargs)
+                if name == 'lookup_filename':
+                    mapping = self.filenames
+                else:
+                    mapping = self.cnames
+                for worker_name, own_name in zip(names, result_names(result)):
+                    mapping[worker_name] = own_name
+            elif kind == 'setattr':
+                obj, name, value = event[1:]
+                if isinstance(value, basestring):
+                    value = self.rename(value)
+                setattr(obj, name, value)
+            elif kind == 'declare':
+                scope, cname, type = event[1:]
+                scope.declare_var(pos=None, name=cname, cname=cname, type=type, is_cdef=True)
+            else:  # 'env'
+                self.env.use_utility_code(event[1])
+        globalstate.utility_codes.update(utility_keys)
+        writer.write(self.rename(text))
+        return True
+
+    def replayable(self, expected, utility_keys, events, text):
+        globalstate = self.code.globalstate
+        for key in utility_keys:
+            if key in globalstate.utility_codes:
+                return False
+        line_state = globalstate.emit_linenums
+        for name, (state, line, mark) in expected.items():
+            part = globalstate.parts[name]
+            if writer_state(part, False) != state:
+                return False
+            if line_state and writer_state(part, True)[len(writer_fields):] != line:
+                return False
+            if mark is not None:
+                lineno, skipped = mark
+                if (part.last_marker_line == lineno) != skipped:
+                    return False
+        # all new names must be returned by a recorded call
+        cnames = set(self.cnames)
+        filenames = set(self.filenames)
+        for event in events:
+            if event[0] == 'call':
+                if event[1] == 'lookup_filename':
+                    filenames.update(event[4])
+                else:
+                    cnames.update(event[4])
+        codes = [text]
+        for event in events:
+            if event[0] == 'write':
+                codes.append(event[2])
+            elif event[0] == 'setattr' and isinstance(event[3], basestring):
+                codes.append(event[3])
+        for code in codes:
+            for cname in placeholder_cname.findall(code):
+                if cname not in cnames:
+                    return False
+            for index in placeholder_filename.findall(code):
+                if int(index) not in filenames:
+                    return False
+        return True
+
+    def rename(self, code):
+        if self.cnames:
+            cnames = self.cnames
+            code = placeholder_cname.sub(
+                lambda match: cnames.get(match.group(0), match.group(0)), code)
+        if self.filenames:
+            filenames = self.filenames
+            code = placeholder_filename.sub(
+                lambda match: '%s[%d]' % (Naming.filetable_cname,
+                                          filenames[int(match.group(1))]),
+                code)
+        return code
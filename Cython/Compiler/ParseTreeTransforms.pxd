@@ -60,6 +60,9 @@ cdef class CreateClosureClasses(CythonTransform):
     cdef module_scope
     cdef generator_class
 
+cdef class PythonObjectUseFinder(TreeVisitor):
+    cdef public bint found
+
 cdef class GilCheck(VisitorTransform):
     cdef list env_stack
     cdef bint nogil
@@ -2,7 +2,7 @@ import cython
 cython.declare(PyrexTypes=object, Naming=object, ExprNodes=object, Nodes=object,
                Options=object, UtilNodes=object, LetNode=object,
                LetRefNode=object, TreeFragment=object, EncodedString=object,
-               error=object, warning=object, copy=object)
+               error=object, warning=object, copy=object, Errors=object)
 
 import PyrexTypes
 import Naming
@@ -10,6 +10,7 @@ import ExprNodes
 import Nodes
 import Options
 import Builtin
+import Errors
 
 from Cython.Compiler.Visitor import VisitorTransform, TreeVisitor
 from Cython.Compiler.Visitor import CythonTransform, EnvTransform, ScopeTrackingTransform
@@ -656,6 +657,9 @@ class InterpretCompilerDirectives(CythonTransform, SkipDeclarations):
         "parallel",
         "prange",
         "threadid",
+        "simd",
+        "sections",
+        "section",
 #        "threadsavailable",
     ])
 
@@ -745,6 +749,11 @@ class InterpretCompilerDirectives(CythonTransform, SkipDeclarations):
                                     u"cython.parallel"] = node.module_name
                 self.module_scope.use_utility_code(
                     UtilityCode.load_cached("InitThreads", "ModuleSetupCode.c"))
+            elif node.module_name in (u"cython.atomic", u"cython.ringbuffer"):
+                # modules of the Cython scope, not directives
+                if not node.as_name:
+                    self.cython_module_names.add(u"cython")
+                return node
             elif node.as_name:
                 self.directive_names[node.as_name] = node.module_name[7:]
             else:
@@ -1024,9 +1033,13 @@ class ParallelRangeTransform(CythonTransform, SkipDeclarations):
 
         x = cython.parallel.threadavailable()   -> ParallelThreadAvailableNode
         with nogil, cython.parallel.parallel(): -> ParallelWithBlockNode
+        with nogil, cython.parallel.sections(): -> ParallelSectionsNode
+            with cython.parallel.section():     -> ParallelSectionNode
             print cython.parallel.threadid()    -> ParallelThreadIdNode
             for i in cython.parallel.prange(...):  -> ParallelRangeNode
                 ...
+        for i in cython.parallel.simd(...):     -> SimdRangeNode
+            ...
     """
 
     # a list of names, maps 'cython.parallel.prange' in the code to
@@ -1039,15 +1052,19 @@ class ParallelRangeTransform(CythonTransform, SkipDeclarations):
     # Keep track of whether we are the context manager of a 'with' statement
     in_context_manager_section = False
 
-    # One of 'prange' or 'with parallel'. This is used to disallow closely
-    # nested 'with parallel:' blocks
+    # One of 'prange', 'with parallel', 'parallel sections' or 'parallel
+    # section'. This is used to disallow closely nested 'with parallel:'
+    # blocks and worksharing loops in sections
     state = None
 
     directive_to_node = {
         u"cython.parallel.parallel": Nodes.ParallelWithBlockNode,
+        u"cython.parallel.sections": Nodes.ParallelSectionsNode,
+        u"cython.parallel.section": Nodes.ParallelSectionNode,
         # u"cython.parallel.threadsavailable": ExprNodes.ParallelThreadsAvailableNode,
         u"cython.parallel.threadid": ExprNodes.ParallelThreadIdNode,
         u"cython.parallel.prange": Nodes.ParallelRangeNode,
+        u"cython.parallel.simd": Nodes.SimdRangeNode,
     }
 
     def node_is_parallel_directive(self, node):
@@ -1126,20 +1143,34 @@ class ParallelRangeTransform(CythonTransform, SkipDeclarations):
         return node
 
     def visit_WithStatNode(self, node):
-        "Rewrite with cython.parallel.parallel() blocks"
+        "Rewrite with cython.parallel.parallel() and sections() blocks"
         newnode = self.visit(node.manager)
 
         if isinstance(newnode, Nodes.ParallelWithBlockNode):
-            if self.state == 'parallel with':
+            if self.state in ('parallel with', 'parallel sections',
+                              'parallel section'):
                 error(node.manager.pos,
                       "Nested parallel with blocks are disallowed")
 
-            self.state = 'parallel with'
+            if isinstance(newnode, Nodes.ParallelSectionsNode):
+                self.state = 'parallel sections'
+            else:
+                self.state = 'parallel with'
             body = self.visit(node.body)
             self.state = None
 
             newnode.body = body
             return newnode
+        elif isinstance(newnode, Nodes.ParallelSectionNode):
+            if self.state != 'parallel sections':
+                error(node.manager.pos, "cython.parallel.section() must be "
+                      "used in a cython.parallel.sections() block")
+
+            previous_state = self.state
+            self.state = 'parallel section'
+            newnode.body = self.visit(node.body)
+            self.state = previous_state
+            return newnode
         elif self.parallel_directive:
             parallel_directive_class = self.get_directive_class_node(node)
 
@@ -1147,7 +1178,9 @@ class ParallelRangeTransform(CythonTransform, SkipDeclarations):
                 # There was an error, stop here and now
                 return None
 
-            if parallel_directive_class is Nodes.ParallelWithBlockNode:
+            if issubclass(parallel_directive_class,
+                          (Nodes.ParallelWithBlockNode,
+                           Nodes.ParallelSectionNode)):
                 error(node.pos, "The parallel directive must be called")
                 return None
 
@@ -1155,7 +1188,7 @@ class ParallelRangeTransform(CythonTransform, SkipDeclarations):
         return node
 
     def visit_ForInStatNode(self, node):
-        "Rewrite 'for i in cython.parallel.prange(...):'"
+        "Rewrite 'for i in cython.parallel.prange(...):' and simd(...) loops"
         self.visit(node.iterator)
         self.visit(node.target)
 
@@ -1178,6 +1211,11 @@ class ParallelRangeTransform(CythonTransform, SkipDeclarations):
                 error(node.target.pos,
                       "Can only iterate over an iteration variable")
 
+            if (self.state == 'parallel section' and
+                    type(parallel_range_node) is Nodes.ParallelRangeNode):
+                error(node.pos, "prange() may not be used in a "
+                                "cython.parallel.section()")
+
             self.state = 'prange'
 
         self.visit(node.body)
@@ -1890,7 +1928,7 @@ class ExpandInplaceOperators(EnvTransform):
     def visit_InPlaceAssignmentNode(self, node):
         lhs = node.lhs
         rhs = node.rhs
-        if lhs.type.is_cpp_class:
+        if lhs.type.is_cpp_class or lhs.type.is_atomic:
             # No getting around this exact operator here.
             return node
         if isinstance(lhs, ExprNodes.IndexNode) and lhs.is_buffer_access:
@@ -2303,6 +2341,32 @@ class CreateClosureClasses(CythonTransform):
         return node
 
 
+class PythonObjectUseFinder(TreeVisitor):
+    """
+    Find out whether a (sub-)tree evaluates any Python object or
+    acquires the GIL.
+    """
+    def __init__(self):
+        super(PythonObjectUseFinder, self).__init__()
+        self.found = False
+
+    def visit_GILStatNode(self, node):
+        if node.state == 'gil':
+            self.found = True
+        else:
+            self.visitchildren(node)
+
+    def visit_ExprNode(self, node):
+        if node.type is not None and node.type.is_pyobject:
+            self.found = True
+        else:
+            self.visitchildren(node)
+
+    def visit_Node(self, node):
+        if not self.found:
+            self.visitchildren(node)
+
+
 class GilCheck(VisitorTransform):
     """
     Call `node.gil_check(env)` on each node to make sure we hold the
@@ -2381,6 +2445,19 @@ class GilCheck(VisitorTransform):
         self.visitchildren(node)
         return node
 
+    def visit_SimdRangeNode(self, node):
+        if not self.nogil:
+            # Python operations are legal here, but they won't vectorize
+            finder = PythonObjectUseFinder()
+            finder.visitchildren(node, ['body'])
+            if finder.found:
+                warning(node.pos, "simd loop body may interact with Python "
+                                  "objects, vectorization hints may be "
+                                  "unsafe", level=1)
+
+        self.visitchildren(node)
+        return node
+
     def visit_ParallelWithBlockNode(self, node):
         if not self.nogil:
             error(node.pos, "The parallel section may only be used without "
@@ -2415,6 +2492,283 @@ class GilCheck(VisitorTransform):
         return node
 
 
+
+class SpeculativeGilCheck(GilCheck):
+    """
+    Find out whether a (sub-)tree could run without the GIL, without
+    reporting errors or modifying the tree.  Used by InferNogil.
+
+    Explicit GIL handling ('with gil', 'with nogil' and parallel
+    sections) is never considered safe to move into a nogil context.
+
+    The nogil_check() methods may change the nodes they are called on
+    and register utility code, so the attributes of each checked node and
+    the utility code list of the module are restored afterwards.
+    """
+
+    def __call__(self, node, env):
+        """
+        Return None if 'node' is valid in a nogil context, otherwise
+        the message of the first error that GilCheck would report.
+        """
+        self.env_stack = [env]
+        self.nogil = True
+        self.nogil_declarator_only = False
+
+        utility_code_list = env.global_scope().utility_code_list
+        utility_code_count = len(utility_code_list)
+        Errors.hold_errors()
+        level = Errors.LEVEL
+        Errors.LEVEL = 100  # suppress warnings
+        try:
+            self.visit(node)
+        finally:
+            Errors.LEVEL = level
+            held_errors = Errors.held_errors()
+            Errors.release_errors(ignore=True)
+            del utility_code_list[utility_code_count:]
+
+        if not held_errors:
+            return None
+        err = held_errors[0]
+        return u"%s (line %d)" % (err.message_only, err.position[1])
+
+    def explicit_gil_handling(self, node):
+        error(node.pos, "Explicit GIL handling")
+        return node
+
+    visit_GILStatNode = explicit_gil_handling
+    visit_ParallelStatNode = explicit_gil_handling
+    visit_ParallelWithBlockNode = explicit_gil_handling
+
+    def visit_FuncDefNode(self, node):
+        # nested functions are Python objects
+        error(node.pos, "Nested function definition")
+        return node
+
+    def visit_TryFinallyStatNode(self, node):
+        # GilCheck would mark the node as running without the GIL
+        self.visitchildren(node)
+        return node
+
+    def visit_Node(self, node):
+        if node.nogil_check:
+            attributes = node.__dict__.copy()
+            try:
+                node.nogil_check(self.env_stack[-1])
+            finally:
+                node.__dict__.clear()
+                node.__dict__.update(attributes)
+        self.visitchildren(node)
+        return node
+
+
+class MarkNogilCalls(TreeVisitor):
+    """
+    Update the nodes of an analysed (sub-)tree whose code depends on
+    whether they run without the GIL, after InferNogil moved them into
+    a nogil context.
+    """
+    def __init__(self, module_scope):
+        super(MarkNogilCalls, self).__init__()
+        self.module_scope = module_scope
+
+    def visit_SimpleCallNode(self, node):
+        node.nogil = True
+        func_type = node.function_type()
+        if func_type.is_cfunction and func_type.exception_check and \
+                func_type.exception_check != '+':
+            self.module_scope.use_utility_code(
+                ExprNodes.pyerr_occurred_withgil_utility_code)
+        self.visitchildren(node)
+
+    def visit_IndexNode(self, node):
+        node.nogil = True
+        self.visitchildren(node)
+
+    def visit_Node(self, node):
+        self.visitchildren(node)
+
+
+class LoopCostEstimator(TreeVisitor):
+    """
+    Estimate the cost of running a (sub-)tree as the number of nodes that
+    it evaluates, counting loop bodies once per (estimated) iteration.
+    """
+
+    # assumed number of iterations of loops with unknown bounds
+    unknown_trip_count = 1000
+
+    def __call__(self, node):
+        self.cost = 0
+        self.visit(node)
+        return self.cost
+
+    def trip_count(self, node):
+        if not isinstance(node, Nodes.ForFromStatNode):
+            return self.unknown_trip_count
+        bounds = [node.bound1, node.bound2]
+        if node.step is not None:
+            bounds.append(node.step)
+        for bound in bounds:
+            if not bound.has_constant_result() or \
+                    not isinstance(bound.constant_result, (int, long)):
+                return self.unknown_trip_count
+        step = node.step is not None and abs(node.step.constant_result) or 1
+        return abs(node.bound2.constant_result - node.bound1.constant_result) // step
+
+    def visit_LoopNode(self, node):
+        cost = self.cost
+        self.cost = 0
+        self.visitchildren(node)
+        self.cost = cost + 1 + self.cost * self.trip_count(node)
+
+    def visit_Node(self, node):
+        self.cost += 1
+        self.visitchildren(node)
+
+
+class InferNogil(CythonTransform):
+    """
+    Implements the 'infer_nogil' directive.
+
+    cdef functions that can run without the GIL are declared nogil, so
+    that they can be called from nogil code and inferred nogil callers.
+    In the functions that still need the GIL, it is released around the
+    outermost loops that do not use Python objects and whose estimated
+    cost reaches the 'infer_nogil_loop_cost' directive.
+
+    Each decision is recorded for the annotated HTML output in the
+    'nogil_inference_notes' of the module node.
+    """
+
+    def __call__(self, root):
+        self.functions = []
+        self.loop_env = None
+        root = super(InferNogil, self).__call__(root)
+        if self.functions:
+            self.module_scope = root.scope
+            self.gil_check = SpeculativeGilCheck()
+            self.notes = []
+            self.infer_nogil_functions()
+            for node in self.functions:
+                if not node.local_scope.nogil:
+                    self.loop_env = node.local_scope
+                    self.visitchildren(node, ['body'])
+                    self.loop_env = None
+            self.notes.sort()
+            root.nogil_inference_notes = self.notes
+        return root
+
+    def visit_FuncDefNode(self, node):
+        if self.loop_env is None:
+            if node.local_scope.directives.get('infer_nogil'):
+                self.functions.append(node)
+            self.visitchildren(node)
+        # nested functions are handled separately
+        return node
+
+    def visit_GILStatNode(self, node):
+        if self.loop_env is None:
+            self.visitchildren(node)
+        return node
+
+    visit_ParallelStatNode = visit_GILStatNode
+
+    def visit_LoopNode(self, node):
+        if self.loop_env is None:
+            self.visitchildren(node)
+            return node
+
+        env = self.loop_env
+        reason = self.gil_check(node, env)
+        if reason is None:
+            cost = LoopCostEstimator()(node)
+            threshold = env.directives['infer_nogil_loop_cost']
+            if cost >= threshold:
+                self.notes.append((node.pos,
+                    u"GIL released around loop (estimated cost %d)" % cost))
+                self.make_nogil(node)
+                self.module_scope.use_utility_code(
+                    UtilityCode.load_cached("ForceInitThreads", "ModuleSetupCode.c"))
+                return Nodes.GILStatNode(node.pos, state='nogil', body=node)
+            self.notes.append((node.pos,
+                u"GIL kept for loop: estimated cost %d is below %d" % (cost, threshold)))
+            return node
+
+        self.notes.append((node.pos, u"GIL kept for loop: %s" % reason))
+        # try the inner loops
+        self.visitchildren(node)
+        return node
+
+    def infer_nogil_functions(self):
+        candidates = []
+        for node in self.functions:
+            reason = self.cannot_be_nogil(node)
+            if reason is None:
+                candidates.append(node)
+            elif reason:
+                self.notes.append((node.pos, u"GIL required: %s" % reason))
+
+        # calls to functions that become nogil may allow their callers
+        # to become nogil as well, so iterate until nothing changes
+        reasons = {}
+        changed = True
+        while changed:
+            changed = False
+            for node in candidates[:]:
+                reason = self.gil_check(node.body, node.local_scope)
+                if reason is None:
+                    candidates.remove(node)
+                    self.declare_nogil(node)
+                    self.notes.append((node.pos, u"nogil inferred"))
+                    changed = True
+                else:
+                    reasons[node] = reason
+
+        for node in candidates:
+            self.notes.append((node.pos, u"GIL required: %s" % reasons[node]))
+
+    def cannot_be_nogil(self, node):
+        """
+        Return the reason why the function cannot be inferred nogil,
+        an empty string if it should not be reported, or None if it is
+        a candidate.
+        """
+        if not isinstance(node, Nodes.CFuncDefNode):
+            return u""
+        type = node.type
+        if type.nogil or type.with_gil or node.local_scope.nogil:
+            return u""
+        if node.overridable or node.py_func is not None:
+            return u"cpdef function"
+        if node.has_fused_arguments or type.is_fused:
+            return u"fused function"
+        if type.return_type.is_pyobject:
+            return u"Python return type"
+        for arg in type.args:
+            if arg.type.is_pyobject:
+                return u"Python argument '%s'" % arg.name
+        for entry in node.local_scope.var_entries:
+            if entry.type.is_pyobject:
+                return u"Python local variable '%s'" % entry.name
+        if node.local_scope.has_with_gil_block:
+            return u"contains a 'with gil' block"
+        directives = node.local_scope.directives
+        if directives['profile'] or directives['linetrace']:
+            return u"profiling is enabled"
+        return None
+
+    def declare_nogil(self, node):
+        node.type.nogil = True
+        if node.entry.type.is_cfunction:
+            node.entry.type.nogil = True
+        node.local_scope.nogil = True
+        self.make_nogil(node.body)
+
+    def make_nogil(self, node):
+        MarkNogilCalls(self.module_scope).visit(node)
+
 class TransformBuiltinMethods(EnvTransform):
 
     def visit_SingleAssignmentNode(self, node):
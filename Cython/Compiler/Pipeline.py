@@ -4,6 +4,7 @@ from time import time
 import Errors
 import DebugFlags
 import Options
+import Timings
 from Visitor import CythonTransform
 from Errors import CompileError, InternalError, AbortError
 
@@ -135,7 +136,7 @@ def create_pipeline(context, mode, exclude_classes=()):
     from ParseTreeTransforms import ExpandInplaceOperators, ParallelRangeTransform
     from TypeInference import MarkParallelAssignments, MarkOverflowingArithmetic
     from ParseTreeTransforms import AdjustDefByDirectives, AlignFunctionDefinitions
-    from ParseTreeTransforms import RemoveUnreachableCode, GilCheck
+    from ParseTreeTransforms import RemoveUnreachableCode, GilCheck, InferNogil
     from FlowControl import ControlFlowAnalysis
     from AnalysedTreeTransforms import AutoTestDictTransform
     from AutoDocTransforms import EmbedSignature
@@ -202,6 +203,7 @@ def create_pipeline(context, mode, exclude_classes=()):
         SwitchTransform(),
         DropRefcountingTransform(),
         FinalOptimizePhase(context),
+        InferNogil(context),
         GilCheck(),
         UseUtilityCodeDefinitions(context),
         ]
@@ -245,12 +247,18 @@ def create_pxd_pipeline(context, scope, module_name):
 
     # The pxd pipeline ends up with a CCodeWriter containing the
     # code of the pxd, as well as a pxd scope.
-    return [
+    pipeline = [
         parse_pxd_stage_factory(context, scope, module_name)
         ] + create_pipeline(context, 'pxd') + [
         ExtractPxdCode()
         ]
 
+    import PxdCache
+    pxd_cache = getattr(context.options, 'pxd_cache', None)
+    if pxd_cache or PxdCache.memory_cache is not None:
+        pipeline = PxdCache.cached_pxd_pipeline(pipeline, pxd_cache, context, scope, module_name)
+    return pipeline
+
 def create_py_pipeline(context, options, result):
     return create_pyx_pipeline(context, options, result, py=True)
 
@@ -310,6 +318,8 @@ def run_pipeline(pipeline, source, printtree=True):
 
     error = None
     data = source
+    timings = Timings.current
+    Timings.start_pipeline()
     try:
         try:
             for phase in pipeline:
@@ -319,7 +329,10 @@ def run_pipeline(pipeline, source, printtree=True):
                         print "Entering pipeline phase %r" % phase
                     if not printtree and isinstance(phase, PrintTree):
                         continue
-                    data = phase(data)
+                    if timings is not None:
+                        data = timings.run_pipeline_stage(phase, data)
+                    else:
+                        data = phase(data)
                     if DebugFlags.debug_verbose_pipeline:
                         print "    %.3f seconds" % (time() - t)
         except CompileError, err:
@@ -333,4 +346,5 @@ def run_pipeline(pipeline, source, printtree=True):
         error = err
     except AbortError, err:
         error = err
+    Timings.end_pipeline()
     return (error, data)
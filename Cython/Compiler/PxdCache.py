@@ -0,0 +1,269 @@
+#
+#   Persistent cache of parsed .pxd files
+#
+#   The scope independent first part of the pxd pipeline (parsing and
+#   the tree transforms that run before any declarations are analysed)
+#   is the same for every module that cimports a given .pxd file.  Its
+#   result is pickled into a cache directory, keyed by a hash of the
+#   file content and of everything else that the result depends on, so
+#   that later compiler runs only need to analyse the cached tree.
+#
+#   Module level objects of the compiler (types, singletons, ...) are
+#   pickled by reference, so that they keep their identity.  Trees that
+#   reference anything else that is specific to the compiler run, like
+#   scopes or entries, are not cached.
+#
+#   A long running compiler process (see Server.py) additionally keeps
+#   the pickled trees in memory, which works without a cache directory.
+#
+
+import os
+import sys
+import types
+
+try:
+    import cPickle as pickle
+except ImportError:
+    import pickle
+
+# the pickled trees are bytes, also in Python 3
+if sys.version_info[0] >= 3:
+    from io import BytesIO
+else:
+    try:
+        from cStringIO import StringIO as BytesIO
+    except ImportError:
+        from StringIO import StringIO as BytesIO
+
+try:
+    from hashlib import md5 as hash_function
+except ImportError:
+    from md5 import new as hash_function
+
+import Errors
+import Options
+import Version
+from Cython.Utils import write_file_atomically
+
+shared_object_modules = [
+    'PyrexTypes', 'Builtin', 'ExprNodes', 'Nodes', 'Naming', 'Options',
+    'Future', 'StringEncoding', 'Code', 'UtilNodes', 'TypeSlots',
+    'MemoryView', 'Buffer', 'CythonScope', 'Symtab',
+]
+
+_shared_objects = None
+
+# maps cache keys to pickled trees if not None
+memory_cache = None
+
+def shared_objects():
+    global _shared_objects
+    if _shared_objects is None:
+        _shared_objects = {}
+        skip_types = (type, types.ClassType, types.FunctionType,
+                      types.BuiltinFunctionType, types.ModuleType,
+                      basestring, int, long, float, bool, type(None))
+        for name in shared_object_modules:
+            module_name = 'Cython.Compiler.' + name
+            module = __import__(module_name, None, None, ['*'])
+            for attr, value in vars(module).items():
+                if not isinstance(value, skip_types):
+                    _shared_objects.setdefault(id(value), '%s:%s' % (module_name, attr))
+    return _shared_objects
+
+
+class TreePickler(object):
+
+    def __init__(self, f):
+        import Symtab
+        unpicklable_types = (Symtab.Scope, Symtab.Entry)
+        shared = shared_objects()
+
+        def persistent_id(obj, get_ref=shared.get):
+            ref = get_ref(id(obj))
+            if ref is None and isinstance(obj, unpicklable_types):
+                raise pickle.PicklingError("Cannot cache %r" % obj)
+            return ref
+
+        self.pickler = pickle.Pickler(f, pickle.HIGHEST_PROTOCOL)
+        if pickle.__name__ == 'cPickle':
+            # cPickle: only called for objects that are not builtin values
+            self.pickler.inst_persistent_id = persistent_id
+        else:
+            self.pickler.persistent_id = persistent_id
+
+    def dump(self, obj):
+        self.pickler.dump(obj)
+
+
+def load_shared_object(ref):
+    module_name, attr = ref.split(':')
+    module = __import__(module_name, None, None, ['*'])
+    return getattr(module, attr)
+
+def load_tree(f):
+    unpickler = pickle.Unpickler(f)
+    unpickler.persistent_load = load_shared_object
+    return unpickler.load()
+
+
+def file_digest(path):
+    f = open(path, 'rb')
+    try:
+        return hash_function(f.read()).hexdigest()
+    finally:
+        f.close()
+
+def option_values():
+    # the simple values of the global compiler options
+    return sorted([
+        (name, value) for name, value in vars(Options).items()
+        if isinstance(value, (basestring, int, long, float, bool, type(None)))])
+
+def cache_key(context, source_desc, module_name):
+    options = option_values()
+    compile_time_env = getattr(context.options, 'compile_time_env', None)
+    key = repr((
+        Version.version,
+        module_name,
+        file_digest(source_desc.filename),
+        sorted(context.compiler_directives.items()),
+        sorted(compile_time_env and compile_time_env.items() or ()),
+        context.language_level,
+        sorted([str(directive) for directive in context.future_directives]),
+        context.cpp,
+        context.include_directories,
+        options,
+        ))
+    return hash_function(key.encode("UTF-8")).hexdigest()
+
+def find_include_files(context, source_desc, names):
+    # Resolve the files included by the pxd file.  Returns None if one
+    # of them cannot be found, e.g. because it is relative to another
+    # included file.
+    pos = (source_desc, 1, 0)
+    includes = []
+    for name in names:
+        path = context.search_include_directories(name, "", pos, include=True)
+        if path is None:
+            return None
+        includes.append((name, path, file_digest(path)))
+    return includes
+
+
+class CachedPxdTree(object):
+    """
+    Pipeline stage that replaces the scope independent stages at the
+    start of the pxd pipeline.  The stages are run and their result is
+    stored on a cache miss, and the stored tree is loaded otherwise.
+    """
+
+    def __init__(self, cache_dir, context, scope, module_name, stages):
+        self.cache_dir = cache_dir
+        self.context = context
+        self.scope = scope
+        self.module_name = module_name
+        self.stages = stages
+
+    def __call__(self, source_desc):
+        try:
+            key = cache_key(self.context, source_desc, self.module_name)
+        except EnvironmentError:
+            key = None
+        path = None
+        if key is not None and self.cache_dir:
+            path = os.path.join(self.cache_dir, '%s-%s.pxdtree' % (self.module_name, key))
+
+        if key is not None:
+            cached = self.load(key, path)
+            if cached is not None:
+                tree, included_files, future_directives = cached
+                includes = find_include_files(
+                    self.context, source_desc, [name for name, _, _ in included_files])
+                if includes == included_files:
+                    if path is not None and os.path.exists(path):
+                        os.utime(path, None)  # for LRU cleanup
+                    return self.replay(tree, included_files, future_directives)
+
+        num_errors = Errors.num_errors
+        included_files = len(self.scope.included_files)
+        future_directives = set(self.context.future_directives)
+
+        tree = source_desc
+        for stage in self.stages:
+            if stage is not None:
+                tree = stage(tree)
+
+        if key is not None and Errors.num_errors == num_errors:
+            includes = find_include_files(
+                self.context, source_desc, self.scope.included_files[included_files:])
+            if includes is not None:
+                self.store(key, path, tree, includes,
+                           self.context.future_directives - future_directives)
+        return tree
+
+    def replay(self, tree, included_files, future_directives):
+        # repeat the side effects of parsing the file
+        self.scope.cpp = self.context.cpp
+        directive_comments = getattr(tree, 'directive_comments', None) or {}
+        if 'language_level' in directive_comments:
+            self.context.set_language_level(directive_comments['language_level'])
+        self.context.future_directives.update(future_directives)
+        self.scope.included_files.extend(
+            [name for name, _, _ in included_files])
+        tree.scope = self.scope
+        tree.is_pxd = True
+        return tree
+
+    def load(self, key, path):
+        try:
+            data = memory_cache is not None and memory_cache.get(key)
+            if not data:
+                if path is None or not os.path.exists(path):
+                    return None
+                f = open(path, 'rb')
+                try:
+                    data = f.read()
+                finally:
+                    f.close()
+                if memory_cache is not None:
+                    memory_cache[key] = data
+            # always unpickle a new copy, the pipeline modifies the tree
+            return load_tree(BytesIO(data))
+        except Exception:
+            # corrupt or written by an incompatible compiler
+            return None
+
+    def store(self, key, path, tree, includes, future_directives):
+        tree.scope = None
+        try:
+            f = BytesIO()
+            try:
+                TreePickler(f).dump((tree, includes, future_directives))
+            except (pickle.PicklingError, TypeError, RuntimeError):
+                return
+            data = f.getvalue()
+        finally:
+            tree.scope = self.scope
+        if memory_cache is not None:
+            memory_cache[key] = data
+        if path is None:
+            return
+        try:
+            if not os.path.isdir(self.cache_dir):
+                os.makedirs(self.cache_dir)
+            # replaces any version that a concurrent compiler run wrote
+            write_file_atomically(path, lambda f: f.write(data))
+        except EnvironmentError:
+            pass
+
+
+def cached_pxd_pipeline(pipeline, cache_dir, context, scope, module_name):
+    # Replace the stages up to the first one that uses the module scope.
+    from ParseTreeTransforms import ForwardDeclareTypes
+    for i, stage in enumerate(pipeline):
+        if isinstance(stage, ForwardDeclareTypes):
+            break
+    else:
+        return pipeline
+    return [CachedPxdTree(cache_dir, context, scope, module_name, pipeline[:i])] + pipeline[i:]
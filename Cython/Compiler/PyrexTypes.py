@@ -144,6 +144,8 @@ class PyrexType(BaseType):
     #  is_struct             boolean     Is a C struct type
     #  is_enum               boolean     Is a C enum type
     #  is_typedef            boolean     Is a typedef type
+    #  is_atomic             boolean     Is a cython.atomic type
+    #  is_atomic_op          boolean     Is a cython.atomic operation
     #  is_string             boolean     Is a C char * type
     #  is_pyunicode_ptr      boolean     Is a C PyUNICODE * type
     #  is_cpp_string         boolean     Is a C++ std::string type
@@ -202,6 +204,8 @@ class PyrexType(BaseType):
     is_struct = 0
     is_enum = 0
     is_typedef = 0
+    is_atomic = 0
+    is_atomic_op = 0
     is_string = 0
     is_pyunicode_ptr = 0
     is_unicode_char = 0
@@ -445,6 +449,44 @@ class CTypedefType(BaseType):
         return self.typedef_base_type.can_coerce_to_pyobject(env)
 
 
+class CAtomicType(CTypedefType):
+    #
+    #  A type of the cython.atomic module, i.e. a C numeric or
+    #  pointer type that is suitably aligned for atomic operations.
+    #  Variables of these types are never privatized in parallel
+    #  blocks and in-place operators on them are atomic.
+    #
+
+    is_atomic = 1
+
+    def create_declaration_utility_code(self, env):
+        env.use_utility_code(UtilityCode.load_cached("AtomicTypes", "Atomic.c"))
+        return True
+
+    def __repr__(self):
+        return "<CAtomicType %s>" % self.typedef_cname
+
+
+class CAtomicOpType(PyrexType):
+    #
+    #  The pseudo-type of an operation of the cython.atomic module,
+    #  calls to it are replaced by an AtomicOpNode.
+    #
+    #  op      string      load, store, exchange, compare_exchange or fetch_<op>
+
+    is_atomic_op = 1
+
+    def __init__(self, op):
+        self.op = op
+
+    def declaration_code(self, entity_code,
+            for_display = 0, dll_linkage = None, pyrex = 0):
+        return "<atomic %s operation>" % self.op
+
+    def __repr__(self):
+        return "<CAtomicOpType %s>" % self.op
+
+
 class MemoryViewSliceType(PyrexType):
 
     is_memoryviewslice = 1
@@ -1409,9 +1451,14 @@ static CYTHON_INLINE %(type)s __Pyx_PyInt_As%(SignWord)s%(TypeName)s(PyObject* x
 #if CYTHON_COMPILING_IN_CPYTHON && PY_MAJOR_VERSION >= 3
 #if CYTHON_USE_PYLONG_INTERNALS
             if (sizeof(digit) <= sizeof(%(type)s)) {
+                const digit* digits = ((PyLongObject*)x)->ob_digit;
                 switch (Py_SIZE(x)) {
                     case  0: return 0;
-                    case  1: return (%(type)s) ((PyLongObject*)x)->ob_digit[0];
+                    case  1: return (%(type)s) digits[0];
+                    case  2:
+                        if (8 * sizeof(%(type)s) >= 2 * PyLong_SHIFT)
+                            return (((%(type)s) digits[1]) << PyLong_SHIFT) | (%(type)s) digits[0];
+                        break;
                 }
             }
 #endif
@@ -1426,10 +1473,19 @@ static CYTHON_INLINE %(type)s __Pyx_PyInt_As%(SignWord)s%(TypeName)s(PyObject* x
 #if CYTHON_COMPILING_IN_CPYTHON && PY_MAJOR_VERSION >= 3
 #if CYTHON_USE_PYLONG_INTERNALS
             if (sizeof(digit) <= sizeof(%(type)s)) {
+                const digit* digits = ((PyLongObject*)x)->ob_digit;
                 switch (Py_SIZE(x)) {
                     case  0: return 0;
-                    case  1: return +(%(type)s) ((PyLongObject*)x)->ob_digit[0];
-                    case -1: return -(%(type)s) ((PyLongObject*)x)->ob_digit[0];
+                    case  1: return +(%(type)s) digits[0];
+                    case -1: return -(%(type)s) digits[0];
+                    case  2:
+                        if (8 * sizeof(%(type)s) > 2 * PyLong_SHIFT)
+                            return +((((%(type)s) digits[1]) << PyLong_SHIFT) | (%(type)s) digits[0]);
+                        break;
+                    case -2:
+                        if (8 * sizeof(%(type)s) > 2 * PyLong_SHIFT)
+                            return -((((%(type)s) digits[1]) << PyLong_SHIFT) | (%(type)s) digits[0]);
+                        break;
                 }
             }
 #endif
@@ -1520,18 +1576,18 @@ static CYTHON_INLINE PyObject *__Pyx_PyInt_to_py_%(TypeName)s(%(type)s val) {
     const int is_unsigned = const_zero < neg_one;
     if ((sizeof(%(type)s) == sizeof(char))  ||
         (sizeof(%(type)s) == sizeof(short))) {
-        return PyInt_FromLong((long)val);
+        return __Pyx_PyInt_FromLong((long)val);
     } else if ((sizeof(%(type)s) == sizeof(int)) ||
                (sizeof(%(type)s) == sizeof(long))) {
         if (is_unsigned)
-            return PyLong_FromUnsignedLong((unsigned long)val);
+            return __Pyx_PyLong_FromUnsignedLong((unsigned long)val);
         else
-            return PyInt_FromLong((long)val);
+            return __Pyx_PyInt_FromLong((long)val);
     } else if (sizeof(%(type)s) == sizeof(PY_LONG_LONG)) {
         if (is_unsigned)
-            return PyLong_FromUnsignedLongLong((unsigned PY_LONG_LONG)val);
+            return __Pyx_PyLong_FromUnsignedLongLong((unsigned PY_LONG_LONG)val);
         else
-            return PyLong_FromLongLong((PY_LONG_LONG)val);
+            return __Pyx_PyLong_FromLongLong((PY_LONG_LONG)val);
     } else {
         int one = 1; int little = (int)*(unsigned char *)&one;
         unsigned char *bytes = (unsigned char *)&val;
@@ -1559,9 +1615,9 @@ class CIntType(CNumericType):
     def get_to_py_type_conversion(self):
         if self.rank < list(rank_to_type_name).index('int'):
             # This assumes sizeof(short) < sizeof(int)
-            return "PyInt_FromLong"
+            return "__Pyx_PyInt_FromLong"
         else:
-            # Py{Int|Long}_From[Unsigned]Long[Long]
+            # __Pyx_Py{Int|Long}_From[Unsigned]Long[Long]
             Prefix = "Int"
             SignWord = ""
             TypeName = "Long"
@@ -1571,7 +1627,7 @@ class CIntType(CNumericType):
             if self.rank >= list(rank_to_type_name).index('PY_LONG_LONG'):
                 Prefix = "Long"
                 TypeName = "LongLong"
-            return "Py%s_From%s%s" % (Prefix, SignWord, TypeName)
+            return "__Pyx_Py%s_From%s%s" % (Prefix, SignWord, TypeName)
 
     def get_from_py_type_conversion(self):
         type_name = rank_to_type_name[self.rank]
@@ -1728,7 +1784,7 @@ class CPyHashTType(CIntType):
 
 class CPySSizeTType(CIntType):
 
-    to_py_function = "PyInt_FromSsize_t"
+    to_py_function = "__Pyx_PyInt_FromSsize_t"
     from_py_function = "__Pyx_PyIndex_AsSsize_t"
 
     def sign_and_name(self):
@@ -1736,7 +1792,7 @@ class CPySSizeTType(CIntType):
 
 class CSSizeTType(CIntType):
 
-    to_py_function = "PyInt_FromSsize_t"
+    to_py_function = "__Pyx_PyInt_FromSsize_t"
     from_py_function = "PyInt_AsSsize_t"
 
     def sign_and_name(self):
@@ -3313,7 +3369,7 @@ class CEnumType(CType):
     is_enum = 1
     signed = 1
     rank = -1 # Ranks below any integer type
-    to_py_function = "PyInt_FromLong"
+    to_py_function = "__Pyx_PyInt_FromLong"
     from_py_function = "PyInt_AsLong"
 
     def __init__(self, name, cname, typedef_flag):
@@ -0,0 +1,411 @@
+#
+#   Compiler server
+#
+#   A long running "cython --server" process that compiles modules on
+#   request of cythonize() and pyximport.  Clients only use it when
+#   asked to and connect through a Unix socket in a private directory,
+#   after checking that the socket and the process behind it belong to
+#   the same user.  They fall back to compiling in their own process if
+#   no (compatible) server is running.
+#
+#   Each request is compiled in a fresh Context, exactly as in a normal
+#   compiler run, but the server does not pay for importing the compiler
+#   modules, loading the utility code and building the builtin scope
+#   again, and it keeps the trees of all parsed .pxd files in memory
+#   (see PxdCache.py).  Requests are handled one at a time.
+#
+
+import os
+import sys
+import stat
+import socket
+import struct
+import tempfile
+
+try:
+    from cStringIO import StringIO
+except ImportError:
+    from StringIO import StringIO
+
+import Options
+import Version
+
+socket_path_variable = 'CYTHON_SERVER_SOCKET'
+
+compiler_directory = os.path.abspath(os.path.dirname(__file__))
+
+# largest message that a client or the server accepts
+max_message_size = 256 * 1024 * 1024
+
+def default_socket_path():
+    """
+    The socket path from the CYTHON_SERVER_SOCKET environment variable,
+    or a socket in a private per-user directory below $XDG_RUNTIME_DIR
+    or the temporary directory.
+    """
+    path = os.environ.get(socket_path_variable)
+    if path:
+        return path
+    if not hasattr(socket, 'AF_UNIX') or not hasattr(os, 'getuid'):
+        return None
+    runtime_directory = os.environ.get('XDG_RUNTIME_DIR')
+    if runtime_directory:
+        directory = os.path.join(runtime_directory, 'cython')
+    else:
+        directory = os.path.join(tempfile.gettempdir(), 'cython-%d' % os.getuid())
+    return os.path.join(directory, 'server.sock')
+
+def client_socket_path(use_server=False):
+    """
+    The socket that a client connects to, or None.  Clients only use a
+    server when asked to, either by setting CYTHON_SERVER_SOCKET or by
+    passing use_server=True.
+    """
+    if use_server or os.environ.get(socket_path_variable):
+        return default_socket_path()
+    return None
+
+def check_directory(directory):
+    # Nobody else may create, replace or remove entries in the directory
+    # of the socket, otherwise a different server could take its place.
+    st = os.lstat(directory)
+    if not stat.S_ISDIR(st.st_mode) or st.st_uid != os.getuid() or st.st_mode & 022:
+        raise EnvironmentError(
+            "Compiler server directory %s must be owned by the user and "
+            "not be writable by others" % directory)
+
+def make_private_directory(directory):
+    if not os.path.exists(directory):
+        os.mkdir(directory, 0700)
+    check_directory(directory)
+
+def check_socket(socket_path):
+    check_directory(os.path.dirname(os.path.abspath(socket_path)))
+    st = os.lstat(socket_path)
+    if not stat.S_ISSOCK(st.st_mode) or st.st_uid != os.getuid():
+        raise EnvironmentError(
+            "%s is not a socket owned by the user" % socket_path)
+
+if hasattr(socket, 'SO_PEERCRED'):
+    SO_PEERCRED = socket.SO_PEERCRED
+elif sys.platform.startswith('linux'):
+    SO_PEERCRED = 17
+else:
+    SO_PEERCRED = None  # only the directory and socket checks apply
+
+def check_peer(connection):
+    # the process on the other side must run as the same user
+    if SO_PEERCRED is None:
+        return
+    credentials = connection.getsockopt(
+        socket.SOL_SOCKET, SO_PEERCRED, struct.calcsize('3i'))
+    pid, uid, gid = struct.unpack('3i', credentials)
+    if uid != os.getuid():
+        raise EnvironmentError("Compiler server peer runs as a different user")
+
+def protocol_version():
+    # the server must run the same compiler on the same Python version
+    return [Version.version, list(sys.version_info[:2]), compiler_directory]
+
+def options_snapshot():
+    # Module level settings in Options, which clients may have changed,
+    # including the dicts of directive defaults and scopes.  The types
+    # of the directives are derived from their defaults.
+    return dict([
+        (name, value) for name, value in vars(Options).items()
+        if not name.startswith('_') and name != 'directive_types' and
+           not callable(value)])
+
+def restore_options(options_module):
+    for name, value in options_module.items():
+        current = getattr(Options, name, None)
+        if isinstance(current, dict) and isinstance(value, dict):
+            # other modules keep references to these
+            current.clear()
+            current.update(value)
+        else:
+            setattr(Options, name, value)
+
+
+# Messages are JSON documents.  JSON distinguishes neither tuples from
+# lists nor byte strings from unicode strings, and only knows string
+# keys, so all containers and strings are tagged with their type.
+
+def to_plain(value):
+    if value is None or isinstance(value, (bool, int, long, float)):
+        return value
+    if isinstance(value, unicode):
+        return ['u', value]
+    if isinstance(value, str):
+        return ['s', value.decode('iso8859-1')]
+    if type(value) is list:
+        return ['l', [to_plain(item) for item in value]]
+    if type(value) is tuple:
+        return ['t', [to_plain(item) for item in value]]
+    if type(value) is dict:
+        return ['d', [[to_plain(key), to_plain(item)] for key, item in value.items()]]
+    raise TypeError("Cannot send %s objects to the compiler server" % type(value).__name__)
+
+def from_plain(value):
+    if not isinstance(value, list):
+        if value is not None and not isinstance(value, (bool, int, long, float)):
+            raise ValueError("Invalid compiler server message")
+        return value
+    tag, content = value
+    if tag == 'u':
+        return content
+    elif tag == 's':
+        return content.encode('iso8859-1')
+    elif tag == 'l':
+        return [from_plain(item) for item in content]
+    elif tag == 't':
+        return tuple([from_plain(item) for item in content])
+    elif tag == 'd':
+        return dict([(from_plain(key), from_plain(item)) for key, item in content])
+    raise ValueError("Invalid compiler server message")
+
+def result_to_plain(result):
+    # The compilation_source of the results refers to compiler objects
+    # and is not sent back.
+    from Main import CompilationResultSet
+    def attributes(result):
+        return dict([(name, value) for name, value in vars(result).items()
+                     if name != 'compilation_source'])
+    if isinstance(result, CompilationResultSet):
+        return ('set', [(source, attributes(module_result))
+                        for source, module_result in result.items()])
+    return ('single', attributes(result))
+
+def result_from_plain(plain):
+    from Main import CompilationResult, CompilationResultSet
+    def create(attributes):
+        result = CompilationResult()
+        result.compilation_source = None
+        vars(result).update(attributes)
+        return result
+    kind, content = plain
+    if kind == 'single':
+        return create(content)
+    results = CompilationResultSet()
+    for source, attributes in content:
+        results.add(source, create(attributes))
+    return results
+
+def send(connection, obj):
+    import json
+    data = json.dumps(to_plain(obj))
+    if isinstance(data, unicode):
+        data = data.encode('ascii')
+    connection.sendall(struct.pack('!Q', len(data)) + data)
+
+def receive_bytes(connection, size):
+    chunks = []
+    while size:
+        chunk = connection.recv(min(size, 1024 * 1024))
+        if not chunk:
+            raise EOFError("Connection closed")
+        chunks.append(chunk)
+        size -= len(chunk)
+    return ''.encode('ascii').join(chunks)
+
+def receive(connection):
+    import json
+    size, = struct.unpack('!Q', receive_bytes(connection, 8))
+    if size > max_message_size:
+        raise ValueError("Compiler server message too large")
+    return from_plain(json.loads(receive_bytes(connection, size).decode('ascii')))
+
+
+#------------------------------------------------------------------------
+#
+#  Client
+#
+#------------------------------------------------------------------------
+
+def compile_on_server(source, options, full_module_name=None, socket_path=None):
+    """
+    Compile on a running compiler server.  Returns the result of
+    Main.compile(), or None if no compatible server could be used.
+    """
+    if socket_path is None:
+        socket_path = client_socket_path()
+    if not socket_path or not os.path.exists(socket_path):
+        return None
+    request = {
+        'version': protocol_version(),
+        'cwd': os.getcwd(),
+        'sys_path': sys.path,
+        'options_module': options_snapshot(),
+        'source': source,
+        'options': options and vars(options),
+        'full_module_name': full_module_name,
+        }
+    try:
+        check_socket(socket_path)
+        connection = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        try:
+            connection.connect(socket_path)
+            check_peer(connection)
+            send(connection, request)
+            status, result, output = receive(connection)
+        finally:
+            connection.close()
+        if status != 'ok':
+            return None
+        result = result_from_plain(result)
+    except Exception:
+        # untrusted or stale socket, options that cannot be sent (like
+        # objects in compile_time_env), server died, invalid response, ...
+        return None
+    if output:
+        sys.stderr.write(output)
+    return result
+
+def compile(source, options=None, full_module_name=None):
+    """
+    compile(source [, options] [, full_module_name])
+
+    Same as Main.compile(), but compiles on a running compiler server
+    if CYTHON_SERVER_SOCKET is set and the server can be used.
+    """
+    from Main import CompilationOptions, default_options, compile as compile_locally
+    if options is None:
+        options = CompilationOptions(default_options)
+    result = compile_on_server(source, options, full_module_name)
+    if result is None:
+        result = compile_locally(source, options, full_module_name)
+    return result
+
+
+#------------------------------------------------------------------------
+#
+#  Server
+#
+#------------------------------------------------------------------------
+
+def compile_request(request):
+    import copy
+    import Main
+    cwd = os.getcwd()
+    sys_path = sys.path[:]
+    options_module = copy.deepcopy(options_snapshot())
+    stdout, stderr = sys.stdout, sys.stderr
+    output = StringIO()
+    try:
+        os.chdir(request['cwd'])
+        sys.path[:] = request['sys_path']
+        restore_options(request['options_module'])
+        options = request['options']
+        if options is not None:
+            options = Main.CompilationOptions(options)
+        sys.stdout = sys.stderr = output
+        try:
+            result = Main.compile(
+                request['source'], options, request['full_module_name'])
+            response = ('ok', result_to_plain(result), output.getvalue())
+            to_plain(response)  # fail here if the result cannot be sent
+        except Exception:
+            # let the client repeat the compilation to get the same error
+            return ('failed', None, '')
+    finally:
+        sys.stdout, sys.stderr = stdout, stderr
+        restore_options(options_module)
+        sys.path[:] = sys_path
+        os.chdir(cwd)
+    return response
+
+def handle_connection(connection):
+    check_peer(connection)
+    request = receive(connection)
+    if request.get('version') != protocol_version():
+        send(connection, ('version mismatch', None, ''))
+        return
+    send(connection, compile_request(request))
+
+def warm_up():
+    # Compile a small module to import the whole compiler and to load
+    # the lexicon, the builtin scope and commonly used utility code.
+    directory = tempfile.mkdtemp(prefix='cython_server_')
+    try:
+        source = os.path.join(directory, 'cython_server_warm_up.pyx')
+        f = open(source, 'w')
+        try:
+            f.write('from libc.stdlib cimport malloc, free\n'
+                    'cdef class A:\n'
+                    '    cdef list items\n'
+                    'def f(x, *args, **kwargs):\n'
+                    '    return [i * 2 for i in range(x)], args, kwargs\n')
+        finally:
+            f.close()
+        compile_request({
+            'cwd': directory,
+            'sys_path': sys.path,
+            'options_module': options_snapshot(),
+            'source': source,
+            'options': None,
+            'full_module_name': None,
+            })
+    finally:
+        import shutil
+        shutil.rmtree(directory, ignore_errors=True)
+
+def serve(socket_path=None):
+    """
+    Run a compiler server on the given Unix socket path (by default
+    the one that clients look for) until the process is terminated.
+    The directory of the socket must only be writable by the user,
+    the default directory is created with this access mode.
+    """
+    import signal
+    import PxdCache
+    if socket_path is None:
+        socket_path = default_socket_path()
+        if socket_path and socket_path_variable not in os.environ:
+            make_private_directory(os.path.dirname(socket_path))
+    if not socket_path or not hasattr(socket, 'AF_UNIX'):
+        raise EnvironmentError("Compiler server is not supported on this platform")
+    check_directory(os.path.dirname(os.path.abspath(socket_path)))
+
+    server = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+    if os.path.exists(socket_path):
+        try:
+            server.connect(socket_path)
+        except socket.error:
+            os.remove(socket_path)  # stale
+        else:
+            server.close()
+            raise EnvironmentError("Compiler server already running on %s" % socket_path)
+        server = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+
+    PxdCache.memory_cache = {}
+    warm_up()
+
+    old_umask = os.umask(0177)  # only accessible by this user
+    try:
+        server.bind(socket_path)
+    finally:
+        os.umask(old_umask)
+    server.listen(16)
+    sys.stderr.write("Compiler server listening on %s\n" % socket_path)
+
+    def terminate(signum, frame):
+        raise KeyboardInterrupt
+    signal.signal(signal.SIGTERM, terminate)
+
+    try:
+        try:
+            while True:
+                connection, _ = server.accept()
+                try:
+                    try:
+                        handle_connection(connection)
+                    except Exception:
+                        pass  # client went away, is not trusted or sent garbage
+                finally:
+                    connection.close()
+        except KeyboardInterrupt:
+            pass
+    finally:
+        server.close()
+        if os.path.exists(socket_path):
+            os.remove(socket_path)
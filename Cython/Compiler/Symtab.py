@@ -13,6 +13,7 @@ from TypeSlots import \
     pyfunction_signature, pymethod_signature, \
     get_special_method_signature, get_property_accessor_signature
 import Code
+import Timings
 import __builtin__ as builtins
 
 iso_c99_keywords = set(
@@ -57,6 +58,8 @@ class Entry(object):
     #                               or class attribute during
     #                               class construction
     # is_member        boolean    Is an assigned class member
+    # is_function_global boolean  Is a module-level variable that a function
+    #                               declares 'global'
     # is_pyclass_attr  boolean    Is a name in a Python class namespace
     # is_variable      boolean    Is a variable
     # is_cfunction     boolean    Is a C function
@@ -130,6 +133,7 @@ class Entry(object):
     is_builtin = 0
     is_cglobal = 0
     is_pyglobal = 0
+    is_function_global = 0
     is_member = 0
     is_pyclass_attr = 0
     is_variable = 0
@@ -820,7 +824,7 @@ class Scope(object):
 
     def infer_types(self):
         from TypeInference import get_type_inferer
-        get_type_inferer().infer_types(self)
+        Timings.timed('type inference', get_type_inferer().infer_types, self)
 
     def is_cpp(self):
         outer = self.outer_scope
@@ -1481,7 +1485,7 @@ class ModuleScope(Scope):
 
     def infer_types(self):
         from TypeInference import PyObjectTypeInferer
-        PyObjectTypeInferer().infer_types(self)
+        Timings.timed('type inference', PyObjectTypeInferer().infer_types, self)
 
 class LocalScope(Scope):
 
@@ -1534,6 +1538,7 @@ class LocalScope(Scope):
             warning(pos, "'%s' redeclared  ", 0)
         else:
             entry = self.global_scope().lookup_target(name)
+            entry.is_function_global = 1
             self.entries[name] = entry
 
     def declare_nonlocal(self, name, pos):
@@ -0,0 +1,114 @@
+import os
+import unittest
+
+from Cython.Compiler import CodeSplitting
+from Cython.Compiler.CodeSplitting import parse_items, split_code, hidden_macro
+from Cython.TestUtils import FileTestCase
+
+
+code = '''\
+/* Generated by Cython */
+#include "Python.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+typedef struct {
+    int a; /* } */
+} S;
+static int x = 1;
+static const char *s = "{";
+static int f(int);  /*proto*/
+#if PY_MAJOR_VERSION >= 3
+static int f(int a) {
+    if (a) {
+#else
+static int f(int a) {
+    if (!a) {
+#endif
+        return '}';
+    }
+    return x;
+}
+#ifdef __cplusplus
+}
+#endif
+'''
+
+
+class TestParseItems(unittest.TestCase):
+
+    def test_round_trip(self):
+        items = parse_items(code)
+        self.assertEqual(code, ''.join([item.text for item in items]))
+
+    def test_items(self):
+        items = [item for item in parse_items(code) if item.kind != 'trivia']
+        self.assertEqual(
+            [('decl', None), ('decl', 'x'), ('decl', 's'), ('decl', 'f'), ('func', 'f')],
+            [(item.kind, item.name) for item in items])
+        self.assertEqual('int x', items[1].declarator)
+        self.assert_(items[3].is_function)
+        self.assert_(not items[2].is_function)
+
+
+class TestSplitCode(unittest.TestCase):
+
+    declarations = '''\
+static int counter;
+static int next_value(void); /*proto*/
+static int helper(void); /*proto*/
+static int twice(int); /*proto*/
+static CYTHON_INLINE int inc(int a) { return a + 1; }
+'''
+    main_code = '''
+static int next_value(void) {
+  return inc(counter++);
+}
+static int helper(void) {
+  return 1;
+}
+'''
+    part_code = '''
+static int twice(int a) {
+  return 2 * next_value() * a;
+}
+'''
+
+    def test_split(self):
+        main, (part,) = split_code(self.declarations, self.main_code, [self.part_code])
+        # variables are defined in the main file
+        self.assert_('%s int counter;' % hidden_macro in main)
+        self.assert_('extern %s int counter;' % hidden_macro in part)
+        # functions are defined where they were, and shared if needed
+        self.assert_('%s int next_value(void) {' % hidden_macro in main)
+        self.assert_('%s int next_value(void);' % hidden_macro in part)
+        self.assert_('static int helper(void) {' in main)
+        self.assert_('helper' not in part)
+        self.assert_('static int twice(int a) {' in part)
+        self.assert_('twice' not in main)
+        # inline functions are copied
+        self.assert_('static CYTHON_INLINE int inc(int a)' in main)
+        self.assert_('static CYTHON_UNUSED CYTHON_INLINE int inc(int a)' in part)
+
+
+class TestPartFiles(FileTestCase):
+
+    directory_prefix = 'cython_split_'
+
+    def test_part_files(self):
+        c_file = self.path('module.c')
+        names = CodeSplitting.part_file_names(c_file, 2)
+        self.assertEqual([self.path(name)
+                          for name in ('module.part1.c', 'module.part2.c')], names)
+        self.write('module.c', '/* Generated by Cython */\n%s\n' %
+                   CodeSplitting.part_files_comment(names))
+        self.assertEqual(names, CodeSplitting.part_files(c_file))
+        for path in names:
+            open(path, 'w').close()
+        CodeSplitting.remove_part_files(c_file, 1)
+        self.assert_(os.path.exists(names[0]))
+        self.assert_(not os.path.exists(names[1]))
+
+
+if __name__ == '__main__':
+    unittest.main()
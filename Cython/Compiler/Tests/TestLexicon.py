@@ -0,0 +1,70 @@
+import unittest
+
+from Cython.Compiler import Scanning
+from Cython.Plex import Machines
+
+
+class TestStateTables(unittest.TestCase):
+
+    def setUp(self):
+        self.lexicon = Scanning.get_lexicon()
+
+    def test_tables_match_machine(self):
+        machine = self.lexicon.machine
+        tables = self.lexicon.tables
+        numbers = dict([(id(state), number) for number, state in enumerate(machine.states)])
+        inputs = ['', 'bol', 'eol', 'eof'] + [unichr(code) for code in range(300)]
+        for number, state in enumerate(machine.states):
+            self.assertEqual(state['action'], tables.actions[number])
+            for c in inputs:
+                if len(c) == 1:
+                    target = state.get(c, state['else'])
+                else:
+                    target = state[c]
+                expected = target is None and -1 or numbers[id(target)]
+                char_class = tables.char_class(c)
+                self.assertEqual(expected, tables.transitions[number * tables.num_classes + char_class],
+                                 'state %d, input %r' % (number, c))
+
+    def test_initial_states(self):
+        machine = self.lexicon.machine
+        tables = self.lexicon.tables
+        for name, state in machine.initial_states.items():
+            self.assert_(machine.states[tables.get_initial_state(name)] is state)
+
+    def test_char_classes(self):
+        tables = self.lexicon.tables
+        self.assert_(len(tables.char_classes) >= 128)
+        self.assertEqual(Machines.OTHER_CLASS, tables.char_class(u'\u20ac'))
+        self.assertEqual(tables.char_class('g'), tables.char_class('h'))
+        self.assertNotEqual(tables.char_class('a'), tables.char_class('0'))
+
+
+class TestScanning(unittest.TestCase):
+
+    def tokens(self, code):
+        from StringIO import StringIO
+        from Cython.Compiler.Scanning import PyrexScanner, StringSourceDescriptor
+        from Cython.Compiler.Main import Context
+        class Scope(object):
+            included_files = []
+        context = Context(['.'], {}, language_level=2)
+        scanner = PyrexScanner(StringIO(code), StringSourceDescriptor('test', code),
+                               scope=Scope(), context=context)
+        result = []
+        while scanner.sy != 'EOF':
+            result.append((scanner.sy, scanner.systring))
+            scanner.next()
+        return result
+
+    def test_tokens(self):
+        self.assertEqual(
+            [('def', 'def'), ('IDENT', 'f'), ('(', '('), ('IDENT', 'x'), (')', ')'),
+             (':', ':'), ('NEWLINE', ''), ('INDENT', ''), ('return', 'return'),
+             ('IDENT', 'x'), ('+', '+'), ('FLOAT', '1.5e3'), ('NEWLINE', ''),
+             ('DEDENT', '')],
+            self.tokens(u'def f(x):\n    return x + 1.5e3\n'))
+
+
+if __name__ == '__main__':
+    unittest.main()
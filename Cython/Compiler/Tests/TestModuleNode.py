@@ -0,0 +1,76 @@
+import unittest
+
+from Cython.Compiler import Nodes
+from Cython.Compiler.Main import compile, CompilationOptions, default_options
+from Cython.Compiler.ModuleNode import ReleaseFunctionBodies
+from Cython.Compiler.TreeFragment import parse_from_strings
+from Cython.TestUtils import FileTestCase
+
+
+code = u'''
+x = [i for i in range(3)]
+
+def f(a, b=x):
+    def inner():
+        return a
+    return inner
+
+class C(object):
+    def method(self, c=1):
+        return c
+
+def gen(n):
+    for i in range(n):
+        yield i
+'''
+
+
+class TestReleaseFunctionBodies(unittest.TestCase):
+
+    def test_release(self):
+        tree = parse_from_strings('release', code)
+        ReleaseFunctionBodies()(tree)
+        stats = tree.body.stats
+        self.assert_(isinstance(stats[0], Nodes.SingleAssignmentNode))
+        self.assert_(stats[0].rhs is not None)
+        f = stats[1]
+        self.assertEqual(None, f.body)
+        self.assertEqual(2, len(f.args))
+        self.assert_(f.args[1].default is not None)
+        method = stats[2].body
+        self.assertEqual(None, method.body)
+        self.assert_(method.args[1].default is not None)
+        self.assertEqual(None, stats[3].body)
+
+
+class TestGeneratedCode(FileTestCase):
+
+    directory_prefix = 'cython_module_node_'
+
+    def setUp(self):
+        FileTestCase.setUp(self)
+        self.write('release.pyx', (code + u'''
+cdef class D:
+    cdef int x
+    cpdef int get(self, int y=2):
+        return self.x + y
+
+cdef int twice(int n):
+    return n * 2
+''').encode('ascii'), 'wb')
+
+    def compile(self, **kwargs):
+        options = CompilationOptions(default_options, **kwargs)
+        options.output_file = self.path('release.c')
+        result = compile(self.path('release.pyx'), options)
+        self.assertEqual(0, result.num_errors)
+        # skip the first line with the timestamp
+        return self.read('release.c').splitlines()[1:]
+
+    def test_same_code(self):
+        # annotating keeps the function bodies and does not spill the code
+        self.assertEqual(self.compile(annotate=True), self.compile())
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,104 @@
+import os
+import unittest
+
+from Cython.Compiler import ParallelFunctions
+from Cython.Compiler.Main import compile, CompilationOptions, default_options
+from Cython.TestUtils import FileTestCase
+
+
+code = u'''
+cimport cython
+
+cdef class Point:
+    cdef double x, y
+    def __init__(self, x=0.0, y=0.0):
+        self.x, self.y = x, y
+    cpdef double norm(self):
+        return (self.x ** 2 + self.y ** 2) ** 0.5
+
+def constants(a):
+    return (1, 2, "three"), u"four", b"five", a[1:2], 123456789012345
+
+def calls(*args, **kwargs):
+    return len(args), sorted(kwargs), abs(-1), isinstance(args, tuple)
+
+@cython.boundscheck(False)
+def loop(list items, int n):
+    cdef int i
+    total = 0
+    for i in range(n):
+        total += items[i]
+    return total
+
+class Plain(object):
+    "doc"
+    def method(self, value=(1, 2)):
+        return repr(value), "a string constant that is not a nice name"
+
+def gen(n):
+    for i in range(n):
+        yield i, "three"
+
+cdef int twice(int n) except -1:
+    return n * 2
+'''
+
+
+class TestParallelFunctions(FileTestCase):
+
+    directory_prefix = 'cython_parallel_functions_'
+
+    def setUp(self):
+        FileTestCase.setUp(self)
+        self.write('functions.pyx', code.encode('ascii'), 'wb')
+        self.merge = ParallelFunctions.FunctionJobs.merge
+        self.merged = []
+        def merge(function_jobs, index, writer):
+            result = self.merge(function_jobs, index, writer)
+            self.merged.append(result)
+            return result
+        ParallelFunctions.FunctionJobs.merge = merge
+
+    def tearDown(self):
+        ParallelFunctions.FunctionJobs.merge = self.merge
+        FileTestCase.tearDown(self)
+
+    def compile(self, **kwargs):
+        options = CompilationOptions(default_options, **kwargs)
+        options.output_file = self.path('functions.c')
+        result = compile(self.path('functions.pyx'), options)
+        self.assertEqual(0, result.num_errors)
+        # skip the first line with the timestamp
+        return self.read('functions.c').splitlines()[1:]
+
+    def test_same_code(self):
+        serial = self.compile()
+        self.assertEqual([], self.merged)
+        for jobs in (2, 3):
+            del self.merged[:]
+            self.assertEqual(serial, self.compile(function_jobs=jobs))
+            self.assert_(self.merged)
+            self.assert_(True in self.merged)
+
+    def test_split_c(self):
+        serial = self.compile(split_c=2)
+        self.assertEqual(serial, self.compile(split_c=2, function_jobs=2))
+
+    def test_rename(self):
+        jobs = ParallelFunctions.FunctionJobs([], None, None, None)
+        jobs.cnames = {'__pyx_k_tuple_1000000001': '__pyx_k_tuple_3',
+                       '__pyx_kp_s_2000000002': '__pyx_kp_s_5'}
+        jobs.filenames = {1000000000: 1}
+        self.assertEqual(
+            '__pyx_k_tuple_3 = PyTuple_Pack(1, __pyx_kp_s_5); '
+            '__pyx_filename = __pyx_f[1]; __pyx_int_12345678901;',
+            jobs.rename(
+                '__pyx_k_tuple_1000000001 = PyTuple_Pack(1, __pyx_kp_s_2000000002); '
+                '__pyx_filename = __pyx_f[1000000000]; __pyx_int_12345678901;'))
+
+
+if not hasattr(os, 'fork'):
+    del TestParallelFunctions
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,92 @@
+import os
+import unittest
+
+from Cython.Compiler import PxdCache
+from Cython.Compiler.Main import compile, CompilationOptions, default_options
+from Cython.TestUtils import FileTestCase
+
+
+class TestPxdCache(FileTestCase):
+
+    directory_prefix = 'cython_pxd_cache_'
+
+    def setUp(self):
+        FileTestCase.setUp(self)
+        self.cache = self.path('cache')
+        # count the trees that are loaded from the cache
+        self.replayed = []
+        self.replay = replay = PxdCache.CachedPxdTree.__dict__['replay']
+        def counting_replay(stage, tree, *args):
+            self.replayed.append(stage.module_name)
+            return replay(stage, tree, *args)
+        PxdCache.CachedPxdTree.replay = counting_replay
+        self.write('cached_decls.pxd', '''
+include "cached_consts.pxi"
+cdef struct Point:
+    double x, y
+cdef inline int size():
+    return SIZE
+''')
+        self.write('cached_consts.pxi', 'DEF SIZE = 5\n')
+        self.write('cached_user.pyx', '''
+from cached_decls cimport Point, size
+def f():
+    cdef Point p = Point(1, 2)
+    return p.x + p.y + size()
+''')
+
+    def tearDown(self):
+        PxdCache.CachedPxdTree.replay = self.replay
+        FileTestCase.tearDown(self)
+
+    def compile(self):
+        options = CompilationOptions(
+            default_options, pxd_cache=self.cache,
+            include_path=[self.directory])
+        options.output_file = self.path('cached_user.c')
+        result = compile(self.path('cached_user.pyx'), options)
+        self.assertEqual(0, result.num_errors)
+        # skip the first line with the timestamp
+        return self.read('cached_user.c').splitlines()[1:]
+
+    def cache_files(self):
+        return [name for name in os.listdir(self.cache)
+                if name.startswith('cached_decls-')]
+
+    def test_reuse(self):
+        code = self.compile()
+        self.assertEqual(1, len(self.cache_files()))
+        self.assertEqual([], self.replayed)
+        self.assertEqual(code, self.compile())
+        self.assertEqual(1, len(self.cache_files()))
+        self.assertEqual(['cached_decls'], self.replayed)
+
+    def test_include_change(self):
+        code = self.compile()
+        self.write('cached_consts.pxi', 'DEF SIZE = 7\n')
+        new_code = self.compile()
+        self.assertNotEqual(code, new_code)
+        self.assert_('__pyx_r = 7;' in ''.join(new_code))
+
+    def test_pxd_change(self):
+        self.compile()
+        self.write('cached_decls.pxd', '''
+include "cached_consts.pxi"
+cdef struct Point:
+    double x, y
+cdef inline int size():
+    return SIZE + 1
+''')
+        self.compile()
+        self.assertEqual(2, len(self.cache_files()))
+
+    def test_corrupt_cache_file(self):
+        code = self.compile()
+        self.write(os.path.join('cache', self.cache_files()[0]),
+                   'corrupt'.encode('ASCII'), 'wb')
+        self.assertEqual(code, self.compile())
+        self.assertEqual([], self.replayed)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,119 @@
+import os
+import sys
+import time
+import unittest
+import subprocess
+
+import Cython
+from Cython.Compiler import Server, Options
+from Cython.Compiler.Main import CompilationOptions, default_options
+from Cython.TestUtils import FileTestCase
+
+
+class TestServer(FileTestCase):
+
+    directory_prefix = 'cython_server_'
+
+    def setUp(self):
+        FileTestCase.setUp(self)
+        self.socket_path = self.path('server.sock')
+        env = dict(os.environ)
+        env['PYTHONPATH'] = os.path.dirname(os.path.dirname(os.path.abspath(Cython.__file__)))
+        self.server = subprocess.Popen(
+            [sys.executable, '-c',
+             'from Cython.Compiler.Server import serve; serve(%r)' % self.socket_path],
+            env=env, cwd=self.directory)
+        for _ in range(600):
+            if os.path.exists(self.socket_path) or self.server.poll() is not None:
+                break
+            time.sleep(0.1)
+        self.assert_(os.path.exists(self.socket_path))
+
+    def tearDown(self):
+        if self.server.poll() is None:
+            self.server.terminate()
+            self.server.wait()
+        FileTestCase.tearDown(self)
+
+    def compile(self, name):
+        options = CompilationOptions(default_options, include_path=[self.directory])
+        return Server.compile_on_server(
+            self.path(name), options, socket_path=self.socket_path)
+
+    def test_compile(self):
+        self.write('server_decls.pxd', 'cdef struct Point:\n    double x, y\n')
+        self.write('server_module.pyx', '''
+from server_decls cimport Point
+def f():
+    cdef Point p = Point(1, 2)
+    return p.x + p.y
+''')
+        for _ in range(2):
+            result = self.compile('server_module.pyx')
+            self.assertEqual(0, result.num_errors)
+            self.assertEqual(self.path('server_module.c'), result.c_file)
+            self.assert_(os.path.exists(result.c_file))
+            os.remove(result.c_file)
+
+    def test_errors(self):
+        self.write('server_error.pyx', 'x = 1 +\n')
+        result = self.compile('server_error.pyx')
+        self.assertEqual(1, result.num_errors)
+
+    def test_directive_defaults(self):
+        self.write('server_directives.pyx', 'def f(x):\n    return x[0]\n')
+        old_value = Options.directive_defaults['boundscheck']
+        Options.directive_defaults['boundscheck'] = False
+        try:
+            result = self.compile('server_directives.pyx')
+        finally:
+            Options.directive_defaults['boundscheck'] = old_value
+        self.assertEqual(0, result.num_errors)
+        f = open(result.c_file)
+        try:
+            code = f.read()
+        finally:
+            f.close()
+        self.assert_('__Pyx_PyInt_FromLong, 0, 0, 0);' in code)
+
+    def test_untrusted_directory(self):
+        os.chmod(self.directory, 0777)
+        try:
+            self.write('server_module.pyx', 'x = 1\n')
+            self.assertEqual(None, self.compile('server_module.pyx'))
+        finally:
+            os.chmod(self.directory, 0700)
+
+    def test_no_server(self):
+        self.server.terminate()
+        self.server.wait()
+        self.assert_(not os.path.exists(self.socket_path))
+        self.write('server_module.pyx', 'x = 1\n')
+        self.assertEqual(None, self.compile('server_module.pyx'))
+
+
+class TestServerProtocol(unittest.TestCase):
+
+    def test_plain_data(self):
+        value = {'a': [1, (2, 3.5), None], u'b': {1: True}, 'c': u'\xe9', 'd': '\xff'}
+        plain = Server.to_plain(value)
+        import json
+        self.assertEqual(value, Server.from_plain(json.loads(json.dumps(plain))))
+        self.assertEqual(str, type(Server.from_plain(Server.to_plain('x'))))
+        self.assertRaises(TypeError, Server.to_plain, object())
+
+    def test_opt_in(self):
+        old_value = os.environ.pop(Server.socket_path_variable, None)
+        try:
+            self.assertEqual(None, Server.client_socket_path())
+            self.assert_(Server.client_socket_path(use_server=True))
+            os.environ[Server.socket_path_variable] = '/some/path.sock'
+            self.assertEqual('/some/path.sock', Server.client_socket_path())
+        finally:
+            os.environ.pop(Server.socket_path_variable, None)
+            if old_value is not None:
+                os.environ[Server.socket_path_variable] = old_value
+
+
+if __name__ == '__main__':
+    unittest.main()
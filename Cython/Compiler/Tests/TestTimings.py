@@ -0,0 +1,94 @@
+import unittest
+from time import sleep
+
+from Cython.Compiler import Main, Timings
+from Cython.TestUtils import FileTestCase
+
+
+class TestModuleTimings(unittest.TestCase):
+
+    def tearDown(self):
+        Timings.end_module()
+
+    def test_nested_stages(self):
+        Timings.start_module('test')
+        def inner(data):
+            sleep(0.02)
+            return data
+        def outer(data):
+            Timings.start_pipeline()
+            data = Timings.current.run_pipeline_stage(inner, data)
+            Timings.end_pipeline()
+            return data
+        Timings.start_pipeline()
+        self.assertEqual(1, Timings.current.run_pipeline_stage(outer, 1))
+        self.assertEqual(2, Timings.timed('part', lambda x: x + 1, 1))
+        Timings.end_pipeline()
+        timings = Timings.end_module()
+        self.assertEqual(None, Timings.current)
+        self.assertEqual('test', timings['module'])
+        stages = dict([(stage['name'], stage) for stage in timings['stages']])
+        self.assertEqual(['outer', 'pxd inner', 'part'],
+                         [stage['name'] for stage in timings['stages']])
+        # the time of nested stages is not counted twice
+        self.assert_(stages['pxd inner']['time'] >= 0.02)
+        self.assert_(stages['outer']['time'] < 0.02)
+        self.assertEqual(1, stages['part']['calls'])
+
+    def test_peak_growth(self):
+        peaks = [100, 110, 150, 160]
+        process_peak_memory = Timings.process_peak_memory
+        Timings.process_peak_memory = lambda: peaks.pop(0)
+        try:
+            Timings.start_module('test')
+            Timings.timed('outer', Timings.timed, 'inner', lambda: None)
+            timings = Timings.end_module()
+        finally:
+            Timings.process_peak_memory = process_peak_memory
+        stages = dict([(stage['name'], stage) for stage in timings['stages']])
+        # the growth of nested stages is not counted twice
+        self.assertEqual(40, stages['inner']['peak_growth_kb'])
+        self.assertEqual(20, stages['outer']['peak_growth_kb'])
+        self.assertEqual(150, stages['inner']['process_peak_kb'])
+        self.assertEqual(160, stages['outer']['process_peak_kb'])
+
+    def test_not_recording(self):
+        self.assertEqual(None, Timings.current)
+        self.assertEqual(2, Timings.timed('part', lambda x: x + 1, 1))
+        self.assertEqual(None, Timings.end_module())
+
+    def test_total(self):
+        module = {'module': 'a', 'time': 1.0, 'stages': [
+            {'name': 'parse', 'calls': 1, 'time': 1.0, 'nodes': 10,
+             'peak_growth_kb': 30, 'process_peak_kb': 100}]}
+        total = Timings.total([module, module])
+        self.assertEqual(2.0, total['time'])
+        self.assertEqual([{'name': 'parse', 'calls': 2, 'time': 2.0, 'nodes': 20,
+                           'peak_growth_kb': 60, 'process_peak_kb': 100}], total['stages'])
+
+
+class TestCompileTimings(FileTestCase):
+
+    directory_prefix = 'cython_timings_'
+
+    def test_compile(self):
+        source = self.path('module.pyx')
+        self.write('module.pyx',
+                   'from libc.math cimport sin\ndef f(double x):\n    y = sin(x)\n    return y\n')
+        result = Main.compile(source, timings=True)
+        self.assertEqual(0, result.num_errors)
+        names = [stage['name'] for stage in result.timings['stages']]
+        for name in ('parse', 'pxd parse', 'type inference',
+                     'AnalyseExpressionsTransform', 'OptimizeBuiltinCalls',
+                     'inject_utility_code_stage', 'generate_pyx_code_stage'):
+            self.assert_(name in names, name)
+        parse = result.timings['stages'][0]
+        self.assertEqual('parse', parse['name'])
+        self.assert_(parse['nodes'] > 0)
+
+        result = Main.compile(source)
+        self.assertEqual(None, result.timings)
+
+
+if __name__ == '__main__':
+    unittest.main()
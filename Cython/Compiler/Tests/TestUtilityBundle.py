@@ -0,0 +1,133 @@
+import os
+import shutil
+import unittest
+
+from Cython.Compiler import Code, UtilityBundle
+from Cython.Compiler.UtilityCode import CythonUtilityCode
+from Cython.TestUtils import FileTestCase
+
+
+class TestUtilityBundle(FileTestCase):
+
+    directory_prefix = 'cython_utility_bundle_'
+
+    def setUp(self):
+        FileTestCase.setUp(self)
+        self.bundle_path = self.path('utility.bundle')
+        self.state = (UtilityBundle._utilities,
+                      dict(UtilityBundle.tempita_cache),
+                      dict(UtilityBundle.tree_cache),
+                      dict(Code.UtilityCodeBase._utility_cache))
+
+    def tearDown(self):
+        FileTestCase.tearDown(self)
+        utilities, tempita_cache, tree_cache, utility_cache = self.state
+        UtilityBundle._utilities = utilities
+        for cache, content in [(UtilityBundle.tempita_cache, tempita_cache),
+                               (UtilityBundle.tree_cache, tree_cache),
+                               (Code.UtilityCodeBase._utility_cache, utility_cache)]:
+            cache.clear()
+            cache.update(content)
+
+    def reload(self):
+        UtilityBundle._utilities = None
+        UtilityBundle.tempita_cache.clear()
+        UtilityBundle.tree_cache.clear()
+        Code.UtilityCodeBase._utility_cache.clear()
+        UtilityBundle.load_bundle(self.bundle_path)
+
+    def test_write_and_load(self):
+        UtilityBundle.write_bundle(self.bundle_path)
+        utilities = Code.UtilityCodeBase.load_utilities_from_file('MemoryView_C.c')
+        trees = dict(UtilityBundle.tree_cache)
+        self.assert_(trees)
+
+        self.reload()
+        self.assertEqual(utilities, UtilityBundle.get_utilities('MemoryView_C.c'))
+        self.assertEqual(trees, UtilityBundle.tree_cache)
+        # the module level memoryview utility code is pre-parsed
+        from Cython.Compiler.MemoryView import view_utility_code
+        key = UtilityBundle.tree_key(view_utility_code, view_utility_code.create_context())
+        self.assert_(key in UtilityBundle.tree_cache)
+
+    def test_outdated_bundle(self):
+        UtilityBundle.write_bundle(self.bundle_path)
+        source_signature = UtilityBundle.source_signature
+        UtilityBundle.source_signature = lambda *args: ('other', source_signature(*args))
+        try:
+            self.reload()
+        finally:
+            UtilityBundle.source_signature = source_signature
+        self.assertEqual(None, UtilityBundle.get_utilities('MemoryView_C.c'))
+        self.assertEqual({}, UtilityBundle.tree_cache)
+
+    def test_installed_bundle(self):
+        UtilityBundle.write_bundle(self.bundle_path, installed=True)
+        source_signature = UtilityBundle.source_signature
+        def fail(*args):
+            raise AssertionError("sources read for an installed bundle")
+        UtilityBundle.source_signature = fail
+        try:
+            self.reload()
+        finally:
+            UtilityBundle.source_signature = source_signature
+        self.assert_(UtilityBundle.get_utilities('MemoryView_C.c'))
+
+        version_signature = UtilityBundle.version_signature
+        UtilityBundle.version_signature = lambda: ('other', version_signature())
+        try:
+            self.reload()
+        finally:
+            UtilityBundle.version_signature = version_signature
+        self.assertEqual(None, UtilityBundle.get_utilities('MemoryView_C.c'))
+
+    def test_content_signature(self):
+        utility_dir = self.path('Utility')
+        shutil.copytree(Code.get_utility_dir(), utility_dir)
+        shutil.copytree(os.path.dirname(os.path.abspath(Code.__file__)),
+                        self.path('Compiler'))
+        signature = UtilityBundle.source_signature(utility_dir)
+        self.assertEqual(UtilityBundle.source_signature(), signature)
+
+        # a change of the content is found even if size and time are the same
+        name = os.path.join('Utility', 'ModuleSetupCode.c')
+        st = os.stat(self.path(name))
+        self.write(name, self.read(name, 'rb')[::-1], 'wb')
+        os.utime(self.path(name), (st.st_atime, st.st_mtime))
+        self.assertNotEqual(signature, UtilityBundle.source_signature(utility_dir))
+
+    def test_write_unchanged_bundle(self):
+        UtilityBundle.write_bundle(self.bundle_path)
+        mtime = int(os.stat(self.bundle_path).st_mtime) - 10
+        os.utime(self.bundle_path, (mtime, mtime))
+        UtilityBundle.write_bundle(self.bundle_path)
+        self.assertEqual(mtime, os.stat(self.bundle_path).st_mtime)
+
+    def test_reuse_early_tree(self):
+        utility_code = CythonUtilityCode(u"""
+cdef int twice(int x):
+    return x * 2
+""", name="TestBundleTree")
+        tree = utility_code.get_early_tree()
+        key = UtilityBundle.tree_key(utility_code, utility_code.create_context())
+        self.assert_(key in UtilityBundle.tree_cache)
+        other_tree = utility_code.get_early_tree()
+        self.assert_(other_tree is not tree)
+        self.assertEqual(type(tree.body), type(other_tree.body))
+        self.assert_(other_tree.scope is not None)
+        # the rest of the pipeline runs on the cached tree
+        tree = utility_code.get_tree()
+        self.assert_('twice' in tree.scope.entries)
+
+    def test_tempita_cache(self):
+        template = u"{{value}} + {{value}}"
+        self.assertEqual(u"1 + 1", Code.sub_tempita(template, dict(value=1)))
+        key = UtilityBundle.tempita_key(template, dict(value=1))
+        self.assertEqual(u"1 + 1", UtilityBundle.tempita_cache[key])
+        self.assertEqual(u"2 + 2", Code.sub_tempita(template, dict(value=2)))
+        # contexts with arbitrary objects are not cached
+        self.assertEqual(None, UtilityBundle.tempita_key(template, dict(value=object())))
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -1,7 +1,9 @@
+import unittest
+
 from Cython.Compiler.ModuleNode import ModuleNode
 from Cython.Compiler.Symtab import ModuleScope
 from Cython.TestUtils import TransformTest
-from Cython.Compiler.Visitor import MethodDispatcherTransform
+from Cython.Compiler.Visitor import MethodDispatcherTransform, TreeVisitor, get_dispatch_table
 from Cython.Compiler.ParseTreeTransforms import (
     NormalizeTree, AnalyseDeclarationsTransform,
     AnalyseExpressionsTransform, InterpretCompilerDirectives)
@@ -59,3 +61,52 @@ class TestMethodDispatcherTransform(TransformTest):
         Test(None)(tree)
         self.assertEqual(1, calls['bytes'])
         self.assertEqual(0, calls['object'])
+
+
+class SampleNode(object):
+    child_attrs = ['body']
+    def __init__(self, body=None):
+        self.body = body
+
+class OtherNode(SampleNode):
+    pass
+
+
+class TestDispatchTable(unittest.TestCase):
+
+    class Collector(TreeVisitor):
+        def __init__(self):
+            TreeVisitor.__init__(self)
+            self.visited = []
+        def visit_SampleNode(self, node):
+            self.visited.append('sample')
+            self.visitchildren(node)
+
+    class OtherCollector(Collector):
+        def visit_OtherNode(self, node):
+            self.visited.append('other')
+            self.visitchildren(node)
+
+    tree = SampleNode([OtherNode(), SampleNode(OtherNode())])
+
+    def test_dispatch(self):
+        collector = self.Collector()
+        collector.visit(self.tree)
+        self.assertEqual(['sample'] * 4, collector.visited)
+        collector = self.OtherCollector()
+        collector.visit(self.tree)
+        self.assertEqual(['sample', 'other', 'sample', 'other'], collector.visited)
+
+    def test_shared_table(self):
+        first, second = self.Collector(), self.Collector()
+        first.visit(self.tree)
+        second.visit(self.tree)
+        self.assertEqual(first.visited, second.visited)
+        # filled by the first instance, and not shared with subclasses
+        table = get_dispatch_table(self.Collector)
+        self.assertEqual(set([SampleNode, OtherNode]), set(table))
+        self.assert_(table is not get_dispatch_table(self.OtherCollector))
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,255 @@
+#
+#   Timings of the compiler stages
+#
+#   With the 'timings' option, the compiler records the wall time, the
+#   growth of the peak memory use of the process and the number of tree
+#   nodes after each stage of the pipeline of a module.  The stages of the
+#   pipelines of cimported .pxd files and some parts of the stages (like
+#   type inference) are recorded separately, their time and memory growth
+#   are not included in the stage that ran them.
+#
+#   The peak memory use (ru_maxrss) is that of the whole process, so it
+#   includes whatever the process did before, like compiling other modules.
+#   A stage only shows a growth if it raised the peak.
+#
+
+import sys
+from time import time
+
+try:
+    import resource
+except ImportError:
+    resource = None
+
+# the recorder of the module that is currently compiled, or None
+current = None
+
+
+def process_peak_memory():
+    # peak resident set size of the whole process in kB, or None
+    if resource is None:
+        return None
+    peak = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+    if sys.platform == 'darwin':
+        peak //= 1024   # bytes
+    return peak
+
+def count_nodes(tree):
+    count = 0
+    stack = [tree]
+    while stack:
+        node = stack.pop()
+        count += 1
+        for attr in node.child_attrs:
+            child = getattr(node, attr, None)
+            if child is None:
+                continue
+            if type(child) is list:
+                stack.extend([x for x in child if x is not None])
+            else:
+                stack.append(child)
+    return count
+
+def stage_name(stage):
+    name = getattr(stage, '__name__', None)
+    if name is None:
+        name = stage.__class__.__name__
+    return name
+
+
+class Stage(object):
+    # The timings of a stage (or part of one), summed over its calls.
+    #
+    # name            string
+    # calls           integer
+    # time            float     seconds, without the stages that it ran
+    # nodes           integer   number of tree nodes after the last call, or None
+    # peak_growth     integer   kB by which the calls raised the peak memory
+    #                           use of the process, without the stages that
+    #                           they ran, or None
+    # process_peak    integer   peak memory use of the process after the last
+    #                           call in kB, or None
+
+    def __init__(self, name):
+        self.name = name
+        self.calls = 0
+        self.time = 0.0
+        self.nodes = None
+        self.peak_growth = None
+        self.process_peak = None
+
+    def add(self, other):
+        self.calls += other.calls
+        self.time += other.time
+        if other.nodes is not None:
+            self.nodes = (self.nodes or 0) + other.nodes
+        if other.peak_growth is not None:
+            self.peak_growth = (self.peak_growth or 0) + other.peak_growth
+        if other.process_peak is not None:
+            self.process_peak = max(self.process_peak or 0, other.process_peak)
+
+    def as_dict(self):
+        return {'name': self.name, 'calls': self.calls, 'time': self.time,
+                'nodes': self.nodes, 'peak_growth_kb': self.peak_growth,
+                'process_peak_kb': self.process_peak}
+
+
+class ModuleTimings(object):
+    """
+    Records the stages of the compilation of a module.
+    """
+    def __init__(self, module_name):
+        self.module_name = module_name
+        self.stages = []
+        self.stage_dict = {}
+        # [start time, time of nested stages,
+        #  process peak at the start, peak growth of nested stages]
+        self.running = []
+        self.pipeline_depth = 0
+
+    def get_stage(self, name):
+        stage = self.stage_dict.get(name)
+        if stage is None:
+            stage = self.stage_dict[name] = Stage(name)
+            self.stages.append(stage)
+        return stage
+
+    def run(self, name, func, args):
+        stage = self.get_stage(name)
+        running = self.running
+        frame = [time(), 0.0, process_peak_memory(), 0]
+        running.append(frame)
+        try:
+            result = func(*args)
+        finally:
+            running.pop()
+            elapsed = time() - frame[0]
+            peak = process_peak_memory()
+            if running:
+                running[-1][1] += elapsed
+            stage.calls += 1
+            stage.time += elapsed - frame[1]
+            if peak is not None:
+                growth = peak - frame[2]
+                if running:
+                    running[-1][3] += growth
+                stage.peak_growth = (stage.peak_growth or 0) + growth - frame[3]
+                stage.process_peak = peak
+        return result
+
+    def run_pipeline_stage(self, phase, data):
+        name = stage_name(phase)
+        if self.pipeline_depth > 1:
+            name = 'pxd ' + name
+        data = self.run(name, phase, (data,))
+        if hasattr(data, 'child_attrs'):
+            start = time()
+            self.get_stage(name).nodes = count_nodes(data)
+            if self.running:
+                # not part of the stage that is running this pipeline
+                self.running[-1][1] += time() - start
+        return data
+
+    def as_dict(self):
+        return {'module': self.module_name,
+                'time': sum([stage.time for stage in self.stages]),
+                'stages': [stage.as_dict() for stage in self.stages]}
+
+
+def start_module(module_name):
+    global current
+    current = ModuleTimings(module_name)
+
+def end_module():
+    """
+    Stop recording, and return the timings of the module as a dict
+    (which can be sent between processes).
+    """
+    global current
+    timings, current = current, None
+    if timings is None:
+        return None
+    return timings.as_dict()
+
+def start_pipeline():
+    if current is not None:
+        current.pipeline_depth += 1
+
+def end_pipeline():
+    if current is not None:
+        current.pipeline_depth -= 1
+
+def timed(name, func, *args):
+    """
+    Call func(*args), and record its time as part of the given name
+    if timings are recorded.
+    """
+    if current is None:
+        return func(*args)
+    return current.run(name, func, args)
+
+
+#
+#   Reports
+#
+
+def total(module_timings):
+    stages = []
+    stage_dict = {}
+    for module in module_timings:
+        for data in module['stages']:
+            stage = stage_dict.get(data['name'])
+            if stage is None:
+                stage = stage_dict[data['name']] = Stage(data['name'])
+                stages.append(stage)
+            other = Stage(data['name'])
+            other.calls = data['calls']
+            other.time = data['time']
+            other.nodes = data['nodes']
+            other.peak_growth = data['peak_growth_kb']
+            other.process_peak = data['process_peak_kb']
+            stage.add(other)
+    return {'module': None,
+            'time': sum([stage.time for stage in stages]),
+            'stages': [stage.as_dict() for stage in stages]}
+
+def format_timings(timings, title):
+    def megabytes(kb):
+        if kb is None:
+            return ''
+        return '%.1f' % (kb / 1024.0)
+    lines = ['%s: %.3f s' % (title, timings['time']),
+             '  %-40s %6s %9s %8s %11s %16s' % (
+                'stage', 'calls', 'time (s)', 'nodes', 'peak + (MB)', 'proc. peak (MB)')]
+    for stage in timings['stages']:
+        nodes = stage['nodes']
+        lines.append('  %-40s %6d %9.3f %8s %11s %16s' % (
+            stage['name'], stage['calls'], stage['time'],
+            nodes is not None and nodes or '',
+            megabytes(stage['peak_growth_kb']),
+            megabytes(stage['process_peak_kb'])))
+    return '\n'.join(lines) + '\n'
+
+def report(module_timings, destination=True):
+    """
+    Report the timings of the given modules and their total, either
+    as text on stderr or, if the destination is a file name, as JSON.
+    """
+    module_timings = [timings for timings in module_timings if timings]
+    if not module_timings:
+        return
+    result = {'modules': module_timings, 'total': total(module_timings)}
+    if destination is True:
+        for timings in module_timings:
+            sys.stderr.write(format_timings(
+                timings, "Timings of module '%s'" % timings['module']))
+        if len(module_timings) > 1:
+            sys.stderr.write(format_timings(
+                result['total'], 'Total of %d modules' % len(module_timings)))
+    else:
+        import json
+        f = open(destination, 'w')
+        try:
+            json.dump(result, f, indent=1, sort_keys=True)
+        finally:
+            f.close()
@@ -36,7 +36,8 @@ class MarkParallelAssignments(EnvTransform):
                 # TODO: This shouldn't happen...
                 return
 
-            if self.parallel_block_stack:
+            # atomic variables stay shared in parallel blocks
+            if self.parallel_block_stack and not lhs.entry.type.is_atomic:
                 parallel_node = self.parallel_block_stack[-1]
                 previous_assignment = parallel_node.assignments.get(lhs.entry)
 
@@ -454,6 +455,8 @@ def aggressive_spanning_type(types, might_overflow, pos):
         result_type = result_type.ref_base_type
     if result_type.is_const:
         result_type = result_type.const_base_type
+    if result_type.is_atomic:
+        result_type = result_type.typedef_base_type
     if result_type.is_cpp_class:
         result_type.check_nullary_constructor(pos)
     return result_type
@@ -464,6 +467,8 @@ def safe_spanning_type(types, might_overflow, pos):
         result_type = result_type.const_base_type
     if result_type.is_reference:
         result_type = result_type.ref_base_type
+    if result_type.is_atomic:
+        result_type = result_type.typedef_base_type
     if result_type.is_cpp_class:
         result_type.check_nullary_constructor(pos)
     if result_type.is_pyobject:
@@ -0,0 +1,283 @@
+#
+#   Bundle of the pre-processed utility code files
+#
+#   Every compiler run splits the utility code files into their
+#   sections, substitutes the names in them, specialises the templated
+#   sections with Tempita and parses the utility code that is written
+#   in Cython.  As the result is the same in every run, a bundle that
+#   is written at build time (by setup.py into the build directory, or
+#   by running this module) stores
+#
+#     - the sections of each utility code file with their tags (which
+#       include the names of the utility code that they require),
+#     - the Tempita output for the contexts that the compiler modules
+#       use at import time,
+#     - the pickled trees of the module level Cython utility code after
+#       the scope independent stages at the start of its pipeline.
+#
+#   The bundle is loaded with a single read when the utility code is
+#   first needed.  It is ignored if it was written by another version
+#   of Cython or Python.  The bundle that setup.py writes is marked as
+#   installed: the installed sources are not edited in place, so it is
+#   used without reading them.  Other bundles, as in a source checkout,
+#   are ignored if the content of the utility code or compiler sources
+#   differs from the sources they were written from.
+#
+#   The in-process caches work without a bundle: a template is only
+#   specialised again for a new context, and Cython utility code is
+#   only parsed once per process.
+#
+
+import os
+import sys
+
+try:
+    import cPickle as pickle
+except ImportError:
+    import pickle
+
+# the bundle is read from bytes, also in Python 3
+if sys.version_info[0] >= 3:
+    from io import BytesIO
+else:
+    try:
+        from cStringIO import StringIO as BytesIO
+    except ImportError:
+        from StringIO import StringIO as BytesIO
+
+try:
+    from hashlib import md5 as hash_function
+except ImportError:
+    from md5 import new as hash_function
+
+from Cython.Compiler import Version
+from Cython.Utils import write_file_atomically
+
+bundle_name = 'utility.bundle'
+
+# maps utility code file names to their sections, None if not loaded yet
+_utilities = None
+
+# maps keys of (template, context) to the Tempita output
+tempita_cache = {}
+
+# maps keys of Cython utility code to its pickled early tree
+tree_cache = {}
+
+
+def get_bundle_path():
+    from Cython.Compiler import Code
+    return os.path.join(Code.get_utility_dir(), bundle_name)
+
+def source_signature(utility_dir=None):
+    """
+    Return the signature of the utility code files in the given
+    directory and of the compiler sources next to it, based on their
+    content.
+    """
+    from Cython.Compiler import Code
+    if utility_dir is None:
+        utility_dir = Code.get_utility_dir()
+    directories = [
+        (utility_dir, ('.c', '.cpp', '.h', '.pyx', '.pxd')),
+        (os.path.join(os.path.dirname(utility_dir), 'Compiler'), ('.py', '.pxd')),
+        ]
+    content_hash = hash_function()
+    for directory, extensions in directories:
+        for filename in sorted(os.listdir(directory)):
+            if os.path.splitext(filename)[1] in extensions:
+                f = open(os.path.join(directory, filename), 'rb')
+                try:
+                    data = f.read()
+                finally:
+                    f.close()
+                content_hash.update(('%s:%d:' % (filename, len(data))).encode('ASCII'))
+                content_hash.update(data)
+    return version_signature() + (content_hash.hexdigest(),)
+
+def version_signature():
+    return (Version.version, tuple(sys.version_info[:2]))
+
+def read_header(path):
+    """
+    Return the (signature, installed) header that the bundle at the
+    given path was written with, or None if there is no readable bundle.
+    """
+    try:
+        f = open(path, 'rb')
+    except IOError:
+        return None
+    try:
+        try:
+            return pickle.load(f)
+        finally:
+            f.close()
+    except Exception:
+        return None
+
+def load_bundle(path=None):
+    """
+    Load the bundle (once per process), ignoring it if it does not
+    match the current compiler.
+    """
+    global _utilities
+    if _utilities is not None:
+        return
+    _utilities = {}
+    if path is None:
+        path = get_bundle_path()
+    try:
+        f = open(path, 'rb')
+    except IOError:
+        return
+    try:
+        try:
+            data = BytesIO(f.read())
+        finally:
+            f.close()
+        # the header is pickled before the bundle
+        signature, installed = pickle.load(data)
+        if installed:
+            if signature[:2] != version_signature():
+                return
+        elif signature != source_signature():
+            return
+        bundle = pickle.load(data)
+        _utilities.update(bundle['utilities'])
+        tempita_cache.update(bundle['tempita'])
+        tree_cache.update(bundle['trees'])
+    except Exception:
+        # the utility code is then read from its files
+        pass
+
+def get_utilities(path):
+    """
+    Return the sections of the given utility code file, or None if
+    they are not in the bundle.
+    """
+    from Cython.Compiler import Code
+    load_bundle()
+    utility_dir, filename = os.path.split(os.path.join(Code.get_utility_dir(), path))
+    if utility_dir != Code.get_utility_dir():
+        return None
+    return _utilities.get(filename)
+
+
+def _is_simple(value):
+    if isinstance(value, (basestring, int, long, float, bool, type(None))):
+        return True
+    if isinstance(value, (list, tuple)):
+        for item in value:
+            if not _is_simple(item):
+                return False
+        return True
+    if isinstance(value, dict):
+        return _is_simple(value.items())
+    return False
+
+def tempita_key(template, context):
+    # The key of the Tempita output for this context, or None if the
+    # context has values whose representation is not their content.
+    items = sorted(context.items())
+    if not _is_simple(items):
+        return None
+    return hash_function(repr((template, items)).encode('UTF-8')).hexdigest()
+
+
+def tree_key(utility_code, context):
+    from Cython.Compiler import PxdCache
+    key = repr((
+        Version.version,
+        utility_code.impl,
+        utility_code.name,
+        utility_code.prefix,
+        sorted(context.compiler_directives.items()),
+        PxdCache.option_values(),
+        ))
+    return hash_function(key.encode('UTF-8')).hexdigest()
+
+def load_tree(key):
+    from Cython.Compiler import PxdCache
+    data = tree_cache.get(key)
+    if data is None:
+        return None
+    try:
+        # the tree stays pickled in the cache, every caller gets its own
+        return PxdCache.load_tree(BytesIO(data))
+    except Exception:
+        del tree_cache[key]
+        return None
+
+def store_tree(key, tree):
+    from Cython.Compiler import PxdCache
+    scope, tree.scope = tree.scope, None
+    try:
+        f = BytesIO()
+        try:
+            PxdCache.TreePickler(f).dump(tree)
+        except (pickle.PicklingError, TypeError, RuntimeError):
+            return
+        tree_cache[key] = f.getvalue()
+    finally:
+        tree.scope = scope
+
+
+def module_utility_code():
+    # the Cython utility code that the compiler modules create at import time
+    from Cython.Compiler import MemoryView, CythonScope
+    from Cython.Compiler.UtilityCode import CythonUtilityCode
+    found = []
+    seen = set()
+    todo = []
+    for name, module in sorted(sys.modules.items()):
+        if module is not None and name.startswith('Cython.Compiler.'):
+            todo.extend(vars(module).values())
+    while todo:
+        value = todo.pop()
+        if id(value) in seen or not isinstance(value, CythonUtilityCode):
+            continue
+        seen.add(id(value))
+        found.append(value)
+        todo.extend(value.requires or ())
+    return found
+
+def write_bundle(path=None, utility_dir=None, installed=False):
+    """
+    Write a bundle for the current sources, unless the bundle at the
+    given path was already written from the same content.  The
+    signature is taken from the utility code files in utility_dir (by
+    default those of this compiler), which lets setup.py sign the
+    bundle with the copies in the build directory that get installed.
+    An installed bundle is loaded without checking the sources.
+    """
+    from Cython.Compiler import Code
+    if path is None:
+        path = get_bundle_path()
+    header = (source_signature(utility_dir), installed)
+    if read_header(path) == header:
+        return path
+    load_bundle()
+    utility_dir = Code.get_utility_dir()
+    utilities = {}
+    for filename in sorted(os.listdir(utility_dir)):
+        if os.path.splitext(filename)[1] in ('.c', '.cpp', '.pyx'):
+            utilities[filename] = Code.UtilityCodeBase.load_utilities_from_file(filename)
+    for utility_code in module_utility_code():
+        utility_code.get_early_tree()
+
+    bundle = {
+        'utilities': utilities,
+        'tempita': tempita_cache,
+        'trees': tree_cache,
+        }
+    def write(f):
+        pickle.dump(header, f, pickle.HIGHEST_PROTOCOL)
+        pickle.dump(bundle, f, pickle.HIGHEST_PROTOCOL)
+    write_file_atomically(path, write)
+    return path
+
+
+if __name__ == '__main__':
+    # python -m Cython.Compiler.UtilityBundle [path]
+    from Cython.Compiler.UtilityBundle import write_bundle
+    print("Wrote %s" % write_bundle(sys.argv[1:] and sys.argv[1] or None))
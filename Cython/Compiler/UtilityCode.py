@@ -2,6 +2,7 @@ from TreeFragment import parse_from_strings, StringParseContext
 import Symtab
 import Naming
 import Code
+import UtilityBundle
 
 class NonManglingModuleScope(Symtab.ModuleScope):
 
@@ -82,7 +83,14 @@ class CythonUtilityCode(Code.UtilityCodeBase):
         self.requires = requires or []
         self.from_scope = from_scope
 
-    def get_tree(self, entries_only=False, cython_scope=None):
+    def create_context(self, cython_scope=None):
+        context = CythonUtilityCodeContext(self.name)
+        context.prefix = self.prefix
+        context.cython_scope = cython_scope
+        #context = StringParseContext(self.name)
+        return context
+
+    def create_pipeline(self, context, entries_only=False):
         from AnalysedTreeTransforms import AutoTestDictTransform
         # The AutoTestDictTransform creates the statement "__test__ = {}",
         # which when copied into the main ModuleNode overwrites
@@ -90,12 +98,6 @@ class CythonUtilityCode(Code.UtilityCodeBase):
         excludes = [AutoTestDictTransform]
 
         import Pipeline, ParseTreeTransforms
-        context = CythonUtilityCodeContext(self.name)
-        context.prefix = self.prefix
-        context.cython_scope = cython_scope
-        #context = StringParseContext(self.name)
-        tree = parse_from_strings(self.name, self.impl, context=context,
-                                  allow_struct_enum_decorator=True)
         pipeline = Pipeline.create_pipeline(context, 'pyx', exclude_classes=excludes)
 
         if entries_only:
@@ -123,6 +125,46 @@ class CythonUtilityCode(Code.UtilityCodeBase):
             pipeline = Pipeline.insert_into_pipeline(pipeline, scope_transform,
                                                      before=transform)
 
+        # the stages before ForwardDeclareTypes do not depend on the scope
+        for i, stage in enumerate(pipeline):
+            if isinstance(stage, ParseTreeTransforms.ForwardDeclareTypes):
+                break
+        return pipeline[:i], pipeline[i:]
+
+    def get_early_tree(self, context=None, early_stages=None):
+        """
+        Parse the code and run the scope independent stages at the start
+        of its pipeline.  The result is reused for the same code.
+        """
+        import Pipeline
+        if context is None:
+            context = self.create_context()
+        if early_stages is None:
+            early_stages = self.create_pipeline(context)[0]
+
+        key = UtilityBundle.tree_key(self, context)
+        tree = UtilityBundle.load_tree(key)
+        if tree is not None:
+            # repeat the side effects of parsing the code
+            tree.scope = context.find_module(self.name, pos=(self.name, 1, 0),
+                                             need_pxd=0)
+            return tree
+
+        tree = parse_from_strings(self.name, self.impl, context=context,
+                                  allow_struct_enum_decorator=True)
+        future_directives = set(context.future_directives)
+        (err, tree) = Pipeline.run_pipeline(early_stages, tree, printtree=False)
+        assert not err, err
+        if context.future_directives == future_directives:
+            UtilityBundle.store_tree(key, tree)
+        return tree
+
+    def get_tree(self, entries_only=False, cython_scope=None):
+        import Pipeline
+        context = self.create_context(cython_scope)
+        early_stages, pipeline = self.create_pipeline(context, entries_only)
+        tree = self.get_early_tree(context, early_stages)
+
         (err, tree) = Pipeline.run_pipeline(pipeline, tree, printtree=False)
         assert not err, err
         return tree
@@ -13,6 +13,18 @@ import DebugFlags
 
 import cython
 
+# The dispatch tables of the visitor classes, mapping node classes to the
+# (unbound) visit_* methods that handle them.  They are shared by all
+# instances of a visitor class and filled on demand.
+_dispatch_tables = {}
+
+def get_dispatch_table(visitor_class):
+    table = _dispatch_tables.get(visitor_class)
+    if table is None:
+        table = _dispatch_tables[visitor_class] = {}
+    return table
+
+
 class TreeVisitor(object):
     """
     Base class for writing visitors for a Cython tree, contains utilities for
@@ -58,7 +70,7 @@ class TreeVisitor(object):
     """
     def __init__(self):
         super(TreeVisitor, self).__init__()
-        self.dispatch_table = {}
+        self.dispatch_table = get_dispatch_table(type(self))
         self.access_path = []
 
     def dump_node(self, node, indent=0):
@@ -144,9 +156,10 @@ class TreeVisitor(object):
         mro = inspect.getmro(cls)
         handler_method = None
         for mro_cls in mro:
-            handler_method = getattr(self, pattern % mro_cls.__name__, None)
+            handler_method = getattr(type(self), pattern % mro_cls.__name__, None)
             if handler_method is not None:
-                return handler_method
+                # the plain function of an unbound method
+                return getattr(handler_method, '__func__', handler_method)
         print type(self), cls
         if self.access_path:
             print self.access_path
@@ -165,7 +178,7 @@ class TreeVisitor(object):
             except KeyError:
                 handler_method = self.find_handler(obj)
                 self.dispatch_table[type(obj)] = handler_method
-            return handler_method(obj)
+            return handler_method(self, obj)
         except Errors.CompileError:
             raise
         except Errors.AbortError:
@@ -186,7 +199,7 @@ class TreeVisitor(object):
         return self._visitchildren(parent, attrs)
 
     @cython.final
-    @cython.locals(idx=int)
+    @cython.locals(idx=int, access_path=list)
     def _visitchildren(self, parent, attrs):
         """
         Visits the children of the given parent. If parent is None, returns
@@ -199,16 +212,24 @@ class TreeVisitor(object):
         """
         if parent is None: return None
         result = {}
+        access_path = self.access_path
         for attr in parent.child_attrs:
             if attrs is not None and attr not in attrs: continue
             child = getattr(parent, attr)
-            if child is not None:
-                if type(child) is list:
-                    childretval = [self._visitchild(x, parent, attr, idx) for idx, x in enumerate(child)]
-                else:
-                    childretval = self._visitchild(child, parent, attr, None)
-                    assert not isinstance(childretval, list), 'Cannot insert list here: %s in %r' % (attr, parent)
-                result[attr] = childretval
+            if child is None:
+                continue
+            if type(child) is list:
+                childretval = []
+                for idx, x in enumerate(child):
+                    access_path.append((parent, attr, idx))
+                    childretval.append(self._visit(x))
+                    access_path.pop()
+            else:
+                access_path.append((parent, attr, None))
+                childretval = self._visit(child)
+                access_path.pop()
+                assert not isinstance(childretval, list), 'Cannot insert list here: %s in %r' % (attr, parent)
+            result[attr] = childretval
         return result
 
 
@@ -23,6 +23,10 @@ extension_name_re = _build_ext.extension_name_re
 
 show_compilers = _build_ext.show_compilers
 
+# the start of a generated C file, read as bytes for the fingerprint
+generated_header = '/* Generated by Cython '.encode('ASCII')
+newline = '\n'.encode('ASCII')
+
 class Optimization(object):
     def __init__(self):
         self.flags = (
@@ -56,6 +60,41 @@ class Optimization(object):
 optimization = Optimization()
 
 
+def cpu_count():
+    try:
+        import multiprocessing
+        return multiprocessing.cpu_count()
+    except (ImportError, NotImplementedError):
+        return 1
+
+def parallel_compile(compile, jobs):
+    """
+    Wrap the 'compile' method of a CCompiler to compile the source
+    files in several threads (the work is done by compiler processes).
+    """
+    try:
+        from multiprocessing.pool import ThreadPool
+    except ImportError:
+        return compile
+
+    def compile_sources(sources, *args, **kwds):
+        if len(sources) < 2:
+            return compile(sources, *args, **kwds)
+        def compile_source(source):
+            return compile([source], *args, **kwds)
+        pool = ThreadPool(min(jobs, len(sources)))
+        try:
+            objects = pool.map(compile_source, sources)
+        finally:
+            pool.close()
+            pool.join()
+        result = []
+        for source_objects in objects:
+            result.extend(source_objects)
+        return result
+    return compile_sources
+
+
 class build_ext(_build_ext.build_ext):
 
     description = "build C/C++ and Cython extensions (compile/link to build directory)"
@@ -85,6 +124,12 @@ class build_ext(_build_ext.build_ext):
          "generate debug information for cygdb"),
         ('cython-compile-time-env', None,
             "cython compile time environment"),
+        ('cython-cache=', None,
+            "directory for caching compiled extension modules"),
+        ('cython-split-c=', None,
+            "split each generated C file into this many files"),
+        ('cython-c-jobs=', None,
+            "number of C files of an extension to compile in parallel"),
             
         # For backwards compatibility.
         ('pyrex-cplus', None,
@@ -126,6 +171,9 @@ class build_ext(_build_ext.build_ext):
         self.cython_gdb = False
         self.no_c_in_traceback = 0
         self.cython_compile_time_env = None
+        self.cython_cache = None
+        self.cython_split_c = None
+        self.cython_c_jobs = None
     
     def __getattr__(self, name):
         if name[:6] == 'pyrex_':
@@ -149,6 +197,10 @@ class build_ext(_build_ext.build_ext):
                 self.cython_include_dirs.split(os.pathsep)
         if self.cython_directives is None:
             self.cython_directives = {}
+        if self.cython_split_c is not None:
+            self.cython_split_c = int(self.cython_split_c)
+        if self.cython_c_jobs is not None:
+            self.cython_c_jobs = int(self.cython_c_jobs)
     # finalize_options ()
 
     def run(self):
@@ -170,6 +222,106 @@ class build_ext(_build_ext.build_ext):
             ext.sources = self.cython_sources(ext.sources, ext)
             self.build_extension(ext)
 
+    def c_jobs(self, ext):
+        """
+        The number of C files of the extension to compile in parallel.
+        Without --cython-c-jobs, only split modules use all CPUs.
+        """
+        if self.cython_c_jobs is not None:
+            return self.cython_c_jobs
+        from Cython.Compiler.CodeSplitting import part_files
+        for source in ext.sources:
+            if part_files(source):
+                return cpu_count()
+        return 1
+
+    def build_extension(self, ext):
+        jobs = self.c_jobs(ext)
+        if jobs > 1 and len(ext.sources) > 1:
+            compile = self.compiler.compile
+            self.compiler.compile = parallel_compile(compile, jobs)
+            try:
+                self.build_cached_extension(ext)
+            finally:
+                self.compiler.compile = compile
+        else:
+            self.build_cached_extension(ext)
+
+    def build_cached_extension(self, ext):
+        cache_dir = self.cython_cache or getattr(ext, 'cython_cache', None)
+        if not cache_dir:
+            return _build_ext.build_ext.build_extension(self, ext)
+
+        from Cython.Build.Cache import ArtifactCache
+        cache = ArtifactCache(cache_dir)
+        fullname = self.get_ext_fullname(ext.name)
+        if self.inplace or not hasattr(self, 'get_ext_fullpath'):
+            ext_path = self.get_ext_fullpath(ext.name)
+        else:
+            ext_path = os.path.join(self.build_lib, self.get_ext_filename(fullname))
+        fingerprint = self.extension_fingerprint(ext)
+        if fingerprint is not None:
+            if not os.path.isdir(os.path.dirname(ext_path)):
+                mkpath(os.path.dirname(ext_path))
+            if cache.load(fingerprint, ext_path):
+                log.info("using cached '%s' extension", ext.name)
+                return
+        # Do not trust the timestamps (of one second resolution) when the
+        # content changed, or a stale module would end up in the cache.
+        force = self.force
+        self.force = True
+        try:
+            _build_ext.build_ext.build_extension(self, ext)
+        finally:
+            self.force = force
+        if fingerprint is not None and os.path.exists(ext_path):
+            try:
+                cache.store(fingerprint, ext_path)
+            except EnvironmentError:
+                pass
+
+    def extension_fingerprint(self, ext):
+        """
+        A hash of the sources of the extension module and of everything
+        that is passed to the C compiler and linker.  Header files are
+        only taken into account if they are listed in 'depends'.
+        """
+        try:
+            from hashlib import md5
+        except ImportError:
+            from md5 import new as md5
+        from distutils.util import get_platform
+        m = md5()
+        for path in list(ext.sources) + list(ext.depends or ()) + list(ext.extra_objects or ()):
+            try:
+                f = open(path, 'rb')
+                try:
+                    data = f.read()
+                finally:
+                    f.close()
+            except IOError:
+                return None
+            if data.startswith(generated_header):
+                # the first line contains the time of the compilation
+                data = data[data.find(newline):]
+            m.update(repr((os.path.basename(path), len(data))).encode('UTF-8'))
+            m.update(data)
+        compiler = self.compiler
+        m.update(repr((
+            ext.name, sys.version, get_platform(), self.debug,
+            ext.include_dirs, ext.define_macros, ext.undef_macros,
+            ext.library_dirs, ext.libraries, ext.runtime_library_dirs,
+            ext.extra_compile_args, ext.extra_link_args, ext.export_symbols,
+            ext.language, self.include_dirs, self.define, self.undef,
+            self.libraries, self.library_dirs, self.rpath, self.link_objects,
+            getattr(compiler, 'compiler_type', None),
+            getattr(compiler, 'compiler_so', None),
+            getattr(compiler, 'compiler_cxx', None),
+            getattr(compiler, 'linker_so', None),
+            sysconfig.get_config_vars('CFLAGS', 'LDSHARED', 'SO'),
+            )).encode('UTF-8'))
+        return m.hexdigest()
+
     def cython_sources(self, sources, extension):
         """
         Walk the list of source files in 'sources', looking for Cython
@@ -180,9 +332,10 @@ class build_ext(_build_ext.build_ext):
         try:
             from Cython.Compiler.Main \
                 import CompilationOptions, \
-                       default_options as cython_default_options, \
-                       compile as cython_compile
+                       default_options as cython_default_options
+            from Cython.Compiler.Server import compile as cython_compile
             from Cython.Compiler.Errors import PyrexError
+            from Cython.Compiler.CodeSplitting import part_files
         except ImportError:
             e = sys.exc_info()[1]
             print("failed to import Cython: %s" % e)
@@ -222,6 +375,7 @@ class build_ext(_build_ext.build_ext):
         cython_gdb = self.cython_gdb or getattr(extension, 'cython_gdb', False)
         cython_compile_time_env = self.cython_compile_time_env or \
             getattr(extension, 'cython_compile_time_env', None)
+        cython_split_c = self.cython_split_c or getattr(extension, 'cython_split_c', 0)
 
         # Set up the include_path for the Cython compiler:
         #    1.    Start with the command line option.
@@ -312,11 +466,14 @@ class build_ext(_build_ext.build_ext):
                     generate_pxi = cython_gen_pxi,
                     output_dir = output_dir,
                     gdb_debug = cython_gdb,
-                    compile_time_env = cython_compile_time_env)
+                    compile_time_env = cython_compile_time_env,
+                    split_c = cython_split_c)
                 result = cython_compile(source, options=options,
                                         full_module_name=module_name)
             else:
                 log.info("skipping '%s' Cython extension (up-to-date)", target)
+            # the generated code may be split into several files
+            new_sources.extend(part_files(target))
 
         return new_sources
 
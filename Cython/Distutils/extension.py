@@ -36,6 +36,10 @@ class Extension(_Extension.Extension):
         generate Cython debug information for this extension for cygdb
     no_c_in_traceback : boolean
         emit the c file and line number from the traceback for exceptions
+    cython_cache : string
+        directory for caching the compiled extension module
+    cython_split_c : int
+        split the generated C file into this many files
     """
 
     # When adding arguments to this constructor, be sure to update
@@ -64,6 +68,8 @@ class Extension(_Extension.Extension):
             cython_gdb = False,
             no_c_in_traceback = False,
             cython_compile_time_env = None,
+            cython_cache = None,
+            cython_split_c = 0,
             **kw):
         
         # Translate pyrex_X to cython_X for backwards compatibility.
@@ -117,6 +123,8 @@ class Extension(_Extension.Extension):
         self.cython_gdb = cython_gdb
         self.no_c_in_traceback = no_c_in_traceback
         self.cython_compile_time_env = cython_compile_time_env
+        self.cython_cache = cython_cache
+        self.cython_split_c = cython_split_c
 
 # class Extension
 
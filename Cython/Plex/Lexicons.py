@@ -154,6 +154,7 @@ class Lexicon(object):
       timings.write("Converting to DFA: %5.2f\n" % (time4 - time3))
       timings.write("TOTAL            : %5.2f\n" % total_time)
     self.machine = dfa
+    self.tables = Machines.StateTableMachine(dfa)
 
   def add_token_to_machine(self, machine, initial_state, token_spec, token_number):
     try:
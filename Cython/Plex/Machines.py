@@ -254,3 +254,77 @@ class FastMachine(object):
       return repr(c1)
     else:
       return "%s..%s" % (repr(c1), repr(c2))
+
+# Character classes of the special inputs of a StateTableMachine
+OTHER_CLASS = 0   # characters without transitions of their own
+BOL_CLASS = 1
+EOL_CLASS = 2
+EOF_CLASS = 3
+END_CLASS = 4     # after the end of file
+
+class StateTableMachine(object):
+  """
+  StateTableMachine is a FastMachine represented as dense tables. The
+  characters are mapped to character classes that lead to the same
+  states, and the transitions are stored in a flat list indexed by
+  state number and character class.
+  """
+  initial_states = None # {state_name:state_number}
+  actions = None        # [Action or None] indexed by state number
+  char_classes = None   # [class] indexed by character code (at least 128)
+  num_classes = 0
+  transitions = None    # [state_number or -1] at state * num_classes + class
+
+  def __init__(self, fast_machine):
+    states = fast_machine.states
+    numbers = {}
+    for number, state in enumerate(states):
+      numbers[id(state)] = number
+    def column(targets):
+      return tuple([target and numbers[id(target)] for target in targets])
+    # characters that lead to the same states share a class
+    else_column = column([state['else'] for state in states])
+    chars = {}
+    for state in states:
+      for key in state:
+        if len(key) == 1:
+          chars[key] = None
+    columns = [else_column,
+               column([state['bol'] for state in states]),
+               column([state['eol'] for state in states]),
+               column([state['eof'] for state in states]),
+               column([state[''] for state in states])]
+    classes = {else_column: OTHER_CLASS}
+    # (covering at least the ASCII characters)
+    char_classes = [OTHER_CLASS] * max([128] + [ord(c) + 1 for c in chars])
+    for c in sorted(chars):
+      char_column = column([state.get(c, state['else']) for state in states])
+      char_class = classes.get(char_column)
+      if char_class is None:
+        char_class = classes[char_column] = len(columns)
+        columns.append(char_column)
+      char_classes[ord(c)] = char_class
+    self.char_classes = char_classes
+    self.num_classes = num_classes = len(columns)
+    transitions = [-1] * (len(states) * num_classes)
+    for char_class, targets in enumerate(columns):
+      for number, target in enumerate(targets):
+        if target is not None:
+          transitions[number * num_classes + char_class] = target
+    self.transitions = transitions
+    self.actions = [state['action'] for state in states]
+    self.initial_states = dict([
+      (name, numbers[id(state)])
+      for name, state in fast_machine.initial_states.iteritems()])
+
+  def get_initial_state(self, name):
+    return self.initial_states[name]
+
+  def char_class(self, c):
+    """Return the character class of a character or special input."""
+    if len(c) == 1:
+      code = ord(c)
+      if code < len(self.char_classes):
+        return self.char_classes[code]
+      return OTHER_CLASS
+    return {'': END_CLASS, 'bol': BOL_CLASS, 'eol': EOL_CLASS, 'eof': EOF_CLASS}[c]
@@ -17,12 +17,17 @@ cdef class Scanner:
     cdef public Py_ssize_t start_line
     cdef public Py_ssize_t start_col
     cdef public text
-    cdef public initial_state # int?
+    cdef public Py_ssize_t initial_state
     cdef public state_name
     cdef public list queue
     cdef public bint trace
     cdef public cur_char
+    cdef public long cur_class
     cdef public int input_state
+    cdef list transitions
+    cdef list actions
+    cdef list char_classes
+    cdef Py_ssize_t num_classes
 
     cdef public level
 
@@ -34,7 +39,10 @@ cdef class Scanner:
     cdef tuple position(self)
 
     @cython.locals(cur_pos=long, cur_line=long, cur_line_start=long,
-                   input_state=long, next_pos=long, state=dict,
+                   input_state=long, next_pos=long, state=Py_ssize_t, new_state=Py_ssize_t,
+                   cur_class=long, b_cur_class=long, code=long,
+                   transitions=list, actions=list, char_classes=list,
+                   num_classes=Py_ssize_t, num_char_classes=Py_ssize_t,
                    buf_start_pos=long, buf_len=long, buf_index=long,
                    trace=bint, discard=long, data=unicode, buffer=unicode)
     cdef run_machine_inlined(self)
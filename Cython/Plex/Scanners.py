@@ -8,12 +8,13 @@
 #=======================================================================
 
 import cython
-cython.declare(BOL=object, EOL=object, EOF=object, NOT_FOUND=object)
+cython.declare(BOL=object, EOL=object, EOF=object,
+               OTHER_CLASS=cython.long, BOL_CLASS=cython.long, EOL_CLASS=cython.long,
+               EOF_CLASS=cython.long, END_CLASS=cython.long)
 
 import Errors
 from Regexps import BOL, EOL, EOF
-
-NOT_FOUND = object()
+from Machines import OTHER_CLASS, BOL_CLASS, EOL_CLASS, EOF_CLASS, END_CLASS
 
 class Scanner(object):
   """
@@ -60,8 +61,13 @@ class Scanner(object):
 #  start_line = 0        # line number of start of token
 #  start_col = 0         # position in line of start of token
 #  text = None           # text of last token read
-#  initial_state = None  # Node
+#  initial_state = 0     # number of the initial state
 #  state_name = ''       # Name of initial state
+#  cur_class = 0         # character class of current char
+#  transitions = None    # state tables of the lexicon (StateTableMachine)
+#  actions = None
+#  char_classes = None
+#  num_classes = 0
 #  queue = None          # list of tokens to be returned
 #  trace = 0
 
@@ -92,15 +98,21 @@ class Scanner(object):
     self.state_name = None
 
     self.lexicon = lexicon
+    tables = lexicon.tables
+    self.transitions = tables.transitions
+    self.actions = tables.actions
+    self.char_classes = tables.char_classes
+    self.num_classes = tables.num_classes
     self.stream = stream
     self.name = name
     self.queue = []
-    self.initial_state = None
+    self.initial_state = 0
     self.begin('')
     self.next_pos = 0
     self.cur_pos = 0
     self.cur_line_start = 0
     self.cur_char = BOL
+    self.cur_class = BOL_CLASS
     self.input_state = 1
     if initial_pos is not None:
         self.cur_line, self.cur_line_start = initial_pos[1], -initial_pos[2]
@@ -160,33 +172,34 @@ class Scanner(object):
     cur_line = self.cur_line
     cur_line_start = self.cur_line_start
     cur_char = self.cur_char
+    cur_class = self.cur_class
     input_state = self.input_state
     next_pos = self.next_pos
     buffer = self.buffer
     buf_start_pos = self.buf_start_pos
     buf_len = len(buffer)
-    b_action, b_cur_pos, b_cur_line, b_cur_line_start, b_cur_char, b_input_state, b_next_pos = \
-              None, 0, 0, 0, u'', 0, 0
+    transitions = self.transitions
+    actions = self.actions
+    char_classes = self.char_classes
+    num_classes = self.num_classes
+    num_char_classes = len(char_classes)
+    b_action, b_cur_pos, b_cur_line, b_cur_line_start, b_cur_char, b_cur_class, b_input_state, b_next_pos = \
+              None, 0, 0, 0, u'', 0, 0, 0
     trace = self.trace
     while 1:
       if trace: #TRACE#
         print("State %d, %d/%d:%s -->" % ( #TRACE#
-          state['number'], input_state, cur_pos, repr(cur_char)))  #TRACE#
+          state, input_state, cur_pos, repr(cur_char)))  #TRACE#
       # Begin inlined self.save_for_backup()
-      #action = state.action #@slow
-      action = state['action'] #@fast
+      action = actions[state]
       if action is not None:
-        b_action, b_cur_pos, b_cur_line, b_cur_line_start, b_cur_char, b_input_state, b_next_pos = \
-                  action, cur_pos, cur_line, cur_line_start, cur_char, input_state, next_pos
+        b_action, b_cur_pos, b_cur_line, b_cur_line_start, b_cur_char, b_cur_class, b_input_state, b_next_pos = \
+                  action, cur_pos, cur_line, cur_line_start, cur_char, cur_class, input_state, next_pos
       # End inlined self.save_for_backup()
-      c = cur_char
-      #new_state = state.new_state(c) #@slow
-      new_state = state.get(c, NOT_FOUND) #@fast
-      if new_state is NOT_FOUND: #@fast
-        new_state = c and state.get('else') #@fast
-      if new_state:
+      new_state = transitions[state * num_classes + cur_class]
+      if new_state >= 0:
         if trace: #TRACE#
-          print("State %d" % new_state['number'])  #TRACE#
+          print("State %d" % new_state)  #TRACE#
         state = new_state
         # Begin inlined: self.next_char()
         if input_state == 1:
@@ -213,25 +226,36 @@ class Scanner(object):
           # End inlined: c = self.read_char()
           if c == u'\n':
             cur_char = EOL
+            cur_class = EOL_CLASS
             input_state = 2
           elif not c:
             cur_char = EOL
+            cur_class = EOL_CLASS
             input_state = 4
           else:
             cur_char = c
+            code = ord(c)
+            if code < num_char_classes:
+              cur_class = char_classes[code]
+            else:
+              cur_class = OTHER_CLASS
         elif input_state == 2:
           cur_char = u'\n'
+          cur_class = char_classes[10]
           input_state = 3
         elif input_state == 3:
           cur_line = cur_line + 1
           cur_line_start = cur_pos = next_pos
           cur_char = BOL
+          cur_class = BOL_CLASS
           input_state = 1
         elif input_state == 4:
           cur_char = EOF
+          cur_class = EOF_CLASS
           input_state = 5
         else: # input_state = 5
           cur_char = u''
+          cur_class = END_CLASS
         # End inlined self.next_char()
       else: # not new_state
         if trace: #TRACE#
@@ -239,9 +263,9 @@ class Scanner(object):
         # Begin inlined: action = self.back_up()
         if b_action is not None:
           (action, cur_pos, cur_line, cur_line_start,
-           cur_char, input_state, next_pos) = \
+           cur_char, cur_class, input_state, next_pos) = \
                    (b_action, b_cur_pos, b_cur_line, b_cur_line_start,
-                    b_cur_char, b_input_state, b_next_pos)
+                    b_cur_char, b_cur_class, b_input_state, b_next_pos)
         else:
           action = None
         break # while 1
@@ -250,6 +274,7 @@ class Scanner(object):
     self.cur_line = cur_line
     self.cur_line_start = cur_line_start
     self.cur_char = cur_char
+    self.cur_class = cur_class
     self.input_state = input_state
     self.next_pos     = next_pos
     if trace: #TRACE#
@@ -266,25 +291,32 @@ class Scanner(object):
       c = self.read_char()
       if c == u'\n':
         self.cur_char = EOL
+        self.cur_class = EOL_CLASS
         self.input_state = 2
       elif not c:
         self.cur_char = EOL
+        self.cur_class = EOL_CLASS
         self.input_state = 4
       else:
         self.cur_char = c
+        self.cur_class = self.lexicon.tables.char_class(c)
     elif input_state == 2:
       self.cur_char = u'\n'
+      self.cur_class = self.char_classes[10]
       self.input_state = 3
     elif input_state == 3:
       self.cur_line = self.cur_line + 1
       self.cur_line_start = self.cur_pos = self.next_pos
       self.cur_char = BOL
+      self.cur_class = BOL_CLASS
       self.input_state = 1
     elif input_state == 4:
       self.cur_char = EOF
+      self.cur_class = EOF_CLASS
       self.input_state = 5
     else: # input_state = 5
       self.cur_char = u''
+      self.cur_class = END_CLASS
     if self.trace:
       print("--> [%d] %d %s" % (input_state, self.cur_pos, repr(self.cur_char)))
 
@@ -307,7 +339,7 @@ class Scanner(object):
   def begin(self, state_name):
     """Set the current state of the scanner to the named state."""
     self.initial_state = (
-      self.lexicon.get_initial_state(state_name))
+      self.lexicon.tables.get_initial_state(state_name))
     self.state_name = state_name
 
   def produce(self, value, text = None):
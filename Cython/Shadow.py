@@ -397,12 +397,26 @@ class CythonDotParallel(object):
     The cython.parallel module.
     """
 
-    __all__ = ['parallel', 'prange', 'threadid']
+    __all__ = ['parallel', 'prange', 'threadid', 'simd', 'sections',
+               'section']
 
     def parallel(self, num_threads=None):
         return nogil
 
-    def prange(self, start=0, stop=None, step=1, schedule=None, nogil=False):
+    def sections(self, num_threads=None):
+        return nogil
+
+    def section(self):
+        return nogil
+
+    def prange(self, start=0, stop=None, step=1, schedule=None, nogil=False,
+               simd=False, safelen=None):
+        if stop is None:
+            stop = start
+            start = 0
+        return range(start, stop, step)
+
+    def simd(self, start=0, stop=None, step=1, safelen=None):
         if stop is None:
             stop = start
             start = 0
@@ -414,6 +428,51 @@ class CythonDotParallel(object):
     # def threadsavailable(self):
         # return 1
 
+class CythonDotAtomic(object):
+    """
+    The cython.atomic module.  Python code runs under the GIL, so the
+    operations only need to act on the pointer.
+    """
+
+    relaxed, consume, acquire, release, acq_rel, seq_cst = range(6)
+
+    int = uint = long = ulong = llong = ullong = ssize_t = size_t = typedef(py_int)
+    float = double = typedef(py_float)
+    ptr = p_void
+
+    def load(self, ptr, order=seq_cst):
+        return ptr[0]
+
+    def store(self, ptr, value, order=seq_cst):
+        ptr[0] = value
+
+    def exchange(self, ptr, value, order=seq_cst):
+        old, ptr[0] = ptr[0], value
+        return old
+
+    def compare_exchange(self, ptr, expected, desired, order=seq_cst):
+        if ptr[0] == expected[0]:
+            ptr[0] = desired
+            return True
+        expected[0] = ptr[0]
+        return False
+
+    def _fetch_op(op, seq_cst=seq_cst):
+        def fetch_op(self, ptr, value, order=seq_cst):
+            old = ptr[0]
+            ptr[0] = op(old, value)
+            return old
+        return fetch_op
+
+    import operator
+    fetch_add = _fetch_op(operator.add)
+    fetch_sub = _fetch_op(operator.sub)
+    fetch_and = _fetch_op(operator.and_)
+    fetch_or = _fetch_op(operator.or_)
+    fetch_xor = _fetch_op(operator.xor)
+    del _fetch_op, operator
+
 import sys
 sys.modules['cython.parallel'] = CythonDotParallel()
+sys.modules['cython.atomic'] = atomic = CythonDotAtomic()
 del sys
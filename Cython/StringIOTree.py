@@ -1,3 +1,5 @@
+import sys
+import tempfile
 from cStringIO import StringIO
 
 class StringIOTree(object):
@@ -66,6 +68,61 @@ class StringIOTree(object):
         children = self.prepended_children
         return [m for c in children for m in c.allmarkers()] + self.markers
 
+    def spill(self, f):
+        """
+        Move everything written so far (including the insertion points)
+        to the end of the file f, to free the memory that it uses.  The
+        insertion points must not be written to afterwards, but further
+        writing to self is ok.
+        """
+        self.commit()
+        if not self.prepended_children:
+            return
+        content = self.getvalue()
+        f.seek(0, 2)
+        start = f.tell()
+        f.write(content)
+        spilled = SpilledStringIOTree(f, start, len(content), self.allmarkers())
+        self.prepended_children = [spilled]
+
+
+def spill_file():
+    """
+    Return a temporary file for spill().  It is opened in text mode, as
+    the content of a StringIOTree is text in Python 3.
+    """
+    if sys.version_info[0] >= 3:
+        return tempfile.TemporaryFile(mode='w+', encoding='UTF-8', newline='')
+    return tempfile.TemporaryFile()
+
+
+class SpilledStringIOTree(object):
+    """
+    Content of a StringIOTree that was moved to a file.
+    """
+
+    def __init__(self, f, start, size, markers):
+        self.f = f
+        self.start = start
+        self.size = size
+        self.markers = markers
+
+    def getvalue(self):
+        self.f.seek(self.start)
+        return self.f.read(self.size)
+
+    def copyto(self, target, block_size=1 << 20):
+        f = self.f
+        f.seek(self.start)
+        left = self.size
+        while left > 0:
+            data = f.read(min(left, block_size))
+            target.write(data)
+            left -= len(data)
+
+    def allmarkers(self):
+        return self.markers
+
 
 __doc__ = r"""
 Implements a buffer with insertion points. When you know you need to
@@ -96,4 +153,12 @@ EXAMPLE:
 >>> a.copyto(out)
 >>> out.getvalue().split()
 ['first', 'second', 'alpha', 'inserted', 'beta', 'gamma', 'third']
+
+Content that is complete can be moved to a (temporary) file:
+
+>>> f = spill_file()
+>>> b.spill(f)
+>>> b.write('delta\n')
+>>> a.getvalue().split()
+['first', 'second', 'alpha', 'inserted', 'beta', 'gamma', 'delta', 'third']
 """
@@ -6,6 +6,7 @@ from Cython.Compiler import TreePath
 
 import unittest
 import os, sys
+import shutil
 import tempfile
 
 class NodeTypeWriter(TreeVisitor):
@@ -166,6 +167,36 @@ class TreeAssertVisitor(VisitorTransform):
 
     visit_Node = VisitorTransform.recurse_to_children
 
+class FileTestCase(unittest.TestCase):
+    """
+    Base class for tests that work with files.  Every test gets its own
+    temporary directory, self.directory, which is removed after it.
+    """
+    directory_prefix = 'cython_test_'
+
+    def setUp(self):
+        self.directory = tempfile.mkdtemp(prefix=self.directory_prefix)
+
+    def tearDown(self):
+        shutil.rmtree(self.directory)
+
+    def path(self, name):
+        return os.path.join(self.directory, name)
+
+    def write(self, name, content, mode='w'):
+        f = open(self.path(name), mode)
+        try:
+            f.write(content)
+        finally:
+            f.close()
+
+    def read(self, name, mode='r'):
+        f = open(self.path(name), mode)
+        try:
+            return f.read()
+        finally:
+            f.close()
+
 def unpack_source_tree(tree_file, dir=None):
     if dir is None:
         dir = tempfile.mkdtemp()
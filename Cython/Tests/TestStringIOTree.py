@@ -55,6 +55,23 @@ class TestStringIOTree(unittest.TestCase):
         self.assertEqual(self.tree.allmarkers(), range(1, 17))
         self.assertEqual(code.strip(), self.tree.getvalue().strip())
 
+    def test_spill(self):
+        self.write_lines((1, 2, 3))
+        line_4_insertion_point = self.tree.insertion_point()
+        self.write_lines((5, 6, 7))
+        self.write_line(4, tree=line_4_insertion_point)
+        f = stringtree.spill_file()
+        try:
+            self.tree.spill(f)
+            self.write_lines(range(8, 17))
+            self.assertEqual(self.tree.allmarkers(), range(1, 17))
+            self.assertEqual(code.strip(), self.tree.getvalue().strip())
+            out = stringtree.StringIO()
+            self.tree.copyto(out)
+            self.assertEqual(code.strip(), out.getvalue().strip())
+        finally:
+            f.close()
+
 
     def write_lines(self, linenos, tree=None):
         for lineno in linenos:
@@ -0,0 +1,259 @@
+/////////////// AtomicTypes.proto ///////////////
+
+// Storage types of cython.atomic.  Some 32 bit ABIs only align 8 byte types
+// to 4 bytes in structs and on the stack, which would make them non-atomic,
+// so these are explicitly aligned.
+
+#if defined(__GNUC__)
+  #define __PYX_ATOMIC_ALIGN8 __attribute__((aligned(8)))
+#elif defined(_MSC_VER)
+  #define __PYX_ATOMIC_ALIGN8 __declspec(align(8))
+#else
+  #define __PYX_ATOMIC_ALIGN8
+#endif
+
+typedef int __Pyx_atomic_int;
+typedef unsigned int __Pyx_atomic_uint;
+typedef long __Pyx_atomic_long;
+typedef unsigned long __Pyx_atomic_ulong;
+typedef __PYX_ATOMIC_ALIGN8 PY_LONG_LONG __Pyx_atomic_llong;
+typedef __PYX_ATOMIC_ALIGN8 unsigned PY_LONG_LONG __Pyx_atomic_ullong;
+typedef Py_ssize_t __Pyx_atomic_ssize_t;
+typedef size_t __Pyx_atomic_size_t;
+typedef float __Pyx_atomic_float;
+typedef __PYX_ATOMIC_ALIGN8 double __Pyx_atomic_double;
+typedef void *__Pyx_atomic_ptr;
+
+/////////////// AtomicOps.proto ///////////////
+
+// Memory orders of cython.atomic, with the values of the __ATOMIC_* macros.
+//
+// CYTHON_ATOMIC_OPS selects the implementation:
+//   1: the __atomic builtins of gcc >= 4.7 and clang (the C11 memory model),
+//   2: the __sync builtins of gcc >= 4.1 (always a full barrier),
+//   3: the Interlocked functions of MSVC (always a full barrier),
+//   0: a single global lock.
+// Except for 1, all operations are compare-and-swap loops on the bits of the
+// value, and values of other sizes than 4 or 8 bytes always use the lock.
+
+#include <string.h>
+#include <pythread.h>
+
+#define __Pyx_atomic_relaxed 0
+#define __Pyx_atomic_consume 1
+#define __Pyx_atomic_acquire 2
+#define __Pyx_atomic_release 3
+#define __Pyx_atomic_acq_rel 4
+#define __Pyx_atomic_seq_cst 5
+
+#ifndef CYTHON_ATOMIC_OPS
+  #if defined(__GNUC__) && defined(__ATOMIC_SEQ_CST) && \
+          (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 7))
+    #define CYTHON_ATOMIC_OPS 1
+  #elif defined(__GNUC__) && !defined(__i386__) && \
+          (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 1))
+    #define CYTHON_ATOMIC_OPS 2
+  #elif defined(_MSC_VER)
+    #define CYTHON_ATOMIC_OPS 3
+  #else
+    #define CYTHON_ATOMIC_OPS 0
+  #endif
+#endif
+
+#if CYTHON_ATOMIC_OPS == 3
+  #include <windows.h>
+#endif
+
+/* loads cannot release and stores cannot acquire, use the nearest stronger order */
+#define __Pyx_atomic_load_order(order) \
+    (((order) == __Pyx_atomic_release || (order) == __Pyx_atomic_acq_rel) ? __Pyx_atomic_acquire : (order))
+#define __Pyx_atomic_store_order(order) \
+    (((order) == __Pyx_atomic_consume || (order) == __Pyx_atomic_acquire || \
+      (order) == __Pyx_atomic_acq_rel) ? __Pyx_atomic_release : (order))
+#define __Pyx_atomic_failure_order(order) \
+    ((order) == __Pyx_atomic_release ? __Pyx_atomic_relaxed : \
+     (order) == __Pyx_atomic_acq_rel ? __Pyx_atomic_acquire : (order))
+
+static int __Pyx_atomic_init(void); /*proto*/
+#if CYTHON_ATOMIC_OPS != 1
+static PyThread_type_lock __pyx_atomic_lock = NULL;
+static int __Pyx_atomic_cas_bits(void *ptr, void *expected, const void *desired, size_t size); /*proto*/
+static void __Pyx_atomic_load_bits(void *ptr, void *result, size_t size); /*proto*/
+#endif
+
+/////////////// AtomicOps ///////////////
+
+/* Called on module initialisation, returns -1 with a MemoryError set on failure */
+static int __Pyx_atomic_init(void) {
+#if CYTHON_ATOMIC_OPS != 1
+    if (!__pyx_atomic_lock) {
+        __pyx_atomic_lock = PyThread_allocate_lock();
+        if (!__pyx_atomic_lock) {
+            PyErr_NoMemory();
+            return -1;
+        }
+    }
+#endif
+    return 0;
+}
+
+#if CYTHON_ATOMIC_OPS != 1
+#if CYTHON_ATOMIC_OPS == 2
+  #define __Pyx_atomic_barrier() __sync_synchronize()
+#elif CYTHON_ATOMIC_OPS == 3
+  #define __Pyx_atomic_barrier() MemoryBarrier()
+#endif
+
+/* Copy the value at ptr to *result.  Values that fit into a machine word
+   are read with a plain load between two full barriers, wider values with
+   a compare-and-swap that replaces the value by itself, as 32 bit targets
+   have no plain atomic load of 8 bytes. */
+static void __Pyx_atomic_load_bits(void *ptr, void *result, size_t size) {
+#if CYTHON_ATOMIC_OPS == 2 || CYTHON_ATOMIC_OPS == 3
+    if (size == sizeof(int)) {
+        int value;
+        __Pyx_atomic_barrier();
+        value = *(volatile int *) ptr;
+        __Pyx_atomic_barrier();
+        memcpy(result, &value, size);
+        return;
+    } else if (size == sizeof(PY_LONG_LONG) && size <= sizeof(void *)) {
+        PY_LONG_LONG value;
+        __Pyx_atomic_barrier();
+        value = *(volatile PY_LONG_LONG *) ptr;
+        __Pyx_atomic_barrier();
+        memcpy(result, &value, size);
+        return;
+    } else if (size == sizeof(PY_LONG_LONG)) {
+        memset(result, 0, size);
+        __Pyx_atomic_cas_bits(ptr, result, result, size);
+        return;
+    }
+#endif
+    PyThread_acquire_lock(__pyx_atomic_lock, WAIT_LOCK);
+    memcpy(result, ptr, size);
+    PyThread_release_lock(__pyx_atomic_lock);
+}
+
+/* Compare *ptr with *expected and replace it with *desired if they are equal,
+   otherwise store the current value in *expected.  Returns 1 on success. */
+static int __Pyx_atomic_cas_bits(void *ptr, void *expected, const void *desired, size_t size) {
+    int success;
+#if CYTHON_ATOMIC_OPS == 2
+    if (size == sizeof(int)) {
+        int old, new_, prev;
+        memcpy(&old, expected, size);
+        memcpy(&new_, desired, size);
+        prev = __sync_val_compare_and_swap((int *) ptr, old, new_);
+        memcpy(expected, &prev, size);
+        return prev == old;
+    } else if (size == sizeof(PY_LONG_LONG)) {
+        PY_LONG_LONG old, new_, prev;
+        memcpy(&old, expected, size);
+        memcpy(&new_, desired, size);
+        prev = __sync_val_compare_and_swap((PY_LONG_LONG *) ptr, old, new_);
+        memcpy(expected, &prev, size);
+        return prev == old;
+    }
+#elif CYTHON_ATOMIC_OPS == 3
+    if (size == sizeof(LONG)) {
+        LONG old, new_, prev;
+        memcpy(&old, expected, size);
+        memcpy(&new_, desired, size);
+        prev = InterlockedCompareExchange((volatile LONG *) ptr, new_, old);
+        memcpy(expected, &prev, size);
+        return prev == old;
+    } else if (size == sizeof(LONGLONG)) {
+        LONGLONG old, new_, prev;
+        memcpy(&old, expected, size);
+        memcpy(&new_, desired, size);
+        prev = InterlockedCompareExchange64((volatile LONGLONG *) ptr, new_, old);
+        memcpy(expected, &prev, size);
+        return prev == old;
+    }
+#endif
+    PyThread_acquire_lock(__pyx_atomic_lock, WAIT_LOCK);
+    success = memcmp(ptr, expected, size) == 0;
+    if (success)
+        memcpy(ptr, desired, size);
+    else
+        memcpy(expected, ptr, size);
+    PyThread_release_lock(__pyx_atomic_lock);
+    return success;
+}
+#endif
+
+/////////////// AtomicOp.proto ///////////////
+
+// Atomic operations on one C type, see AtomicOps for the implementations.
+// OP is one of load, store, exchange, compare_exchange or fetch_<op> with
+// the C operator BINOP.
+
+{{if OP == 'load'}}
+static CYTHON_INLINE {{TYPE}} __Pyx_atomic_load_{{NAME}}({{TYPE}} *ptr, int order) {
+    {{TYPE}} result;
+#if CYTHON_ATOMIC_OPS == 1
+    __atomic_load(ptr, &result, __Pyx_atomic_load_order(order));
+#else
+    (void) order;
+    __Pyx_atomic_load_bits(ptr, &result, sizeof(result));
+#endif
+    return result;
+}
+{{elif OP == 'store'}}
+static CYTHON_INLINE void __Pyx_atomic_store_{{NAME}}({{TYPE}} *ptr, {{TYPE}} value, int order) {
+#if CYTHON_ATOMIC_OPS == 1
+    __atomic_store(ptr, &value, __Pyx_atomic_store_order(order));
+#else
+    {{TYPE}} old;
+    (void) order;
+    __Pyx_atomic_load_bits(ptr, &old, sizeof(old));
+    while (!__Pyx_atomic_cas_bits(ptr, &old, &value, sizeof(old)));
+#endif
+}
+{{elif OP == 'exchange'}}
+static CYTHON_INLINE {{TYPE}} __Pyx_atomic_exchange_{{NAME}}({{TYPE}} *ptr, {{TYPE}} value, int order) {
+    {{TYPE}} old;
+#if CYTHON_ATOMIC_OPS == 1
+    __atomic_exchange(ptr, &value, &old, order);
+#else
+    (void) order;
+    __Pyx_atomic_load_bits(ptr, &old, sizeof(old));
+    while (!__Pyx_atomic_cas_bits(ptr, &old, &value, sizeof(old)));
+#endif
+    return old;
+}
+{{elif OP == 'compare_exchange'}}
+static CYTHON_INLINE int __Pyx_atomic_compare_exchange_{{NAME}}({{TYPE}} *ptr, {{TYPE}} *expected,
+                                                               {{TYPE}} desired, int order) {
+#if CYTHON_ATOMIC_OPS == 1
+    return __atomic_compare_exchange(ptr, expected, &desired, 0, order,
+                                     __Pyx_atomic_failure_order(order));
+#else
+    (void) order;
+    return __Pyx_atomic_cas_bits(ptr, expected, &desired, sizeof(desired));
+#endif
+}
+{{else}}
+static CYTHON_INLINE {{TYPE}} __Pyx_atomic_{{OP}}_{{NAME}}({{TYPE}} *ptr, {{TYPE}} value, int order) {
+#if CYTHON_ATOMIC_OPS == 1 && !{{IS_FLOAT}}
+    return __atomic_{{OP}}(ptr, value, order);
+#else
+    {{TYPE}} old, new_;
+  #if CYTHON_ATOMIC_OPS == 1
+    __atomic_load(ptr, &old, __Pyx_atomic_relaxed);
+    do {
+        new_ = old {{BINOP}} value;
+    } while (!__atomic_compare_exchange(ptr, &old, &new_, 1, order,
+                                        __Pyx_atomic_failure_order(order)));
+  #else
+    (void) order;
+    __Pyx_atomic_load_bits(ptr, &old, sizeof(old));
+    do {
+        new_ = old {{BINOP}} value;
+    } while (!__Pyx_atomic_cas_bits(ptr, &old, &new_, sizeof(old)));
+  #endif
+    return old;
+#endif
+}
+{{endif}}
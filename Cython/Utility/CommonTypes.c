@@ -0,0 +1,58 @@
+//////////////////// FetchCommonType.proto ////////////////////
+
+static PyTypeObject* __Pyx_FetchCommonType(PyTypeObject* type);
+
+//////////////////// FetchCommonType ////////////////////
+
+/* With CYTHON_SHARED_RUNTIME, the first module that needs one of the
+   runtime types of Cython (such as its function and generator types)
+   readies it and registers it in a module of the same Cython version,
+   all other modules use that type instead of their own copy. */
+static PyTypeObject* __Pyx_FetchCommonType(PyTypeObject* type) {
+#if CYTHON_SHARED_RUNTIME
+    PyObject* runtime_module;
+    PyTypeObject* cached_type = NULL;
+
+    runtime_module = PyImport_AddModule((char*) "_cython_runtime_" CYTHON_ABI);
+    if (!runtime_module) return NULL;
+    Py_INCREF(runtime_module);
+
+    cached_type = (PyTypeObject*) PyObject_GetAttrString(runtime_module, (char*) type->tp_name);
+    if (cached_type) {
+        if (!PyType_Check((PyObject*)cached_type)) {
+            PyErr_Format(PyExc_TypeError,
+                "Shared Cython type %.200s is not a type object",
+                type->tp_name);
+            goto bad;
+        }
+        if (cached_type->tp_basicsize != type->tp_basicsize) {
+            PyErr_Format(PyExc_TypeError,
+                "Shared Cython type %.200s has the wrong size, try recompiling",
+                type->tp_name);
+            goto bad;
+        }
+    } else {
+        if (!PyErr_ExceptionMatches(PyExc_AttributeError)) goto bad;
+        PyErr_Clear();
+        if (PyType_Ready(type) < 0) goto bad;
+        if (PyObject_SetAttrString(runtime_module, (char*) type->tp_name, (PyObject*) type) < 0)
+            goto bad;
+        Py_INCREF(type);
+        cached_type = type;
+    }
+
+done:
+    Py_DECREF(runtime_module);
+    /* the type is kept alive by the runtime module, return a borrowed reference */
+    Py_XDECREF(cached_type);
+    return cached_type;
+
+bad:
+    Py_XDECREF(cached_type);
+    cached_type = NULL;
+    goto done;
+#else
+    if (PyType_Ready(type) < 0) return NULL;
+    return type;
+#endif
+}
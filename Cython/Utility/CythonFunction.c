@@ -1,12 +1,60 @@
 
 
-//////////////////// CythonFunction.proto ////////////////////
-#define __Pyx_CyFunction_USED 1
-#include <structmember.h>
+//////////////////// CyFunctionVectorcall.proto ////////////////////
 
+/* A CyFunction that has the __Pyx_CYFUNCTION_VECTORCALL flag can also be
+   called with a C array of the positional arguments followed by the values
+   of the keyword arguments, whose names are passed as a tuple 'kwnames'. */
 #define __Pyx_CYFUNCTION_STATICMETHOD  0x01
 #define __Pyx_CYFUNCTION_CLASSMETHOD   0x02
 #define __Pyx_CYFUNCTION_CCLASS        0x04
+#define __Pyx_CYFUNCTION_VECTORCALL    0x08
+
+typedef PyObject *(*__pyx_vectorcallfunc)(PyObject *func, PyObject **args,
+                                          Py_ssize_t nargs, PyObject *kwnames);
+
+/* The leading fields of __pyx_CyFunctionObject, which are also used to call
+   the CyFunction objects of other modules. */
+typedef struct {
+    PyCFunctionObject func;
+    int flags;
+    __pyx_vectorcallfunc func_vectorcall;
+} __pyx_CyFunctionVectorcallHead;
+
+static CYTHON_INLINE int __Pyx_IsAnyCyFunction(PyObject *func); /*proto*/
+static CYTHON_INLINE __pyx_vectorcallfunc __Pyx_CyFunction_GetVectorcall(PyObject *func); /*proto*/
+
+//////////////////// CyFunctionVectorcall ////////////////////
+
+static CYTHON_INLINE int __Pyx_IsAnyCyFunction(PyObject *func) {
+#if CYTHON_COMPILING_IN_CPYTHON
+    /* The CyFunction types of all Cython modules have the same name.  The
+       last one that was seen is remembered to avoid the name comparison. */
+    static PyTypeObject *cyfunction_type = NULL;
+    PyTypeObject *type = Py_TYPE(func);
+    if (likely(type == cyfunction_type))
+        return 1;
+    if (type->tp_call != PyCFunction_Call || type == &PyCFunction_Type ||
+            strcmp(type->tp_name, "cython_function_or_method") != 0)
+        return 0;
+    cyfunction_type = type;
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+static CYTHON_INLINE __pyx_vectorcallfunc __Pyx_CyFunction_GetVectorcall(PyObject *func) {
+    if (__Pyx_IsAnyCyFunction(func) &&
+            (((__pyx_CyFunctionVectorcallHead *) func)->flags & __Pyx_CYFUNCTION_VECTORCALL))
+        return ((__pyx_CyFunctionVectorcallHead *) func)->func_vectorcall;
+    return NULL;
+}
+
+//////////////////// CythonFunction.proto ////////////////////
+//@requires: CyFunctionVectorcall
+#define __Pyx_CyFunction_USED 1
+#include <structmember.h>
 
 #define __Pyx_CyFunction_GetClosure(f) \
     (((__pyx_CyFunctionObject *) (f))->func_closure)
@@ -22,6 +70,7 @@
 typedef struct {
     PyCFunctionObject func;
     int flags;
+    __pyx_vectorcallfunc func_vectorcall; /* see __pyx_CyFunctionVectorcallHead */
     PyObject *func_dict;
     PyObject *func_weakreflist;
     PyObject *func_name;
@@ -61,12 +110,15 @@ static CYTHON_INLINE void __Pyx_CyFunction_SetDefaultsKwDict(PyObject *m,
                                                              PyObject *dict);
 static CYTHON_INLINE void __Pyx_CyFunction_SetAnnotationsDict(PyObject *m,
                                                               PyObject *dict);
+static CYTHON_INLINE void __Pyx_CyFunction_SetVectorcall(PyObject *m,
+                                                         __pyx_vectorcallfunc vectorcall);
 
 
 static int __Pyx_CyFunction_init(void);
 
 //////////////////// CythonFunction ////////////////////
 //@substitute: naming
+//@requires: CommonTypes.c::FetchCommonType
 
 static PyObject *
 __Pyx_CyFunction_get_doc(__pyx_CyFunctionObject *op, CYTHON_UNUSED void *closure)
@@ -404,6 +456,7 @@ static PyObject *__Pyx_CyFunction_New(PyTypeObject *type, PyMethodDef *ml, int f
     if (op == NULL)
         return NULL;
     op->flags = flags;
+    op->func_vectorcall = NULL;
     op->func_weakreflist = NULL;
     op->func.m_ml = ml;
     op->func.m_self = (PyObject *) op;
@@ -642,9 +695,9 @@ static int __Pyx_CyFunction_init(void) {
     // avoid a useless level of call indirection
     __pyx_CyFunctionType_type.tp_call = PyCFunction_Call;
 #endif
-    if (PyType_Ready(&__pyx_CyFunctionType_type) < 0)
+    __pyx_CyFunctionType = __Pyx_FetchCommonType(&__pyx_CyFunctionType_type);
+    if (__pyx_CyFunctionType == NULL)
         return -1;
-    __pyx_CyFunctionType = &__pyx_CyFunctionType_type;
     return 0;
 }
 
@@ -677,6 +730,12 @@ static CYTHON_INLINE void __Pyx_CyFunction_SetAnnotationsDict(PyObject *func, Py
     Py_INCREF(dict);
 }
 
+static CYTHON_INLINE void __Pyx_CyFunction_SetVectorcall(PyObject *func, __pyx_vectorcallfunc vectorcall) {
+    __pyx_CyFunctionObject *m = (__pyx_CyFunctionObject *) func;
+    m->func_vectorcall = vectorcall;
+    m->flags |= __Pyx_CYFUNCTION_VECTORCALL;
+}
+
 //////////////////// CyFunctionClassCell.proto ////////////////////
 static CYTHON_INLINE void __Pyx_CyFunction_InitClassCell(PyObject *cyfunctions,
                                                          PyObject *classobj);
@@ -1082,10 +1141,12 @@ static PyTypeObject __pyx_FusedFunctionType_type = {
 };
 
 static int __pyx_FusedFunction_init(void) {
-    if (PyType_Ready(&__pyx_FusedFunctionType_type) < 0) {
+    /* the base type may be shared with other modules */
+    __pyx_FusedFunctionType_type.tp_base = __pyx_CyFunctionType;
+    __pyx_FusedFunctionType = __Pyx_FetchCommonType(&__pyx_FusedFunctionType_type);
+    if (__pyx_FusedFunctionType == NULL) {
         return -1;
     }
-    __pyx_FusedFunctionType = &__pyx_FusedFunctionType_type;
     return 0;
 }
 
@@ -154,11 +154,63 @@ invalid_keyword:
 }
 
 
+//////////////////// KeywordHashTable.proto ////////////////////
+
+typedef struct {
+    unsigned int multiplier;
+    unsigned int mask;
+    const short *slots;
+} __Pyx_KwHashTable;
+
+static CYTHON_INLINE Py_ssize_t __Pyx_KwHashTable_Lookup(const __Pyx_KwHashTable *table, PyObject *key); /*proto*/
+
+//////////////////// KeywordHashTable ////////////////////
+
+//  A __Pyx_KwHashTable maps the argument names of a def function to
+//  their index in its argnames array.  The compiler hashes the length
+//  and the first, middle and last character of each name and picks the
+//  multiplier and size of the table so that the names do not collide
+//  where possible (see Nodes.keyword_hash_table()).
+//
+//  The lookup returns the index of the only argument that the key can
+//  be found at through the table, or -1.  The caller must still compare
+//  the key with that argument name.
+
+static CYTHON_INLINE Py_ssize_t __Pyx_KwHashTable_Lookup(const __Pyx_KwHashTable *table, PyObject *key) {
+    Py_ssize_t length;
+    unsigned int h;
+#if PY_MAJOR_VERSION >= 3
+    if (unlikely(!PyUnicode_Check(key))) return -1;
+    #if CYTHON_PEP393_ENABLED
+    if (unlikely(!PyUnicode_IS_READY(key))) return -1;
+    #endif
+    length = __Pyx_PyUnicode_GET_LENGTH(key);
+    if (unlikely(length == 0)) return -1;
+    h = (unsigned int) length;
+    h = h * table->multiplier + (unsigned int) __Pyx_PyUnicode_READ_CHAR(key, 0);
+    h = h * table->multiplier + (unsigned int) __Pyx_PyUnicode_READ_CHAR(key, length / 2);
+    h = h * table->multiplier + (unsigned int) __Pyx_PyUnicode_READ_CHAR(key, length - 1);
+#else
+    const unsigned char *s;
+    if (unlikely(!PyString_Check(key))) return -1;
+    length = PyString_GET_SIZE(key);
+    if (unlikely(length == 0)) return -1;
+    s = (const unsigned char *) PyString_AS_STRING(key);
+    h = (unsigned int) length;
+    h = h * table->multiplier + s[0];
+    h = h * table->multiplier + s[length / 2];
+    h = h * table->multiplier + s[length - 1];
+#endif
+    return (Py_ssize_t) table->slots[h & table->mask] - 1;
+}
+
+
 //////////////////// ParseKeywords.proto ////////////////////
+//@requires: KeywordHashTable
 
 static int __Pyx_ParseOptionalKeywords(PyObject *kwds, PyObject **argnames[], \
-    PyObject *kwds2, PyObject *values[], Py_ssize_t num_pos_args, \
-    const char* function_name); /*proto*/
+    const __Pyx_KwHashTable *kwhash, PyObject *kwds2, PyObject *values[], \
+    Py_ssize_t num_pos_args, const char* function_name); /*proto*/
 
 //////////////////// ParseKeywords ////////////////////
 //@requires: RaiseDoubleKeywords
@@ -174,11 +226,49 @@ static int __Pyx_ParseOptionalKeywords(PyObject *kwds, PyObject **argnames[], \
 //  arguments that were passed and that must therefore not appear
 //  amongst the keywords as well.
 //
+//  If kwhash is not NULL, it is a hash table over the argnames that
+//  finds interned keywords without comparing them with each name.
+//
 //  This method does not check for required keyword arguments.
 
+#if CYTHON_COMPILING_IN_CPYTHON && PY_VERSION_HEX >= 0x03030000 && PY_VERSION_HEX < 0x030D0000
+//  When the unknown keywords go into a **kwargs dict and there are more
+//  keywords than argument names, looking up each name in the exact kwds
+//  dict and copying the whole dict into kwds2 at once is cheaper than
+//  iterating over the keywords.  CPython knows if the dict only has
+//  string keys, so that the keys need not be checked one by one.
+static int __Pyx_ParseKeywordsByMerge(
+    PyObject *kwds,
+    PyObject **argnames[],
+    PyObject *kwds2,
+    PyObject *values[],
+    Py_ssize_t num_pos_args,
+    const char* function_name)
+{
+    PyObject*** name;
+    PyObject*** first_kw_arg = argnames + num_pos_args;
+    for (name = argnames; name != first_kw_arg; name++) {
+        if (unlikely(PyDict_GetItem(kwds, **name))) {
+            __Pyx_RaiseDoubleKeywordsError(function_name, **name);
+            return -1;
+        }
+    }
+    if (unlikely(PyDict_Update(kwds2, kwds) < 0)) return -1;
+    for (name = first_kw_arg; *name; name++) {
+        PyObject *value = PyDict_GetItem(kwds, **name);
+        if (value) {
+            values[name-argnames] = value;
+            if (unlikely(PyDict_DelItem(kwds2, **name) < 0)) return -1;
+        }
+    }
+    return 0;
+}
+#endif
+
 static int __Pyx_ParseOptionalKeywords(
     PyObject *kwds,
     PyObject **argnames[],
+    const __Pyx_KwHashTable *kwhash,
     PyObject *kwds2,
     PyObject *values[],
     Py_ssize_t num_pos_args,
@@ -189,7 +279,23 @@ static int __Pyx_ParseOptionalKeywords(
     PyObject*** name;
     PyObject*** first_kw_arg = argnames + num_pos_args;
 
+#if CYTHON_COMPILING_IN_CPYTHON && PY_VERSION_HEX >= 0x03030000 && PY_VERSION_HEX < 0x030D0000
+    if (kwds2 && PyDict_CheckExact(kwds) && PyDict_CheckExact(kwds2) && PyDict_Size(kwds2) == 0) {
+        Py_ssize_t num_argnames = 0;
+        while (argnames[num_argnames]) num_argnames++;
+        if (PyDict_Size(kwds) > num_argnames && _PyDict_HasOnlyStringKeys(kwds))
+            return __Pyx_ParseKeywordsByMerge(kwds, argnames, kwds2, values, num_pos_args, function_name);
+    }
+#endif
+
     while (PyDict_Next(kwds, &pos, &key, &value)) {
+        if (kwhash) {
+            Py_ssize_t index = __Pyx_KwHashTable_Lookup(kwhash, key);
+            if (likely(index >= num_pos_args) && likely(*argnames[index] == key)) {
+                values[index] = value;
+                continue;
+            }
+        }
         name = first_kw_arg;
         while (*name && (**name != key)) name++;
         if (*name) {
@@ -283,3 +389,116 @@ invalid_keyword:
 bad:
     return -1;
 }
+
+
+//////////////////// VectorcallArgsToTuple.proto ////////////////////
+
+static int __Pyx_VectorcallArgsToTuple(PyObject **args, Py_ssize_t nargs, PyObject *kwnames,
+                                       PyObject **argtuple, PyObject **kwargs); /*proto*/
+
+//////////////////// VectorcallArgsToTuple ////////////////////
+//@substitute: naming
+
+//  __Pyx_VectorcallArgsToTuple converts the C array of arguments of a
+//  vectorcall into a new argument tuple and, if there are keyword
+//  arguments, a new keyword dict.
+
+static int __Pyx_VectorcallArgsToTuple(PyObject **args, Py_ssize_t nargs, PyObject *kwnames,
+                                       PyObject **argtuple, PyObject **kwargs) {
+    Py_ssize_t i, nkw;
+    if (nargs == 0) {
+        Py_INCREF($empty_tuple);
+        *argtuple = $empty_tuple;
+    } else {
+        *argtuple = PyTuple_New(nargs);
+        if (unlikely(!*argtuple)) return -1;
+        for (i = 0; i < nargs; i++) {
+            Py_INCREF(args[i]);
+            PyTuple_SET_ITEM(*argtuple, i, args[i]);
+        }
+    }
+    *kwargs = NULL;
+    if (kwnames && (nkw = PyTuple_GET_SIZE(kwnames)) > 0) {
+        *kwargs = PyDict_New();
+        if (unlikely(!*kwargs)) goto bad;
+        for (i = 0; i < nkw; i++) {
+            if (unlikely(PyDict_SetItem(*kwargs, PyTuple_GET_ITEM(kwnames, i), args[nargs+i]) < 0))
+                goto bad;
+        }
+    }
+    return 0;
+bad:
+    Py_CLEAR(*argtuple);
+    Py_CLEAR(*kwargs);
+    return -1;
+}
+
+
+//////////////////// VectorcallViaTuple.proto ////////////////////
+
+static PyObject *__Pyx_VectorcallViaTuple(PyCFunctionWithKeywords wrapper, PyObject *self,
+                                          PyObject **args, Py_ssize_t nargs, PyObject *kwnames); /*proto*/
+
+//////////////////// VectorcallViaTuple ////////////////////
+//@requires: VectorcallArgsToTuple
+
+//  __Pyx_VectorcallViaTuple passes the arguments of a vectorcall to the
+//  tuple based wrapper of a def function.  The vectorcall entry point uses
+//  it for everything it does not handle itself, including the raising of
+//  all argument errors.
+
+static PyObject *__Pyx_VectorcallViaTuple(PyCFunctionWithKeywords wrapper, PyObject *self,
+                                          PyObject **args, Py_ssize_t nargs, PyObject *kwnames) {
+    PyObject *argtuple, *kwargs, *result;
+    if (unlikely(__Pyx_VectorcallArgsToTuple(args, nargs, kwnames, &argtuple, &kwargs) < 0))
+        return NULL;
+    result = wrapper(self, argtuple, kwargs);
+    Py_DECREF(argtuple);
+    Py_XDECREF(kwargs);
+    return result;
+}
+
+
+//////////////////// MatchVectorcallKeywords.proto ////////////////////
+//@requires: KeywordHashTable
+
+static int __Pyx_MatchVectorcallKeywords(PyObject *kwnames, PyObject **kwvalues,
+    PyObject **argnames[], const __Pyx_KwHashTable *kwhash,
+    PyObject *values[], Py_ssize_t num_pos_args); /*proto*/
+
+//////////////////// MatchVectorcallKeywords ////////////////////
+
+//  __Pyx_MatchVectorcallKeywords stores the values of the keyword arguments
+//  of a vectorcall in the 'values' array of the arguments.  It only compares
+//  the interned keyword names by identity and returns -1 without setting an
+//  exception for any keyword that does not match an argument after the
+//  positional ones, so that the caller can fall back to the generic
+//  argument parsing.
+
+static int __Pyx_MatchVectorcallKeywords(
+    PyObject *kwnames,
+    PyObject **kwvalues,
+    PyObject **argnames[],
+    const __Pyx_KwHashTable *kwhash,
+    PyObject *values[],
+    Py_ssize_t num_pos_args)
+{
+    Py_ssize_t i, nkw = PyTuple_GET_SIZE(kwnames);
+    PyObject*** first_kw_arg = argnames + num_pos_args;
+    for (i = 0; i < nkw; i++) {
+        PyObject *key = PyTuple_GET_ITEM(kwnames, i);
+        PyObject*** name;
+        if (kwhash) {
+            Py_ssize_t index = __Pyx_KwHashTable_Lookup(kwhash, key);
+            if (likely(index >= num_pos_args) && likely(*argnames[index] == key)) {
+                values[index] = kwvalues[i];
+                continue;
+            }
+        }
+        name = first_kw_arg;
+        while (*name && **name != key) name++;
+        if (unlikely(!*name)) return -1;
+        values[name-argnames] = kwvalues[i];
+    }
+    return 0;
+}
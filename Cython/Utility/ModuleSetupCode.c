@@ -40,6 +40,10 @@
 #define CYTHON_COMPILING_IN_CPYTHON 1
 #endif
 
+#ifndef CYTHON_SHARED_RUNTIME
+  #define CYTHON_SHARED_RUNTIME 0
+#endif
+
 #if PY_VERSION_HEX < 0x02050000
   typedef int Py_ssize_t;
   #define PY_SSIZE_T_MAX INT_MAX
@@ -314,6 +318,17 @@ typedef struct {PyObject **p; char *s; const Py_ssize_t n; const char* encoding;
   #define __PYX_FORCE_INIT_THREADS 0
 #endif
 
+/////////////// OpenMPSimd.proto ///////////////
+
+/* The simd construct and its clauses require OpenMP 4.0 */
+#if defined(_OPENMP) && _OPENMP >= 201307
+  #define __PYX_OMP_SIMD simd
+  #define __PYX_OMP_SIMD_CLAUSE(clause) clause
+#else
+  #define __PYX_OMP_SIMD
+  #define __PYX_OMP_SIMD_CLAUSE(clause)
+#endif
+
 /////////////// InitThreads.init ///////////////
 
 #ifdef WITH_THREAD
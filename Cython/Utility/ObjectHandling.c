@@ -871,19 +871,46 @@ static PyObject *__Pyx_GetNameInClass(PyObject *nmspace, PyObject *name) {
     PyObject *result;
     result = __Pyx_PyObject_GetAttrStr(nmspace, name);
     if (!result)
-        result = __Pyx_GetModuleGlobalName(name);
+        result = __Pyx__GetModuleGlobalName(name);
     return result;
 }
 
 /////////////// GetModuleGlobalName.proto ///////////////
+//@substitute: naming
 
-static CYTHON_INLINE PyObject *__Pyx_GetModuleGlobalName(PyObject *name); /*proto*/
+// CPython 3.6+ tags each dict with a version that changes on every
+// modification (PEP 509).  Each lookup site keeps the value that it found
+// together with the version of the module dict, and only repeats the lookup
+// when the dict has changed since.  Code that looks up varying names must
+// call __Pyx__GetModuleGlobalName() instead.
+#ifndef CYTHON_USE_DICT_VERSIONS
+  #define CYTHON_USE_DICT_VERSIONS (CYTHON_COMPILING_IN_CPYTHON && PY_VERSION_HEX >= 0x030600B1 && PY_VERSION_HEX < 0x030C0000)
+#endif
+
+#if CYTHON_USE_DICT_VERSIONS
+#define __PYX_GET_DICT_VERSION(dict)  (((PyDictObject*)(dict))->ma_version_tag)
+
+#define __Pyx_GetModuleGlobalName(var, name)  { \
+    static unsigned PY_LONG_LONG __pyx_dict_version = 0; \
+    static PyObject *__pyx_dict_cached_value = NULL; \
+    if (likely(__pyx_dict_version == __PYX_GET_DICT_VERSION($moddict_cname)) && likely(__pyx_dict_cached_value)) { \
+        (var) = __pyx_dict_cached_value; \
+        Py_INCREF(var); \
+    } else { \
+        (var) = __Pyx__GetModuleGlobalNameVersioned(name, &__pyx_dict_version, &__pyx_dict_cached_value); \
+    } \
+}
+static PyObject *__Pyx__GetModuleGlobalNameVersioned(PyObject *name, unsigned PY_LONG_LONG *dict_version, PyObject **dict_cached_value); /*proto*/
+#else
+#define __Pyx_GetModuleGlobalName(var, name)  (var) = __Pyx__GetModuleGlobalName(name)
+#endif
+static CYTHON_INLINE PyObject *__Pyx__GetModuleGlobalName(PyObject *name); /*proto*/
 
 /////////////// GetModuleGlobalName ///////////////
 //@requires: GetBuiltinName
 //@substitute: naming
 
-static CYTHON_INLINE PyObject *__Pyx_GetModuleGlobalName(PyObject *name) {
+static CYTHON_INLINE PyObject *__Pyx__GetModuleGlobalName(PyObject *name) {
     PyObject *result;
 #if CYTHON_COMPILING_IN_CPYTHON
     result = PyDict_GetItem($moddict_cname, name);
@@ -900,6 +927,54 @@ static CYTHON_INLINE PyObject *__Pyx_GetModuleGlobalName(PyObject *name) {
     return result;
 }
 
+#if CYTHON_USE_DICT_VERSIONS
+static PyObject *__Pyx__GetModuleGlobalNameVersioned(PyObject *name, unsigned PY_LONG_LONG *dict_version, PyObject **dict_cached_value) {
+    PyObject *result = PyDict_GetItem($moddict_cname, name);
+    *dict_version = __PYX_GET_DICT_VERSION($moddict_cname);
+    *dict_cached_value = result;
+    if (result) {
+        Py_INCREF(result);
+        return result;
+    }
+    return __Pyx_GetBuiltinName(name);
+}
+#endif
+
+/////////////// GlobalsFrozen.proto ///////////////
+//@substitute: naming
+
+static int $globals_frozen_cname = 0;
+
+/////////////// GetFrozenModuleGlobalName.proto ///////////////
+
+// With the 'frozen_globals' directive, globals and builtins are looked up
+// only once after the module init function has completed, and each lookup
+// site keeps a reference to the object that it found.
+#define __Pyx_GetFrozenModuleGlobalName(var, name)  { \
+    static PyObject *__pyx_frozen_value = NULL; \
+    if (likely(__pyx_frozen_value)) { \
+        (var) = __pyx_frozen_value; \
+        Py_INCREF(var); \
+    } else { \
+        (var) = __Pyx__GetFrozenModuleGlobalName(name, &__pyx_frozen_value); \
+    } \
+}
+static PyObject *__Pyx__GetFrozenModuleGlobalName(PyObject *name, PyObject **cached_value); /*proto*/
+
+/////////////// GetFrozenModuleGlobalName ///////////////
+//@requires: GetModuleGlobalName
+//@requires: GlobalsFrozen
+//@substitute: naming
+
+static PyObject *__Pyx__GetFrozenModuleGlobalName(PyObject *name, PyObject **cached_value) {
+    PyObject *result = __Pyx__GetModuleGlobalName(name);
+    if (likely(result) && $globals_frozen_cname) {
+        Py_INCREF(result);
+        *cached_value = result;
+    }
+    return result;
+}
+
 /////////////// PyObjectGetAttrStr.proto ///////////////
 
 #if CYTHON_COMPILING_IN_CPYTHON
@@ -917,6 +992,221 @@ static CYTHON_INLINE PyObject* __Pyx_PyObject_GetAttrStr(PyObject* obj, PyObject
 #define __Pyx_PyObject_GetAttrStr(o,n) PyObject_GetAttr(o,n)
 #endif
 
+/////////////// PyObjectGetAttrStrCached.proto ///////////////
+
+// Each attribute lookup site keeps the result of the type lookup of the last
+// type that it saw, which stays valid as long as the type keeps its version
+// tag (the same invalidation that CPython's global method cache relies on).
+// Only types that use the generic attribute lookup are cached.  Slots
+// (member descriptors of object type) are read directly at their offset.
+#ifndef CYTHON_USE_ATTR_CACHE
+  #define CYTHON_USE_ATTR_CACHE (CYTHON_COMPILING_IN_CPYTHON && PY_VERSION_HEX >= 0x02060000 && PY_VERSION_HEX < 0x030B0000)
+#endif
+
+#if CYTHON_USE_ATTR_CACHE
+typedef struct {
+    PyTypeObject *type;
+    unsigned int version_tag;
+    PyObject *descr; /* borrowed from the type, NULL if the type does not define the attribute */
+    Py_ssize_t member_offset; /* offset of a slot in the object, or 0 */
+} __Pyx_AttrCache;
+
+#define __Pyx_PyObject_GetAttrStrCached(var, obj, attr_name)  { \
+    static __Pyx_AttrCache __pyx_attr_cache = {0, 0, 0, 0}; \
+    (var) = __Pyx__PyObject_GetAttrStrCached(obj, attr_name, &__pyx_attr_cache); \
+}
+static PyObject *__Pyx__PyObject_GetAttrStrCached(PyObject *obj, PyObject *attr_name, __Pyx_AttrCache *cache); /*proto*/
+#else
+#define __Pyx_PyObject_GetAttrStrCached(var, obj, attr_name)  (var) = __Pyx_PyObject_GetAttrStr(obj, attr_name)
+#endif
+
+/////////////// PyObjectGetAttrStrCached ///////////////
+//@requires: PyObjectGetAttrStr
+
+#if CYTHON_USE_ATTR_CACHE
+#include <structmember.h>
+
+#if PY_MAJOR_VERSION < 3
+  #define __Pyx_HasDescrGet(descr)  PyType_HasFeature(Py_TYPE(descr), Py_TPFLAGS_HAVE_CLASS)
+#else
+  #define __Pyx_HasDescrGet(descr)  1
+#endif
+
+static Py_ssize_t __Pyx_AttrCache_MemberOffset(PyTypeObject *tp, PyObject *descr) {
+#if PY_VERSION_HEX >= 0x02070000
+    PyMemberDef *member;
+    if (!descr || Py_TYPE(descr) != &PyMemberDescr_Type)
+        return 0;
+    member = ((PyMemberDescrObject *)descr)->d_member;
+    if (member->type != T_OBJECT_EX || (member->flags & READ_RESTRICTED))
+        return 0;
+    if (!PyType_IsSubtype(tp, ((PyDescrObject *)descr)->d_type))
+        return 0;
+    return member->offset;
+#else
+    return 0;
+#endif
+}
+
+// Returns the (borrowed) result of _PyType_Lookup(tp, attr_name).
+static CYTHON_INLINE PyObject *__Pyx_AttrCache_Lookup(PyTypeObject *tp, PyObject *attr_name, __Pyx_AttrCache *cache) {
+    PyObject *descr;
+    if (likely(cache->type == tp) && likely(PyType_HasFeature(tp, Py_TPFLAGS_VALID_VERSION_TAG)) &&
+            likely(cache->version_tag == tp->tp_version_tag))
+        return cache->descr;
+    descr = _PyType_Lookup(tp, attr_name);
+    if (PyType_HasFeature(tp, Py_TPFLAGS_VALID_VERSION_TAG)) {
+        cache->type = tp;
+        cache->version_tag = tp->tp_version_tag;
+        cache->descr = descr;
+        cache->member_offset = __Pyx_AttrCache_MemberOffset(tp, descr);
+    } else {
+        cache->type = NULL;
+    }
+    return descr;
+}
+
+static PyObject *__Pyx__PyObject_GetAttrStrCached(PyObject *obj, PyObject *attr_name, __Pyx_AttrCache *cache) {
+    PyTypeObject *tp = Py_TYPE(obj);
+    PyObject *descr, *result, **dictptr;
+    descrgetfunc f = NULL;
+    if (unlikely(tp->tp_getattro != PyObject_GenericGetAttr || !tp->tp_dict))
+        return __Pyx_PyObject_GetAttrStr(obj, attr_name);
+    descr = __Pyx_AttrCache_Lookup(tp, attr_name, cache);
+    if (cache->member_offset && likely(cache->type == tp)) {
+        result = *(PyObject **)((char *)obj + cache->member_offset);
+        if (likely(result)) {
+            Py_INCREF(result);
+            return result;
+        }
+        // let the member descriptor raise the AttributeError
+    }
+    // from here on, this follows PyObject_GenericGetAttr()
+    Py_XINCREF(descr);
+    if (descr && __Pyx_HasDescrGet(descr)) {
+        f = Py_TYPE(descr)->tp_descr_get;
+        if (f && PyDescr_IsData(descr)) {
+            result = f(descr, obj, (PyObject *)tp);
+            Py_DECREF(descr);
+            return result;
+        }
+    }
+    dictptr = _PyObject_GetDictPtr(obj);
+    if (dictptr && *dictptr) {
+        PyObject *dict = *dictptr;
+        Py_INCREF(dict);
+        result = PyDict_GetItem(dict, attr_name);
+        if (result) {
+            Py_INCREF(result);
+            Py_XDECREF(descr);
+            Py_DECREF(dict);
+            return result;
+        }
+        Py_DECREF(dict);
+    }
+    if (f) {
+        result = f(descr, obj, (PyObject *)tp);
+        Py_DECREF(descr);
+        return result;
+    }
+    if (descr)
+        return descr;
+    // let the generic lookup raise the AttributeError
+    return __Pyx_PyObject_GetAttrStr(obj, attr_name);
+}
+#endif
+
+/////////////// PyMethodDescrType.proto ///////////////
+
+static PyTypeObject *__Pyx_PyMethodDescr_Type(void); /*proto*/
+
+/////////////// PyMethodDescrType ///////////////
+
+// The type of methods of builtin types (and Cython's extension types),
+// which not all Python versions export.
+static PyTypeObject *__Pyx_PyMethodDescr_Type(void) {
+    static PyTypeObject *method_descr_type = NULL;
+    if (unlikely(!method_descr_type)) {
+        PyObject *descr = PyDict_GetItemString(PyList_Type.tp_dict, "append");
+        if (descr)
+            method_descr_type = Py_TYPE(descr);
+    }
+    return method_descr_type;
+}
+
+/////////////// PyObjectGetMethod.proto ///////////////
+//@requires: PyObjectGetAttrStrCached
+
+// Looks up a method for calling it.  If the type defines it as a plain
+// function, CyFunction or method descriptor (and the instance does not
+// shadow it), the unbound function is returned and *is_unbound is set
+// to 1, and the caller must pass 'obj' as first argument.  Otherwise,
+// this returns the normal attribute value.
+#if CYTHON_USE_ATTR_CACHE
+#define __Pyx_PyObject_GetMethodCached(is_unbound, method, obj, attr_name)  { \
+    static __Pyx_AttrCache __pyx_attr_cache = {0, 0, 0, 0}; \
+    (method) = __Pyx__PyObject_GetMethod(obj, attr_name, &__pyx_attr_cache, &(is_unbound)); \
+}
+static PyObject *__Pyx__PyObject_GetMethod(PyObject *obj, PyObject *attr_name, __Pyx_AttrCache *cache, int *is_unbound); /*proto*/
+#else
+#define __Pyx_PyObject_GetMethodCached(is_unbound, method, obj, attr_name)  \
+    (method) = __Pyx_PyObject_GetMethod(obj, attr_name, &(is_unbound))
+#endif
+static CYTHON_INLINE PyObject *__Pyx_PyObject_GetMethod(PyObject *obj, PyObject *attr_name, int *is_unbound); /*proto*/
+
+/////////////// PyObjectGetMethod ///////////////
+//@requires: PyMethodDescrType
+//@requires: CythonFunction.c::CyFunctionVectorcall
+
+#if CYTHON_USE_ATTR_CACHE
+static CYTHON_INLINE int __Pyx_IsUnboundMethod(PyObject *descr) {
+    if (PyFunction_Check(descr) || Py_TYPE(descr) == __Pyx_PyMethodDescr_Type())
+        return 1;
+    if (__Pyx_IsAnyCyFunction(descr))
+        return !(((__pyx_CyFunctionVectorcallHead *) descr)->flags &
+                 (__Pyx_CYFUNCTION_STATICMETHOD | __Pyx_CYFUNCTION_CLASSMETHOD));
+    return 0;
+}
+
+static PyObject *__Pyx__PyObject_GetMethod(PyObject *obj, PyObject *attr_name, __Pyx_AttrCache *cache, int *is_unbound) {
+    PyTypeObject *tp = Py_TYPE(obj);
+    PyObject *descr, *attr, **dictptr;
+    *is_unbound = 0;
+    if (likely(tp->tp_getattro == PyObject_GenericGetAttr) && likely(tp->tp_dict)) {
+        descr = __Pyx_AttrCache_Lookup(tp, attr_name, cache);
+        if (descr && __Pyx_IsUnboundMethod(descr)) {
+            // methods are non-data descriptors, so the instance dict comes first
+            Py_INCREF(descr);
+            dictptr = _PyObject_GetDictPtr(obj);
+            if (dictptr && *dictptr) {
+                PyObject *dict = *dictptr;
+                Py_INCREF(dict);
+                attr = PyDict_GetItem(dict, attr_name);
+                Py_XINCREF(attr);
+                Py_DECREF(dict);
+                if (attr) {
+                    Py_DECREF(descr);
+                    return attr;
+                }
+            }
+            *is_unbound = 1;
+            return descr;
+        }
+    }
+    return __Pyx__PyObject_GetAttrStrCached(obj, attr_name, cache);
+}
+#endif
+
+static CYTHON_INLINE PyObject *__Pyx_PyObject_GetMethod(PyObject *obj, PyObject *attr_name, int *is_unbound) {
+#if CYTHON_USE_ATTR_CACHE
+    __Pyx_AttrCache cache = {0, 0, 0, 0};
+    return __Pyx__PyObject_GetMethod(obj, attr_name, &cache, is_unbound);
+#else
+    *is_unbound = 0;
+    return __Pyx_PyObject_GetAttrStr(obj, attr_name);
+#endif
+}
+
 /////////////// PyObjectSetAttrStr.proto ///////////////
 
 #if CYTHON_COMPILING_IN_CPYTHON
@@ -937,29 +1227,158 @@ static CYTHON_INLINE int __Pyx_PyObject_SetAttrStr(PyObject* obj, PyObject* attr
 #endif
 
 /////////////// PyObjectCallMethod.proto ///////////////
-//@requires: PyObjectGetAttrStr
-//@substitute: naming
 
-static PyObject* __Pyx_PyObject_CallMethodTuple(PyObject* obj, PyObject* method_name, PyObject* args) {
-    PyObject *method, *result = NULL;
-    if (unlikely(!args)) return NULL;
-    method = __Pyx_PyObject_GetAttrStr(obj, method_name);
-    if (unlikely(!method)) goto bad;
-    result = PyObject_Call(method, args, NULL);
-    Py_DECREF(method);
-bad:
-    Py_DECREF(args);
-    return result;
-}
+static PyObject* __Pyx__PyObject_CallMethod(PyObject* obj, PyObject* method_name, Py_ssize_t nargs,
+                                            PyObject* arg1, PyObject* arg2, PyObject* arg3); /*proto*/
 
 #define __Pyx_PyObject_CallMethod3(obj, name, arg1, arg2, arg3) \
-    __Pyx_PyObject_CallMethodTuple(obj, name, PyTuple_Pack(3, arg1, arg2, arg3))
+    __Pyx__PyObject_CallMethod(obj, name, 3, arg1, arg2, arg3)
 #define __Pyx_PyObject_CallMethod2(obj, name, arg1, arg2) \
-    __Pyx_PyObject_CallMethodTuple(obj, name, PyTuple_Pack(2, arg1, arg2))
+    __Pyx__PyObject_CallMethod(obj, name, 2, arg1, arg2, NULL)
 #define __Pyx_PyObject_CallMethod1(obj, name, arg1) \
-    __Pyx_PyObject_CallMethodTuple(obj, name, PyTuple_Pack(1, arg1))
+    __Pyx__PyObject_CallMethod(obj, name, 1, arg1, NULL, NULL)
 #define __Pyx_PyObject_CallMethod0(obj, name) \
-    __Pyx_PyObject_CallMethodTuple(obj, name, (Py_INCREF($empty_tuple), $empty_tuple))
+    __Pyx__PyObject_CallMethod(obj, name, 0, NULL, NULL, NULL)
+
+/////////////// PyObjectCallMethod ///////////////
+//@requires: PyObjectGetMethod
+//@requires: PyObjectVectorCall
+
+static PyObject* __Pyx__PyObject_CallMethod(PyObject* obj, PyObject* method_name, Py_ssize_t nargs,
+                                            PyObject* arg1, PyObject* arg2, PyObject* arg3) {
+    PyObject *args[4], *method, *result;
+    int is_unbound;
+    method = __Pyx_PyObject_GetMethod(obj, method_name, &is_unbound);
+    if (unlikely(!method)) return NULL;
+    args[0] = obj;
+    args[1] = arg1;
+    args[2] = arg2;
+    args[3] = arg3;
+    result = __Pyx_PyObject_VectorCall(method, args + 1 - is_unbound, nargs + is_unbound, NULL);
+    Py_DECREF(method);
+    return result;
+}
+
+
+/////////////// PyObjectVectorCall.proto ///////////////
+
+static PyObject* __Pyx_PyObject_VectorCall(PyObject *func, PyObject **args, Py_ssize_t nargs, PyObject *kwnames); /*proto*/
+
+/////////////// PyObjectVectorCall ///////////////
+//@requires: CythonFunction.c::CyFunctionVectorcall
+//@requires: FunctionArguments.c::VectorcallArgsToTuple
+//@requires: PyMethodDescrType
+
+#if CYTHON_COMPILING_IN_CPYTHON
+static CYTHON_INLINE PyObject* __Pyx_PyObject_CallChecked(PyObject *result) {
+    if (unlikely(!result) && unlikely(!PyErr_Occurred())) {
+        PyErr_SetString(PyExc_SystemError,
+                        "NULL result without error in PyObject_Call");
+    }
+    return result;
+}
+#endif
+
+// __Pyx_PyObject_VectorCall calls an object with a C array of the positional
+// arguments, followed by the values of the keyword arguments in 'kwnames'.
+// CyFunctions with a vectorcall entry point receive the array directly, also
+// when they are bound as methods, and METH_O and METH_NOARGS functions and
+// method descriptors get their argument without a tuple.  Everything else is
+// called through a new argument tuple and keyword dict.
+
+#if CYTHON_COMPILING_IN_CPYTHON
+// 'func' is a method descriptor and args[0] an instance of its type
+static PyObject* __Pyx_PyMethodDescr_VectorCall(PyObject *func, PyObject **args, Py_ssize_t nargs, PyObject *kwnames) {
+    PyMethodDef *def = ((PyMethodDescrObject *) func)->d_method;
+    PyObject *self = args[0], *argtuple, *kwargs, *result;
+    int flags = def->ml_flags & ~METH_COEXIST;
+    if (!kwnames && ((flags == METH_O && nargs == 2) || (flags == METH_NOARGS && nargs == 1))) {
+        if (unlikely(Py_EnterRecursiveCall((char*)" while calling a Python object")))
+            return NULL;
+        result = (*def->ml_meth)(self, nargs == 2 ? args[1] : NULL);
+        Py_LeaveRecursiveCall();
+        return __Pyx_PyObject_CallChecked(result);
+    }
+    if (flags == (METH_VARARGS | METH_KEYWORDS) || (flags == METH_VARARGS && !kwnames)) {
+        if (unlikely(__Pyx_VectorcallArgsToTuple(args + 1, nargs - 1, kwnames, &argtuple, &kwargs) < 0))
+            return NULL;
+        if (unlikely(Py_EnterRecursiveCall((char*)" while calling a Python object"))) {
+            result = NULL;
+        } else {
+            if (flags & METH_KEYWORDS)
+                result = (*(PyCFunctionWithKeywords)def->ml_meth)(self, argtuple, kwargs);
+            else
+                result = (*def->ml_meth)(self, argtuple);
+            Py_LeaveRecursiveCall();
+            result = __Pyx_PyObject_CallChecked(result);
+        }
+    } else {
+        // let the method descriptor check the arguments
+        if (unlikely(__Pyx_VectorcallArgsToTuple(args, nargs, kwnames, &argtuple, &kwargs) < 0))
+            return NULL;
+        result = PyObject_Call(func, argtuple, kwargs);
+    }
+    Py_DECREF(argtuple);
+    Py_XDECREF(kwargs);
+    return result;
+}
+#endif
+
+static PyObject* __Pyx_PyObject_VectorCall(PyObject *func, PyObject **args, Py_ssize_t nargs, PyObject *kwnames) {
+    PyObject *argtuple, *kwargs, *result;
+#if CYTHON_COMPILING_IN_CPYTHON
+    __pyx_vectorcallfunc vectorcall;
+    if (Py_TYPE(func)->tp_call == PyCFunction_Call) {
+        // PyCFunction or a subtype like the CyFunction
+        vectorcall = __Pyx_CyFunction_GetVectorcall(func);
+        if (vectorcall) {
+            if (unlikely(Py_EnterRecursiveCall((char*)" while calling a Python object")))
+                return NULL;
+            result = vectorcall(func, args, nargs, kwnames);
+            Py_LeaveRecursiveCall();
+            return __Pyx_PyObject_CallChecked(result);
+        }
+        if (!kwnames) {
+            int flags = PyCFunction_GET_FLAGS(func) & ~(METH_CLASS | METH_STATIC | METH_COEXIST);
+            if ((flags == METH_O && nargs == 1) || (flags == METH_NOARGS && nargs == 0)) {
+                if (unlikely(Py_EnterRecursiveCall((char*)" while calling a Python object")))
+                    return NULL;
+                result = (*PyCFunction_GET_FUNCTION(func))(
+                    PyCFunction_GET_SELF(func), nargs ? args[0] : NULL);
+                Py_LeaveRecursiveCall();
+                return __Pyx_PyObject_CallChecked(result);
+            }
+        }
+    } else if (nargs && Py_TYPE(func) == __Pyx_PyMethodDescr_Type() &&
+               PyObject_TypeCheck(args[0], ((PyDescrObject *) func)->d_type)) {
+        // unbound method of a builtin or extension type
+        return __Pyx_PyMethodDescr_VectorCall(func, args, nargs, kwnames);
+    } else if (PyMethod_Check(func) && PyMethod_GET_SELF(func)) {
+        // bound method: pass 'self' as first argument of the function
+        PyObject *stack[8];
+        PyObject *function = PyMethod_GET_FUNCTION(func);
+        Py_ssize_t nkw = kwnames ? PyTuple_GET_SIZE(kwnames) : 0;
+        if (nargs + nkw < 8 && Py_TYPE(function)->tp_call == PyCFunction_Call) {
+            vectorcall = __Pyx_CyFunction_GetVectorcall(function);
+            if (vectorcall) {
+                stack[0] = PyMethod_GET_SELF(func);
+                memcpy(stack+1, args, (size_t)(nargs + nkw) * sizeof(PyObject*));
+                if (unlikely(Py_EnterRecursiveCall((char*)" while calling a Python object")))
+                    return NULL;
+                result = vectorcall(function, stack, nargs+1, kwnames);
+                Py_LeaveRecursiveCall();
+                return __Pyx_PyObject_CallChecked(result);
+            }
+        }
+    }
+#endif
+    if (unlikely(__Pyx_VectorcallArgsToTuple(args, nargs, kwnames, &argtuple, &kwargs) < 0))
+        return NULL;
+    result = PyObject_Call(func, argtuple, kwargs);
+    Py_DECREF(argtuple);
+    Py_XDECREF(kwargs);
+    return result;
+}
 
 
 /////////////// tp_new.proto ///////////////
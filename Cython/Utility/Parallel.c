@@ -0,0 +1,887 @@
+/////////////// ParallelProfile.proto ///////////////
+//@requires: Atomic.c::AtomicTypes
+
+// Per-thread statistics of the parallel sections of a module, enabled by
+// the parallel_profile directive.  Each OpenMP thread number has a slot,
+// threads beyond __PYX_PARALLEL_PROFILE_MAX_THREADS share the last one,
+// and teams started by different Python threads can run the same section
+// at the same time.  All counters are therefore updated and read with the
+// (relaxed) atomic operations of cython.atomic, which the compiler
+// generates along with this code.
+
+#include <time.h>
+
+#ifndef __PYX_PARALLEL_PROFILE_MAX_THREADS
+  #define __PYX_PARALLEL_PROFILE_MAX_THREADS 256
+#endif
+
+typedef struct {
+    __Pyx_atomic_llong calls;
+    __Pyx_atomic_llong iterations;
+    __Pyx_atomic_llong chunks;
+    __Pyx_atomic_double busy_time;
+    __Pyx_atomic_double wait_time;
+} __Pyx_ParallelProfileThread;
+
+typedef struct __Pyx_ParallelProfileSection {
+    const char *filename;
+    int lineno;
+    const char *kind;
+    __Pyx_atomic_llong calls;
+    __Pyx_atomic_double wall_time;
+    __Pyx_atomic_int max_threads;
+    __Pyx_ParallelProfileThread threads[__PYX_PARALLEL_PROFILE_MAX_THREADS];
+    struct __Pyx_ParallelProfileSection *next;
+} __Pyx_ParallelProfileSection;
+
+static __Pyx_ParallelProfileSection *__pyx_parallel_profile_sections = NULL;
+
+static int __Pyx_ParallelProfile_Init(PyObject *module); /*proto*/
+static double __Pyx_ParallelProfile_Now(void); /*proto*/
+static void __Pyx_ParallelProfile_Register(__Pyx_ParallelProfileSection *section,
+                                           const char *filename, int lineno,
+                                           const char *kind); /*proto*/
+static void __Pyx_ParallelProfile_EndSection(__Pyx_ParallelProfileSection *section,
+                                             double start); /*proto*/
+static void __Pyx_ParallelProfile_RecordThread(__Pyx_ParallelProfileSection *section,
+                                               PY_LONG_LONG iterations, PY_LONG_LONG chunks,
+                                               double busy_time, double wait_time); /*proto*/
+static PyObject *__Pyx_ParallelProfile_Get(PyObject *self, PyObject *args); /*proto*/
+static PyObject *__Pyx_ParallelProfile_Dump(PyObject *self, PyObject *unused); /*proto*/
+
+/////////////// ParallelProfile ///////////////
+
+#define __Pyx_ParallelProfile_AddLongLong(ptr, value) \
+    __Pyx_atomic_fetch_add_PY_LONG_LONG(ptr, value, __Pyx_atomic_relaxed)
+#define __Pyx_ParallelProfile_AddDouble(ptr, value) \
+    __Pyx_atomic_fetch_add_double(ptr, value, __Pyx_atomic_relaxed)
+#define __Pyx_ParallelProfile_LoadLongLong(ptr) \
+    __Pyx_atomic_load_PY_LONG_LONG(ptr, __Pyx_atomic_relaxed)
+#define __Pyx_ParallelProfile_LoadDouble(ptr) \
+    __Pyx_atomic_load_double(ptr, __Pyx_atomic_relaxed)
+
+/* Adds the functions of the profiler to the module, returns -1 on error */
+static int __Pyx_ParallelProfile_Init(PyObject *module) {
+    static PyMethodDef get_def = {
+        __Pyx_NAMESTR("__pyx_parallel_profile__"), (PyCFunction)__Pyx_ParallelProfile_Get, METH_VARARGS,
+        __Pyx_DOCSTR("__pyx_parallel_profile__(reset=False)\n"
+                     "Return the per-thread statistics of the profiled parallel sections of this module.")};
+    static PyMethodDef dump_def = {
+        __Pyx_NAMESTR("__pyx_parallel_profile_dump__"), (PyCFunction)__Pyx_ParallelProfile_Dump, METH_NOARGS, 0};
+    PyObject *atexit, *func, *res;
+
+    func = PyCFunction_New(&get_def, 0);
+    if (!func)
+        return -1;
+    if (PyModule_AddObject(module, "__pyx_parallel_profile__", func) < 0) {
+        Py_DECREF(func);
+        return -1;
+    }
+    if (!getenv("CYTHON_PARALLEL_PROFILE"))
+        return 0;
+
+    /* dump the statistics as JSON when the interpreter exits */
+    atexit = PyImport_ImportModule("atexit");
+    if (!atexit)
+        return -1;
+    func = PyCFunction_New(&dump_def, 0);
+    if (!func) {
+        Py_DECREF(atexit);
+        return -1;
+    }
+    res = PyObject_CallMethod(atexit, (char*) "register", (char*) "O", func);
+    Py_DECREF(func);
+    Py_DECREF(atexit);
+    if (!res)
+        return -1;
+    Py_DECREF(res);
+    return 0;
+}
+
+static double __Pyx_ParallelProfile_Now(void) {
+#ifdef _OPENMP
+    return omp_get_wtime();
+#else
+    return ((double) clock()) / CLOCKS_PER_SEC;
+#endif
+}
+
+static void __Pyx_ParallelProfile_Register(__Pyx_ParallelProfileSection *section,
+                                           const char *filename, int lineno,
+                                           const char *kind) {
+    section->filename = filename;
+    section->lineno = lineno;
+    section->kind = kind;
+    section->next = __pyx_parallel_profile_sections;
+    __pyx_parallel_profile_sections = section;
+}
+
+static void __Pyx_ParallelProfile_EndSection(__Pyx_ParallelProfileSection *section,
+                                             double start) {
+    __Pyx_ParallelProfile_AddLongLong(&section->calls, 1);
+    __Pyx_ParallelProfile_AddDouble(&section->wall_time, __Pyx_ParallelProfile_Now() - start);
+}
+
+static void __Pyx_ParallelProfile_RecordThread(__Pyx_ParallelProfileSection *section,
+                                               PY_LONG_LONG iterations, PY_LONG_LONG chunks,
+                                               double busy_time, double wait_time) {
+    __Pyx_ParallelProfileThread *thread;
+    int tid = 0, nthreads = 1;
+#ifdef _OPENMP
+    tid = omp_get_thread_num();
+    nthreads = omp_get_num_threads();
+#endif
+    if (tid >= __PYX_PARALLEL_PROFILE_MAX_THREADS)
+        tid = __PYX_PARALLEL_PROFILE_MAX_THREADS - 1;
+    thread = &section->threads[tid];
+    __Pyx_ParallelProfile_AddLongLong(&thread->calls, 1);
+    __Pyx_ParallelProfile_AddLongLong(&thread->iterations, iterations);
+    __Pyx_ParallelProfile_AddLongLong(&thread->chunks, chunks);
+    __Pyx_ParallelProfile_AddDouble(&thread->busy_time, busy_time);
+    __Pyx_ParallelProfile_AddDouble(&thread->wait_time, wait_time);
+    if (tid == 0) {
+        int max_threads = __Pyx_atomic_load_int(&section->max_threads, __Pyx_atomic_relaxed);
+        while (nthreads > max_threads && !__Pyx_atomic_compare_exchange_int(
+                &section->max_threads, &max_threads, nthreads, __Pyx_atomic_relaxed));
+    }
+}
+
+static PyObject *__Pyx_ParallelProfile_Get(CYTHON_UNUSED PyObject *self, PyObject *args) {
+    __Pyx_ParallelProfileSection *section;
+    PyObject *result, *item = NULL, *threads = NULL, *thread_stats = NULL;
+    int reset = 0, i;
+
+    if (args && !PyArg_ParseTuple(args, "|i:__pyx_parallel_profile__", &reset))
+        return NULL;
+    result = PyList_New(0);
+    if (!result)
+        return NULL;
+
+    for (section = __pyx_parallel_profile_sections; section; section = section->next) {
+        double max_busy = 0, total_busy = 0;
+        int participating = 0;
+
+        threads = PyList_New(0);
+        if (!threads)
+            goto bad;
+        for (i = 0; i < __PYX_PARALLEL_PROFILE_MAX_THREADS; i++) {
+            __Pyx_ParallelProfileThread *thread = &section->threads[i];
+            PY_LONG_LONG calls = __Pyx_ParallelProfile_LoadLongLong(&thread->calls);
+            double busy_time;
+            if (!calls)
+                continue;
+            busy_time = __Pyx_ParallelProfile_LoadDouble(&thread->busy_time);
+            participating++;
+            total_busy += busy_time;
+            if (busy_time > max_busy)
+                max_busy = busy_time;
+            thread_stats = Py_BuildValue("{s:i,s:L,s:L,s:L,s:d,s:d}",
+                "thread", i,
+                "calls", calls,
+                "iterations", __Pyx_ParallelProfile_LoadLongLong(&thread->iterations),
+                "chunks", __Pyx_ParallelProfile_LoadLongLong(&thread->chunks),
+                "busy_time", busy_time,
+                "wait_time", __Pyx_ParallelProfile_LoadDouble(&thread->wait_time));
+            if (!thread_stats || PyList_Append(threads, thread_stats) < 0)
+                goto bad;
+            Py_CLEAR(thread_stats);
+        }
+
+        /* 1.0 means that all threads were busy for the same time */
+        item = Py_BuildValue("{s:s,s:i,s:s,s:L,s:d,s:i,s:d,s:O}",
+            "file", section->filename,
+            "line", section->lineno,
+            "kind", section->kind,
+            "calls", __Pyx_ParallelProfile_LoadLongLong(&section->calls),
+            "wall_time", __Pyx_ParallelProfile_LoadDouble(&section->wall_time),
+            "max_threads", __Pyx_atomic_load_int(&section->max_threads, __Pyx_atomic_relaxed),
+            "imbalance", total_busy > 0 ? max_busy * participating / total_busy : 1.0,
+            "threads", threads);
+        if (!item || PyList_Append(result, item) < 0)
+            goto bad;
+        Py_CLEAR(item);
+        Py_CLEAR(threads);
+
+        if (reset) {
+            /* concurrent updates are not lost, but may be split between
+               the returned and the next statistics */
+            __Pyx_ParallelProfile_AddLongLong(&section->calls, -__Pyx_ParallelProfile_LoadLongLong(&section->calls));
+            __Pyx_ParallelProfile_AddDouble(&section->wall_time, -__Pyx_ParallelProfile_LoadDouble(&section->wall_time));
+            __Pyx_atomic_store_int(&section->max_threads, 0, __Pyx_atomic_relaxed);
+            for (i = 0; i < __PYX_PARALLEL_PROFILE_MAX_THREADS; i++) {
+                __Pyx_ParallelProfileThread *thread = &section->threads[i];
+                __Pyx_ParallelProfile_AddLongLong(&thread->calls, -__Pyx_ParallelProfile_LoadLongLong(&thread->calls));
+                __Pyx_ParallelProfile_AddLongLong(&thread->iterations, -__Pyx_ParallelProfile_LoadLongLong(&thread->iterations));
+                __Pyx_ParallelProfile_AddLongLong(&thread->chunks, -__Pyx_ParallelProfile_LoadLongLong(&thread->chunks));
+                __Pyx_ParallelProfile_AddDouble(&thread->busy_time, -__Pyx_ParallelProfile_LoadDouble(&thread->busy_time));
+                __Pyx_ParallelProfile_AddDouble(&thread->wait_time, -__Pyx_ParallelProfile_LoadDouble(&thread->wait_time));
+            }
+        }
+    }
+    return result;
+bad:
+    Py_XDECREF(thread_stats);
+    Py_XDECREF(threads);
+    Py_XDECREF(item);
+    Py_DECREF(result);
+    return NULL;
+}
+
+static PyObject *__Pyx_ParallelProfile_Dump(CYTHON_UNUSED PyObject *self, CYTHON_UNUSED PyObject *unused) {
+    /* Append one JSON line per module to the file named by CYTHON_PARALLEL_PROFILE */
+    const char *path = getenv("CYTHON_PARALLEL_PROFILE");
+    PyObject *sections = NULL, *data = NULL, *json = NULL, *dumped = NULL, *bytes = NULL;
+    FILE *f;
+
+    if (!path || !*path)
+        goto done;
+    sections = __Pyx_ParallelProfile_Get(NULL, NULL);
+    if (!sections)
+        goto bad;
+    data = Py_BuildValue("{s:s,s:O}", "module", __Pyx_MODULE_NAME, "sections", sections);
+    if (!data)
+        goto bad;
+    json = PyImport_ImportModule("json");
+    if (!json)
+        goto bad;
+    dumped = PyObject_CallMethod(json, (char*) "dumps", (char*) "O", data);
+    if (!dumped)
+        goto bad;
+#if PY_MAJOR_VERSION >= 3
+    bytes = PyUnicode_AsUTF8String(dumped);
+    if (!bytes)
+        goto bad;
+#else
+    bytes = dumped;
+    Py_INCREF(bytes);
+#endif
+    f = fopen(path, "a");
+    if (!f) {
+        PyErr_SetFromErrnoWithFilename(PyExc_IOError, (char*) path);
+        goto bad;
+    }
+    fwrite(PyBytes_AS_STRING(bytes), 1, (size_t) PyBytes_GET_SIZE(bytes), f);
+    fputc('\n', f);
+    fclose(f);
+done:
+    Py_XDECREF(sections);
+    Py_XDECREF(data);
+    Py_XDECREF(json);
+    Py_XDECREF(dumped);
+    Py_XDECREF(bytes);
+    Py_INCREF(Py_None);
+    return Py_None;
+bad:
+    Py_XDECREF(sections);
+    Py_XDECREF(data);
+    Py_XDECREF(json);
+    Py_XDECREF(dumped);
+    Py_XDECREF(bytes);
+    return NULL;
+}
+
+/////////////// AdaptiveSchedule.proto ///////////////
+
+// Runtime selection of the schedule of prange(schedule='adaptive') loops.
+// Each call site keeps a small history in static storage.  The first calls
+// try the static, dynamic and guided schedules, then the chunk size of the
+// fastest one is tuned by doubling or halving it as long as the time per
+// iteration improves.  The search restarts when the iteration count changes
+// by more than a factor of two, and periodically to follow changes in the
+// load of the machine.  Loops of the same call site that are started from
+// different Python threads share the history, which is only accessed in a
+// named OpenMP critical section.  A measurement is dropped when the search
+// moved on while the loop was running.
+//
+// Setting the environment variable CYTHON_ADAPTIVE_SCHEDULE to
+// "deterministic" (or defining the macro of the same name) always selects
+// the static schedule, which makes the distribution of the iterations, and
+// thus the results of floating point reductions, reproducible.
+
+#ifndef __PYX_ADAPTIVE_SCHEDULE_RESTART
+  #define __PYX_ADAPTIVE_SCHEDULE_RESTART 128
+#endif
+
+typedef struct {
+    int state;
+    int kind;
+    int chunksize;
+    int best_chunksize;
+    int direction;
+    double nsteps;
+    double cost[3];
+    double best_cost;
+    PY_LONG_LONG calls;
+} __Pyx_AdaptiveSchedule;
+
+typedef struct {
+    double start;
+    double nsteps;
+    int state;
+    int kind;
+    int chunksize;
+    int saved_kind;
+    int saved_chunksize;
+} __Pyx_AdaptiveScheduleCall;
+
+static void __Pyx_AdaptiveSchedule_Begin(__Pyx_AdaptiveSchedule *schedule,
+                                         __Pyx_AdaptiveScheduleCall *call,
+                                         double nsteps); /*proto*/
+static void __Pyx_AdaptiveSchedule_End(__Pyx_AdaptiveSchedule *schedule,
+                                       __Pyx_AdaptiveScheduleCall *call); /*proto*/
+
+/////////////// AdaptiveSchedule ///////////////
+
+/* states of the search, the first three explore the schedule kinds */
+#define __PYX_ADAPTIVE_EXPLORE_STATIC  0
+#define __PYX_ADAPTIVE_EXPLORE_DYNAMIC 1
+#define __PYX_ADAPTIVE_EXPLORE_GUIDED  2
+#define __PYX_ADAPTIVE_TUNE            3
+#define __PYX_ADAPTIVE_STABLE          4
+
+#ifdef _OPENMP
+static int __Pyx_AdaptiveSchedule_Deterministic(void) {
+    static int deterministic = -1;
+    if (deterministic < 0) {
+#ifdef CYTHON_ADAPTIVE_SCHEDULE_DETERMINISTIC
+        deterministic = 1;
+#else
+        const char *mode = getenv("CYTHON_ADAPTIVE_SCHEDULE");
+        deterministic = mode && strcmp(mode, "deterministic") == 0;
+#endif
+    }
+    return deterministic;
+}
+
+static void __Pyx_AdaptiveSchedule_Restart(__Pyx_AdaptiveSchedule *schedule, double nsteps) {
+    double chunksize = nsteps / (omp_get_max_threads() * 8);
+    schedule->state = __PYX_ADAPTIVE_EXPLORE_STATIC;
+    schedule->nsteps = nsteps;
+    schedule->calls = 0;
+    schedule->best_chunksize = chunksize < 1 ? 1 : (chunksize > 1 << 20 ? 1 << 20 : (int) chunksize);
+}
+
+static void __Pyx_AdaptiveSchedule_Select(__Pyx_AdaptiveSchedule *schedule) {
+    switch (schedule->state) {
+        case __PYX_ADAPTIVE_EXPLORE_STATIC:
+            schedule->kind = omp_sched_static;
+            schedule->chunksize = 0;
+            break;
+        case __PYX_ADAPTIVE_EXPLORE_DYNAMIC:
+            schedule->kind = omp_sched_dynamic;
+            schedule->chunksize = schedule->best_chunksize;
+            break;
+        case __PYX_ADAPTIVE_EXPLORE_GUIDED:
+            schedule->kind = omp_sched_guided;
+            schedule->chunksize = 1;
+            break;
+        case __PYX_ADAPTIVE_TUNE:
+            schedule->chunksize = schedule->direction > 0 ?
+                schedule->best_chunksize * 2 : schedule->best_chunksize / 2;
+            if (schedule->chunksize < 1)
+                schedule->chunksize = 1;
+            break;
+        default:
+            schedule->chunksize = schedule->best_chunksize;
+    }
+}
+
+static void __Pyx_AdaptiveSchedule_Update(__Pyx_AdaptiveSchedule *schedule,
+                                          __Pyx_AdaptiveScheduleCall *call, double cost) {
+    int best;
+    if (call->state != schedule->state || call->kind != schedule->kind ||
+            call->chunksize != schedule->chunksize)
+        return;
+    switch (schedule->state) {
+        case __PYX_ADAPTIVE_EXPLORE_STATIC:
+        case __PYX_ADAPTIVE_EXPLORE_DYNAMIC:
+            schedule->cost[schedule->state++] = cost;
+            break;
+        case __PYX_ADAPTIVE_EXPLORE_GUIDED:
+            schedule->cost[2] = cost;
+            best = schedule->cost[1] < schedule->cost[0] ? 1 : 0;
+            best = schedule->cost[2] < schedule->cost[best] ? 2 : best;
+            schedule->best_cost = schedule->cost[best];
+            if (best == 0) {
+                schedule->kind = omp_sched_static;
+                schedule->best_chunksize = 0;
+                schedule->state = __PYX_ADAPTIVE_STABLE;
+            } else {
+                schedule->kind = best == 1 ? omp_sched_dynamic : omp_sched_guided;
+                if (best == 2)
+                    schedule->best_chunksize = 1;
+                schedule->direction = 1;
+                schedule->state = __PYX_ADAPTIVE_TUNE;
+            }
+            break;
+        case __PYX_ADAPTIVE_TUNE:
+            /* require a small improvement to be robust against noise */
+            if (cost < schedule->best_cost * 0.95) {
+                schedule->best_cost = cost;
+                schedule->best_chunksize = schedule->chunksize;
+                if (schedule->chunksize == 1 || schedule->chunksize >= schedule->nsteps)
+                    schedule->state = __PYX_ADAPTIVE_STABLE;
+            } else if (schedule->direction > 0 && schedule->best_chunksize > 1) {
+                schedule->direction = -1;
+            } else {
+                schedule->state = __PYX_ADAPTIVE_STABLE;
+            }
+            break;
+    }
+}
+#endif
+
+static void __Pyx_AdaptiveSchedule_Begin(__Pyx_AdaptiveSchedule *schedule,
+                                         __Pyx_AdaptiveScheduleCall *call,
+                                         double nsteps) {
+#ifdef _OPENMP
+    omp_sched_t kind;
+    int deterministic = 0;
+    omp_get_schedule(&kind, &call->saved_chunksize);
+    call->saved_kind = (int) kind;
+    call->nsteps = nsteps;
+    #pragma omp critical(__pyx_adaptive_schedule)
+    {
+        if (__Pyx_AdaptiveSchedule_Deterministic()) {
+            deterministic = 1;
+            call->kind = omp_sched_static;
+            call->chunksize = 0;
+        } else {
+            if (schedule->nsteps == 0 || nsteps > 2 * schedule->nsteps ||
+                    2 * nsteps < schedule->nsteps ||
+                    ++schedule->calls > __PYX_ADAPTIVE_SCHEDULE_RESTART) {
+                __Pyx_AdaptiveSchedule_Restart(schedule, nsteps);
+            }
+            __Pyx_AdaptiveSchedule_Select(schedule);
+            call->state = schedule->state;
+            call->kind = schedule->kind;
+            call->chunksize = schedule->chunksize;
+        }
+    }
+    omp_set_schedule((omp_sched_t) call->kind, call->chunksize);
+    call->start = deterministic ? -1 : omp_get_wtime();
+#else
+    (void) schedule; (void) call; (void) nsteps;
+#endif
+}
+
+static void __Pyx_AdaptiveSchedule_End(__Pyx_AdaptiveSchedule *schedule,
+                                       __Pyx_AdaptiveScheduleCall *call) {
+#ifdef _OPENMP
+    if (call->start >= 0) {
+        double cost = (omp_get_wtime() - call->start) / call->nsteps;
+        #pragma omp critical(__pyx_adaptive_schedule)
+        __Pyx_AdaptiveSchedule_Update(schedule, call, cost);
+    }
+    omp_set_schedule((omp_sched_t) call->saved_kind, call->saved_chunksize);
+#else
+    (void) schedule; (void) call;
+#endif
+}
+
+/////////////// ParallelThreadState.proto ///////////////
+//@requires: ModuleSetupCode.c::ForceInitThreads
+
+// Threads of the OpenMP runtime that raise exceptions need a Python thread
+// state that outlives the 'with gil' blocks, otherwise the exception would
+// be lost before it is saved for the master thread.  Threads that have no
+// thread state yet create one when they enter such a parallel section and
+// delete it again at its end, the threads that called into the parallel
+// section keep theirs and never acquire the GIL for this.  The helpers are
+// only called in OpenMP builds.
+
+#if defined(_OPENMP) && defined(WITH_THREAD)
+static int __Pyx_Parallel_EnsureThreadState(PyGILState_STATE *gilstate); /*proto*/
+static void __Pyx_Parallel_ReleaseThreadState(int created, PyGILState_STATE gilstate); /*proto*/
+#endif
+
+/////////////// ParallelThreadState ///////////////
+
+#if defined(_OPENMP) && defined(WITH_THREAD)
+/* Returns 1 if a thread state was created, which must be released again */
+static int __Pyx_Parallel_EnsureThreadState(PyGILState_STATE *gilstate) {
+    if (PyGILState_GetThisThreadState())
+        return 0;
+    *gilstate = PyGILState_Ensure();
+    PyEval_SaveThread();
+    return 1;
+}
+
+static void __Pyx_Parallel_ReleaseThreadState(int created, PyGILState_STATE gilstate) {
+    if (created) {
+        PyEval_RestoreThread(PyGILState_GetThisThreadState());
+        PyGILState_Release(gilstate);
+    }
+}
+#endif
+
+/////////////// RingBuffer.proto ///////////////
+
+// Bounded lock-free ring buffers of fixed size items for passing data
+// between threads without the GIL, declared in cython.ringbuffer
+// (Cython/Utility/RingBuffer.pyx).
+//
+// __Pyx_SPSCRing may only be used by one producer and one consumer thread at
+// a time, __Pyx_MPMCRing by any number of threads (Dmitry Vyukov's bounded
+// queue, every slot carries a sequence number).  Compilers without atomics
+// fall back to a lock per ring buffer.
+
+#include <string.h>
+#include <pythread.h>
+#if defined(_WIN32)
+  #include <windows.h>
+#else
+  #include <sched.h>
+#endif
+
+#ifndef CYTHON_RING_ATOMICS
+  #define CYTHON_RING_ATOMICS 1
+#endif
+
+#if CYTHON_RING_ATOMICS && defined(__GNUC__) && \
+        (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 7))
+  #define __Pyx_Ring_LoadAcquire(ptr) __atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+  #define __Pyx_Ring_LoadRelaxed(ptr) __atomic_load_n(ptr, __ATOMIC_RELAXED)
+  #define __Pyx_Ring_StoreRelease(ptr, value) __atomic_store_n(ptr, value, __ATOMIC_RELEASE)
+  #define __Pyx_Ring_CAS(ptr, expected, desired) \
+      __sync_bool_compare_and_swap(ptr, expected, desired)
+  #define __PYX_RING_LOCKED 0
+#elif CYTHON_RING_ATOMICS && defined(__GNUC__) && \
+        (__GNUC__ == 4 && __GNUC_MINOR__ >= 1)
+  /* x86 and friends: a full barrier is needed for the release semantics */
+  #define __Pyx_Ring_LoadAcquire(ptr) __Pyx_Ring_SyncLoad(ptr)
+  #define __Pyx_Ring_LoadRelaxed(ptr) (*(volatile size_t *) (ptr))
+  #define __Pyx_Ring_StoreRelease(ptr, value) \
+      (__sync_synchronize(), *(volatile size_t *) (ptr) = (value))
+  #define __Pyx_Ring_CAS(ptr, expected, desired) \
+      __sync_bool_compare_and_swap(ptr, expected, desired)
+  #define __PYX_RING_LOCKED 0
+  static CYTHON_INLINE size_t __Pyx_Ring_SyncLoad(size_t *ptr) {
+      size_t value = *(volatile size_t *) ptr;
+      __sync_synchronize();
+      return value;
+  }
+#elif CYTHON_RING_ATOMICS && defined(_MSC_VER)
+  /* volatile accesses have acquire/release semantics in MSVC */
+  #define __Pyx_Ring_LoadAcquire(ptr) (*(volatile size_t *) (ptr))
+  #define __Pyx_Ring_LoadRelaxed(ptr) (*(volatile size_t *) (ptr))
+  #define __Pyx_Ring_StoreRelease(ptr, value) (*(volatile size_t *) (ptr) = (value))
+  #if defined(_WIN64)
+    #define __Pyx_Ring_CAS(ptr, expected, desired) \
+        (InterlockedCompareExchange64((volatile LONGLONG *) (ptr), (LONGLONG) (desired), (LONGLONG) (expected)) == (LONGLONG) (expected))
+  #else
+    #define __Pyx_Ring_CAS(ptr, expected, desired) \
+        (InterlockedCompareExchange((volatile LONG *) (ptr), (LONG) (desired), (LONG) (expected)) == (LONG) (expected))
+  #endif
+  #define __PYX_RING_LOCKED 0
+#else
+  /* all accesses happen with the lock of the ring buffer held */
+  #define __Pyx_Ring_LoadAcquire(ptr) (*(ptr))
+  #define __Pyx_Ring_LoadRelaxed(ptr) (*(ptr))
+  #define __Pyx_Ring_StoreRelease(ptr, value) (*(ptr) = (value))
+  #define __Pyx_Ring_CAS(ptr, expected, desired) \
+      (*(ptr) == (expected) ? (*(ptr) = (desired), 1) : 0)
+  #define __PYX_RING_LOCKED 1
+#endif
+
+#if __PYX_RING_LOCKED
+  #define __Pyx_Ring_Lock(ring) PyThread_acquire_lock((ring)->lock, WAIT_LOCK)
+  #define __Pyx_Ring_Unlock(ring) PyThread_release_lock((ring)->lock)
+#else
+  #define __Pyx_Ring_Lock(ring)
+  #define __Pyx_Ring_Unlock(ring)
+#endif
+
+#if defined(_WIN32)
+  #define __Pyx_Ring_Yield() SwitchToThread()
+#else
+  #define __Pyx_Ring_Yield() sched_yield()
+#endif
+
+/* keep the positions of the producers and consumers on separate cache lines */
+#define __PYX_RING_PAD(name) char name[64 - sizeof(size_t)]
+
+typedef struct {
+    size_t mask;
+    size_t itemsize;
+    char *data;
+    PyThread_type_lock lock;
+    int closed;
+    __PYX_RING_PAD(pad0);
+    size_t head;
+    __PYX_RING_PAD(pad1);
+    size_t tail;
+    __PYX_RING_PAD(pad2);
+} __Pyx_SPSCRing;
+
+typedef struct {
+    size_t mask;
+    size_t itemsize;
+    char *data;
+    size_t *sequence;
+    PyThread_type_lock lock;
+    int closed;
+    __PYX_RING_PAD(pad0);
+    size_t head;
+    __PYX_RING_PAD(pad1);
+    size_t tail;
+    __PYX_RING_PAD(pad2);
+} __Pyx_MPMCRing;
+
+CYTHON_UNUSED static __Pyx_SPSCRing *__Pyx_SPSCRing_New(size_t capacity, size_t itemsize); /*proto*/
+CYTHON_UNUSED static void __Pyx_SPSCRing_Free(__Pyx_SPSCRing *ring); /*proto*/
+CYTHON_UNUSED static int __Pyx_SPSCRing_Push(__Pyx_SPSCRing *ring, const void *item); /*proto*/
+CYTHON_UNUSED static int __Pyx_SPSCRing_Pop(__Pyx_SPSCRing *ring, void *item); /*proto*/
+CYTHON_UNUSED static int __Pyx_SPSCRing_PushWait(__Pyx_SPSCRing *ring, const void *item); /*proto*/
+CYTHON_UNUSED static int __Pyx_SPSCRing_PopWait(__Pyx_SPSCRing *ring, void *item); /*proto*/
+CYTHON_UNUSED static size_t __Pyx_SPSCRing_Size(__Pyx_SPSCRing *ring); /*proto*/
+
+CYTHON_UNUSED static __Pyx_MPMCRing *__Pyx_MPMCRing_New(size_t capacity, size_t itemsize); /*proto*/
+CYTHON_UNUSED static void __Pyx_MPMCRing_Free(__Pyx_MPMCRing *ring); /*proto*/
+CYTHON_UNUSED static int __Pyx_MPMCRing_Push(__Pyx_MPMCRing *ring, const void *item); /*proto*/
+CYTHON_UNUSED static int __Pyx_MPMCRing_Pop(__Pyx_MPMCRing *ring, void *item); /*proto*/
+CYTHON_UNUSED static int __Pyx_MPMCRing_PushWait(__Pyx_MPMCRing *ring, const void *item); /*proto*/
+CYTHON_UNUSED static int __Pyx_MPMCRing_PopWait(__Pyx_MPMCRing *ring, void *item); /*proto*/
+CYTHON_UNUSED static size_t __Pyx_MPMCRing_Size(__Pyx_MPMCRing *ring); /*proto*/
+
+/* After closing, pushing fails and popping fails once the ring is empty */
+static CYTHON_INLINE void __Pyx_Ring_CloseFlag(int *closed); /*proto*/
+#define __Pyx_SPSCRing_Close(ring) __Pyx_Ring_CloseFlag(&(ring)->closed)
+#define __Pyx_MPMCRing_Close(ring) __Pyx_Ring_CloseFlag(&(ring)->closed)
+#define __Pyx_SPSCRing_Closed(ring) (*(volatile int *) &(ring)->closed)
+#define __Pyx_MPMCRing_Closed(ring) (*(volatile int *) &(ring)->closed)
+#define __Pyx_SPSCRing_Capacity(ring) ((ring)->mask + 1)
+#define __Pyx_MPMCRing_Capacity(ring) ((ring)->mask + 1)
+
+/////////////// RingBuffer ///////////////
+
+static CYTHON_INLINE void __Pyx_Ring_CloseFlag(int *closed) {
+#if !__PYX_RING_LOCKED && defined(__GNUC__)
+    __sync_synchronize();
+#endif
+    *(volatile int *) closed = 1;
+}
+
+static size_t __Pyx_Ring_Capacity(size_t capacity) {
+    size_t result = 1;
+    while (result < capacity) {
+        if (result > ((size_t) -1) / 2)
+            return 0;
+        result *= 2;
+    }
+    return result;
+}
+
+static void *__Pyx_Ring_Alloc(size_t size, size_t capacity, size_t itemsize, char **data) {
+    char *ring;
+    capacity = __Pyx_Ring_Capacity(capacity);
+    if (!capacity || !itemsize || capacity > ((size_t) -1) / itemsize)
+        return NULL;
+    ring = (char *) calloc(1, size);
+    if (!ring)
+        return NULL;
+    *data = (char *) malloc(capacity * itemsize);
+    if (!*data) {
+        free(ring);
+        return NULL;
+    }
+    return ring;
+}
+
+static __Pyx_SPSCRing *__Pyx_SPSCRing_New(size_t capacity, size_t itemsize) {
+    char *data;
+    __Pyx_SPSCRing *ring = (__Pyx_SPSCRing *) __Pyx_Ring_Alloc(
+        sizeof(__Pyx_SPSCRing), capacity, itemsize, &data);
+    if (!ring)
+        return NULL;
+    ring->mask = __Pyx_Ring_Capacity(capacity) - 1;
+    ring->itemsize = itemsize;
+    ring->data = data;
+#if __PYX_RING_LOCKED
+    ring->lock = PyThread_allocate_lock();
+    if (!ring->lock) {
+        __Pyx_SPSCRing_Free(ring);
+        return NULL;
+    }
+#endif
+    return ring;
+}
+
+static void __Pyx_SPSCRing_Free(__Pyx_SPSCRing *ring) {
+    if (!ring)
+        return;
+    if (ring->lock)
+        PyThread_free_lock(ring->lock);
+    free(ring->data);
+    free(ring);
+}
+
+static int __Pyx_SPSCRing_Push(__Pyx_SPSCRing *ring, const void *item) {
+    /* the producer owns the tail, the consumer the head */
+    size_t tail, head;
+    __Pyx_Ring_Lock(ring);
+    tail = ring->tail;
+    head = __Pyx_Ring_LoadAcquire(&ring->head);
+    if (tail - head > ring->mask) {
+        __Pyx_Ring_Unlock(ring);
+        return 0;
+    }
+    memcpy(ring->data + (tail & ring->mask) * ring->itemsize, item, ring->itemsize);
+    __Pyx_Ring_StoreRelease(&ring->tail, tail + 1);
+    __Pyx_Ring_Unlock(ring);
+    return 1;
+}
+
+static int __Pyx_SPSCRing_Pop(__Pyx_SPSCRing *ring, void *item) {
+    size_t tail, head;
+    __Pyx_Ring_Lock(ring);
+    head = ring->head;
+    tail = __Pyx_Ring_LoadAcquire(&ring->tail);
+    if (head == tail) {
+        __Pyx_Ring_Unlock(ring);
+        return 0;
+    }
+    memcpy(item, ring->data + (head & ring->mask) * ring->itemsize, ring->itemsize);
+    __Pyx_Ring_StoreRelease(&ring->head, head + 1);
+    __Pyx_Ring_Unlock(ring);
+    return 1;
+}
+
+static size_t __Pyx_SPSCRing_Size(__Pyx_SPSCRing *ring) {
+    size_t head = __Pyx_Ring_LoadAcquire(&ring->head);
+    return __Pyx_Ring_LoadAcquire(&ring->tail) - head;
+}
+
+static __Pyx_MPMCRing *__Pyx_MPMCRing_New(size_t capacity, size_t itemsize) {
+    char *data;
+    size_t i;
+    __Pyx_MPMCRing *ring = (__Pyx_MPMCRing *) __Pyx_Ring_Alloc(
+        sizeof(__Pyx_MPMCRing), capacity, itemsize, &data);
+    if (!ring)
+        return NULL;
+    ring->mask = __Pyx_Ring_Capacity(capacity) - 1;
+    ring->itemsize = itemsize;
+    ring->data = data;
+    ring->sequence = (size_t *) malloc((ring->mask + 1) * sizeof(size_t));
+    if (!ring->sequence) {
+        __Pyx_MPMCRing_Free(ring);
+        return NULL;
+    }
+    for (i = 0; i <= ring->mask; i++)
+        ring->sequence[i] = i;
+#if __PYX_RING_LOCKED
+    ring->lock = PyThread_allocate_lock();
+    if (!ring->lock) {
+        __Pyx_MPMCRing_Free(ring);
+        return NULL;
+    }
+#endif
+    return ring;
+}
+
+static void __Pyx_MPMCRing_Free(__Pyx_MPMCRing *ring) {
+    if (!ring)
+        return;
+    if (ring->lock)
+        PyThread_free_lock(ring->lock);
+    free(ring->sequence);
+    free(ring->data);
+    free(ring);
+}
+
+static int __Pyx_MPMCRing_Push(__Pyx_MPMCRing *ring, const void *item) {
+    /* A slot is free for position pos if its sequence number equals pos,
+       it holds an item for position pos if its sequence number is pos + 1 */
+    size_t pos, seq;
+    Py_ssize_t diff;
+    __Pyx_Ring_Lock(ring);
+    pos = __Pyx_Ring_LoadRelaxed(&ring->tail);
+    for (;;) {
+        seq = __Pyx_Ring_LoadAcquire(&ring->sequence[pos & ring->mask]);
+        diff = (Py_ssize_t) seq - (Py_ssize_t) pos;
+        if (diff == 0) {
+            if (__Pyx_Ring_CAS(&ring->tail, pos, pos + 1))
+                break;
+            pos = __Pyx_Ring_LoadRelaxed(&ring->tail);
+        } else if (diff < 0) {
+            __Pyx_Ring_Unlock(ring);
+            return 0;
+        } else {
+            pos = __Pyx_Ring_LoadRelaxed(&ring->tail);
+        }
+    }
+    memcpy(ring->data + (pos & ring->mask) * ring->itemsize, item, ring->itemsize);
+    __Pyx_Ring_StoreRelease(&ring->sequence[pos & ring->mask], pos + 1);
+    __Pyx_Ring_Unlock(ring);
+    return 1;
+}
+
+static int __Pyx_MPMCRing_Pop(__Pyx_MPMCRing *ring, void *item) {
+    size_t pos, seq;
+    Py_ssize_t diff;
+    __Pyx_Ring_Lock(ring);
+    pos = __Pyx_Ring_LoadRelaxed(&ring->head);
+    for (;;) {
+        seq = __Pyx_Ring_LoadAcquire(&ring->sequence[pos & ring->mask]);
+        diff = (Py_ssize_t) seq - (Py_ssize_t) (pos + 1);
+        if (diff == 0) {
+            if (__Pyx_Ring_CAS(&ring->head, pos, pos + 1))
+                break;
+            pos = __Pyx_Ring_LoadRelaxed(&ring->head);
+        } else if (diff < 0) {
+            __Pyx_Ring_Unlock(ring);
+            return 0;
+        } else {
+            pos = __Pyx_Ring_LoadRelaxed(&ring->head);
+        }
+    }
+    memcpy(item, ring->data + (pos & ring->mask) * ring->itemsize, ring->itemsize);
+    __Pyx_Ring_StoreRelease(&ring->sequence[pos & ring->mask], pos + ring->mask + 1);
+    __Pyx_Ring_Unlock(ring);
+    return 1;
+}
+
+static size_t __Pyx_MPMCRing_Size(__Pyx_MPMCRing *ring) {
+    size_t head = __Pyx_Ring_LoadAcquire(&ring->head);
+    size_t tail = __Pyx_Ring_LoadAcquire(&ring->tail);
+    return tail > head ? tail - head : 0;
+}
+
+/* The waiting variants spin until an item could be pushed or popped. Popping
+   fails once the ring buffer is closed and empty, pushing once it is closed */
+
+static int __Pyx_SPSCRing_PushWait(__Pyx_SPSCRing *ring, const void *item) {
+    while (!__Pyx_SPSCRing_Push(ring, item)) {
+        if (__Pyx_SPSCRing_Closed(ring))
+            return 0;
+        __Pyx_Ring_Yield();
+    }
+    return 1;
+}
+
+static int __Pyx_SPSCRing_PopWait(__Pyx_SPSCRing *ring, void *item) {
+    while (!__Pyx_SPSCRing_Pop(ring, item)) {
+        if (__Pyx_SPSCRing_Closed(ring))
+            return __Pyx_SPSCRing_Pop(ring, item);
+        __Pyx_Ring_Yield();
+    }
+    return 1;
+}
+
+static int __Pyx_MPMCRing_PushWait(__Pyx_MPMCRing *ring, const void *item) {
+    while (!__Pyx_MPMCRing_Push(ring, item)) {
+        if (__Pyx_MPMCRing_Closed(ring))
+            return 0;
+        __Pyx_Ring_Yield();
+    }
+    return 1;
+}
+
+static int __Pyx_MPMCRing_PopWait(__Pyx_MPMCRing *ring, void *item) {
+    while (!__Pyx_MPMCRing_Pop(ring, item)) {
+        if (__Pyx_MPMCRing_Closed(ring))
+            return __Pyx_MPMCRing_Pop(ring, item);
+        __Pyx_Ring_Yield();
+    }
+    return 1;
+}
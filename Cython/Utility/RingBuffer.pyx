@@ -0,0 +1,37 @@
+########## RingBuffer ##########
+# The declarations of cython.ringbuffer, bounded lock-free ring buffers of
+# fixed size items that are implemented in Parallel.c.  spsc_ring may be used
+# by a single producer and a single consumer thread, mpmc_ring by any number
+# of producers and consumers.  The capacity is rounded up to a power of two.
+# push() and pop() return 0 if the ring buffer is full or empty, push_wait()
+# and pop_wait() spin until they succeed, or return 0 once the ring buffer
+# was closed (and, for pop_wait(), is empty).
+
+cdef extern from *:
+    ctypedef struct spsc_ring "__Pyx_SPSCRing":
+        pass
+
+    spsc_ring *spsc_ring_new "__Pyx_SPSCRing_New"(size_t capacity, size_t itemsize) nogil
+    void spsc_ring_free "__Pyx_SPSCRing_Free"(spsc_ring *ring) nogil
+    bint spsc_ring_push "__Pyx_SPSCRing_Push"(spsc_ring *ring, void *item) nogil
+    bint spsc_ring_pop "__Pyx_SPSCRing_Pop"(spsc_ring *ring, void *item) nogil
+    bint spsc_ring_push_wait "__Pyx_SPSCRing_PushWait"(spsc_ring *ring, void *item) nogil
+    bint spsc_ring_pop_wait "__Pyx_SPSCRing_PopWait"(spsc_ring *ring, void *item) nogil
+    void spsc_ring_close "__Pyx_SPSCRing_Close"(spsc_ring *ring) nogil
+    bint spsc_ring_closed "__Pyx_SPSCRing_Closed"(spsc_ring *ring) nogil
+    size_t spsc_ring_size "__Pyx_SPSCRing_Size"(spsc_ring *ring) nogil
+    size_t spsc_ring_capacity "__Pyx_SPSCRing_Capacity"(spsc_ring *ring) nogil
+
+    ctypedef struct mpmc_ring "__Pyx_MPMCRing":
+        pass
+
+    mpmc_ring *mpmc_ring_new "__Pyx_MPMCRing_New"(size_t capacity, size_t itemsize) nogil
+    void mpmc_ring_free "__Pyx_MPMCRing_Free"(mpmc_ring *ring) nogil
+    bint mpmc_ring_push "__Pyx_MPMCRing_Push"(mpmc_ring *ring, void *item) nogil
+    bint mpmc_ring_pop "__Pyx_MPMCRing_Pop"(mpmc_ring *ring, void *item) nogil
+    bint mpmc_ring_push_wait "__Pyx_MPMCRing_PushWait"(mpmc_ring *ring, void *item) nogil
+    bint mpmc_ring_pop_wait "__Pyx_MPMCRing_PopWait"(mpmc_ring *ring, void *item) nogil
+    void mpmc_ring_close "__Pyx_MPMCRing_Close"(mpmc_ring *ring) nogil
+    bint mpmc_ring_closed "__Pyx_MPMCRing_Closed"(mpmc_ring *ring) nogil
+    size_t mpmc_ring_size "__Pyx_MPMCRing_Size"(mpmc_ring *ring) nogil
+    size_t mpmc_ring_capacity "__Pyx_MPMCRing_Capacity"(mpmc_ring *ring) nogil
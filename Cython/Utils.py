@@ -46,6 +46,28 @@ def open_new_file(path):
     # characters to a byte sequence, which ISO-8859-1 provides
     return codecs.open(path, "w", encoding="ISO-8859-1")
 
+def write_file_atomically(path, write, open_file=open):
+    """
+    Write the file at path by calling write() with a temporary file next
+    to it, which is then renamed to path, so that concurrent readers never
+    see a partially written file.  The temporary file is removed if
+    writing fails.
+    """
+    tmp_path = '%s.%d.tmp' % (path, os.getpid())
+    try:
+        f = open_file(tmp_path, 'wb')
+        try:
+            write(f)
+        finally:
+            f.close()
+        if sys.platform == 'win32' and os.path.exists(path):
+            os.remove(path)
+        os.rename(tmp_path, path)
+    except:
+        if os.path.exists(tmp_path):
+            os.remove(tmp_path)
+        raise
+
 def castrate_file(path, st):
     #  Remove junk contents from an output file after a
     #  failed compilation.
@@ -0,0 +1,113 @@
+"""
+Measures the overhead of calling small def functions from Cython code,
+within one module and across modules.  The functions are compiled as
+CyFunctions (binding=True), which take their arguments as a C array
+(see __Pyx_PyObject_VectorCall()), and as plain builtin functions
+(binding=False), which always receive an argument tuple and keyword dict.
+
+Usage::
+
+    $ python call_timing.py [number of calls]
+"""
+
+import os
+import sys
+import time
+import shutil
+import tempfile
+
+from distutils.core import setup
+from Cython.Build import cythonize
+
+callee_template = '''\
+# cython: binding=%(binding)s
+
+def f2(a, b):
+    return a
+
+def f4(a, b, c=None, d=None):
+    return a
+
+def typed(int a, double b):
+    return a
+'''
+
+caller_template = '''\
+# cython: binding=%(binding)s
+
+from %(callee)s import f2 as callee_f2, typed as callee_typed
+
+def f2(a, b):
+    return a
+
+def f4(a, b, c=None, d=None):
+    return a
+
+def local_positional(Py_ssize_t n):
+    for i in range(n):
+        f2(i, i)
+
+def local_defaults(Py_ssize_t n):
+    for i in range(n):
+        f4(i, i)
+
+def local_keywords(Py_ssize_t n):
+    for i in range(n):
+        f4(i, i, d=i)
+
+def imported_positional(Py_ssize_t n):
+    for i in range(n):
+        callee_f2(i, i)
+
+def imported_typed(Py_ssize_t n):
+    for i in range(n):
+        callee_typed(i, 1.0)
+'''
+
+benchmarks = ['local_positional', 'local_defaults', 'local_keywords',
+              'imported_positional', 'imported_typed']
+
+def build(directory, binding):
+    names = {'binding': binding,
+             'callee': 'callee_%s' % binding,
+             'caller': 'caller_%s' % binding}
+    for name, template in [('callee', callee_template), ('caller', caller_template)]:
+        f = open(os.path.join(directory, names[name] + '.pyx'), 'w')
+        try:
+            f.write(template % names)
+        finally:
+            f.close()
+    cwd = os.getcwd()
+    os.chdir(directory)
+    try:
+        setup(ext_modules=cythonize([names['callee'] + '.pyx', names['caller'] + '.pyx'], quiet=True),
+              script_args=['-q', 'build_ext', '--inplace'])
+    finally:
+        os.chdir(cwd)
+    return __import__(names['caller'])
+
+def time_calls(function, count):
+    best = None
+    for _ in range(3):
+        t = time.time()
+        function(count)
+        t = time.time() - t
+        if best is None or t < best:
+            best = t
+    return best * 1e9 / count
+
+def main(count):
+    directory = tempfile.mkdtemp()
+    sys.path.insert(0, directory)
+    try:
+        modules = [build(directory, binding) for binding in (False, True)]
+        print("ns per call (%d calls):     tuple  vectorcall" % count)
+        for name in benchmarks:
+            print("  %-24s %8.1f  %8.1f" % tuple(
+                [name] + [time_calls(getattr(module, name), count) for module in modules]))
+    finally:
+        del sys.path[0]
+        shutil.rmtree(directory)
+
+if __name__ == '__main__':
+    main(len(sys.argv) > 1 and int(sys.argv[1]) or 1000000)
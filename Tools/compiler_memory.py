@@ -0,0 +1,75 @@
+"""
+Measures the peak memory use of the compiler for each of the given
+modules (by default the ExprNodes module of the compiler itself), and
+how many of these compilations fit into a memory budget when they run
+in parallel, e.g. with 'cythonize -j'.
+
+Every module is compiled in a new process, so that its peak resident
+set size is not influenced by the other modules.
+
+Usage::
+
+    $ python compiler_memory.py [--budget=MB] [source files]
+"""
+
+import os
+import sys
+import shutil
+import tempfile
+import resource
+import subprocess
+
+def peak_memory_mb():
+    peak = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+    if sys.platform == 'darwin':
+        peak //= 1024   # bytes
+    return peak / 1024.0
+
+def compile_module(source, directory):
+    # runs in the child process
+    from Cython.Compiler import Main
+    target = os.path.join(directory, os.path.basename(source))
+    shutil.copy(source, target)
+    options = Main.CompilationOptions(Main.default_options)
+    options.output_file = os.path.splitext(target)[0] + '.c'
+    result = Main.compile(target, options)
+    if result.num_errors:
+        raise RuntimeError("compiling %s failed" % source)
+    print(peak_memory_mb())
+
+def measure(source, directory):
+    import Cython
+    env = dict(os.environ)
+    cython_dir = os.path.dirname(os.path.dirname(os.path.abspath(Cython.__file__)))
+    env['PYTHONPATH'] = os.pathsep.join(
+        [cython_dir] + [p for p in [env.get('PYTHONPATH')] if p])
+    output = subprocess.Popen(
+        [sys.executable, __file__, '--child', source, directory],
+        stdout=subprocess.PIPE, env=env).communicate()[0]
+    return float(output.split()[-1])
+
+def main(sources, budget):
+    directory = tempfile.mkdtemp()
+    try:
+        peaks = []
+        for source in sources:
+            peak = measure(source, directory)
+            peaks.append(peak)
+            print("%-40s peak %8.1f MB" % (os.path.basename(source), peak))
+    finally:
+        shutil.rmtree(directory)
+    if budget:
+        print("parallel jobs within %d MB: %d" % (budget, int(budget // max(peaks))))
+
+if __name__ == '__main__':
+    args = sys.argv[1:]
+    if args[:1] == ['--child']:
+        compile_module(args[1], args[2])
+        sys.exit(0)
+    budget = None
+    if args and args[0].startswith('--budget='):
+        budget = int(args.pop(0).split('=', 1)[1])
+    if not args:
+        from Cython.Compiler import Main
+        args = [os.path.join(os.path.dirname(os.path.abspath(Main.__file__)), 'ExprNodes.py')]
+    main(args, budget)
@@ -0,0 +1,67 @@
+"""
+Measures the end-to-end time of cythonize() for a set of generated
+modules that cimport the larger .pxd files shipped with Cython, without
+and with a cache of parsed .pxd files (see the 'pxd_cache' option).
+
+Usage::
+
+    $ python cythonize_timing.py [number of modules]
+"""
+
+import os
+import sys
+import time
+import shutil
+import tempfile
+
+from Cython.Build import cythonize
+
+module_template = '''\
+cimport numpy as np
+from cpython cimport *
+from libc.stdlib cimport malloc, free
+from libc.math cimport sqrt
+from libcpp.vector cimport vector
+from libcpp.map cimport map
+
+def f%(index)d(np.ndarray[double] a):
+    cdef vector[double] v
+    cdef double s = 0
+    cdef Py_ssize_t i
+    for i in range(a.shape[0]):
+        v.push_back(sqrt(a[i]))
+        s += v.back()
+    return s
+'''
+
+def create_modules(directory, count):
+    modules = []
+    for index in range(count):
+        path = os.path.join(directory, 'timing_module_%d.pyx' % index)
+        f = open(path, 'w')
+        try:
+            f.write(module_template % {'index': index})
+        finally:
+            f.close()
+        modules.append(path)
+    return modules
+
+def time_cythonize(modules, **options):
+    t = time.time()
+    cythonize(modules, language='c++', force=True, quiet=True, **options)
+    return time.time() - t
+
+def main(count):
+    directory = tempfile.mkdtemp()
+    try:
+        modules = create_modules(directory, count)
+        cache = os.path.join(directory, 'pxd_cache')
+        print("cythonize() of %d modules:" % count)
+        print("  without pxd cache:  %6.2f s" % time_cythonize(modules))
+        print("  cold pxd cache:     %6.2f s" % time_cythonize(modules, pxd_cache=cache))
+        print("  warm pxd cache:     %6.2f s" % time_cythonize(modules, pxd_cache=cache))
+    finally:
+        shutil.rmtree(directory)
+
+if __name__ == '__main__':
+    main(len(sys.argv) > 1 and int(sys.argv[1]) or 20)
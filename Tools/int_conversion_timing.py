@@ -0,0 +1,109 @@
+"""
+Measures the conversion of Python ints to C integers and back, as done
+for typed arguments and return values of def functions.  Small values
+fit into one or two digits of a PyLong object and take the inlined fast
+paths of __Pyx_PyInt_As*() and __Pyx_PyIndex_AsSsize_t(), values in
+range(-5, 257) are returned from the small int cache.
+
+Usage::
+
+    $ python int_conversion_timing.py [number of conversions]
+"""
+
+import os
+import sys
+import time
+import shutil
+import tempfile
+
+from distutils.core import setup
+from Cython.Build import cythonize
+
+module_code = '''\
+def unbox_long(values, Py_ssize_t n):
+    cdef long x
+    cdef Py_ssize_t i
+    for i in range(n):
+        for value in values:
+            x = value
+
+def unbox_ulong(values, Py_ssize_t n):
+    cdef unsigned long x
+    cdef Py_ssize_t i
+    for i in range(n):
+        for value in values:
+            x = value
+
+def unbox_ssize_t(values, Py_ssize_t n):
+    cdef Py_ssize_t x
+    cdef Py_ssize_t i
+    for i in range(n):
+        for value in values:
+            x = value
+
+def box_long(values, Py_ssize_t n):
+    cdef long x = values[0]
+    cdef Py_ssize_t i
+    for i in range(n):
+        for value in values:
+            value = x
+
+def box_ssize_t(values, Py_ssize_t n):
+    cdef Py_ssize_t x = values[0]
+    cdef Py_ssize_t i
+    for i in range(n):
+        for value in values:
+            value = x
+'''
+
+benchmarks = ['unbox_long', 'unbox_ulong', 'unbox_ssize_t', 'box_long', 'box_ssize_t']
+
+# 10 values of each size
+value_sets = [
+    ('small', [3] * 10),
+    ('1 digit', [2 ** 20 + 1] * 10),
+    ('2 digits', [2 ** 40 + 1] * 10),
+    ]
+
+def build(directory):
+    f = open(os.path.join(directory, 'int_conversions.pyx'), 'w')
+    try:
+        f.write(module_code)
+    finally:
+        f.close()
+    cwd = os.getcwd()
+    os.chdir(directory)
+    try:
+        setup(ext_modules=cythonize(['int_conversions.pyx'], quiet=True),
+              script_args=['-q', 'build_ext', '--inplace'])
+    finally:
+        os.chdir(cwd)
+    return __import__('int_conversions')
+
+def time_conversions(function, values, count):
+    best = None
+    for _ in range(3):
+        t = time.time()
+        function(values, count // len(values))
+        t = time.time() - t
+        if best is None or t < best:
+            best = t
+    return best * 1e9 / count
+
+def main(count):
+    directory = tempfile.mkdtemp()
+    sys.path.insert(0, directory)
+    try:
+        module = build(directory)
+        print("ns per conversion (%d conversions): %s" % (
+            count, '  '.join(['%9s' % name for name, _ in value_sets])))
+        for name in benchmarks:
+            print("  %-36s %s" % (name, '  '.join([
+                '%9.1f' % time_conversions(getattr(module, name), values, count)
+                for _, values in value_sets])))
+    finally:
+        del sys.path[0]
+        shutil.rmtree(directory)
+
+if __name__ == '__main__':
+    main(len(sys.argv) > 1 and int(sys.argv[1]) or 10000000)
@@ -0,0 +1,71 @@
+"""
+Measures the time that the lexer of the compiler takes to build its
+state tables and to scan and parse the Python sources of the compiler
+itself (or the given files).  Scanning alone is only measured when the
+scanner is not compiled, the compiled scanner does not expose its
+next() method to Python code.
+
+Usage::
+
+    $ python lexer_timing.py [source files]
+"""
+
+import os
+import sys
+import time
+import glob
+
+from Cython.Compiler import Scanning, Parsing
+from Cython.Compiler.Main import Context
+from Cython.Compiler.Scanning import PyrexScanner, FileSourceDescriptor
+from Cython.Utils import open_source_file
+
+class Scope(object):
+    included_files = []
+
+def run(paths, process):
+    result = 0
+    for path in paths:
+        # (the directives of a module can change its language level)
+        context = Context(['.'], {}, language_level=2)
+        f = open_source_file(path)
+        try:
+            scanner = PyrexScanner(f, FileSourceDescriptor(path),
+                                   source_encoding=f.encoding,
+                                   scope=Scope(), context=context)
+            result += process(scanner)
+        finally:
+            f.close()
+    return result
+
+def scan(scanner):
+    tokens = 0
+    while scanner.sy != 'EOF':
+        scanner.next()
+        tokens += 1
+    return tokens
+
+def parse(scanner):
+    Parsing.p_module(scanner, 0, 'timing')
+    return 1
+
+def main(paths):
+    if not paths:
+        compiler_dir = os.path.dirname(os.path.abspath(Scanning.__file__))
+        paths = sorted(glob.glob(os.path.join(compiler_dir, '*.py')))
+    compiled = os.path.splitext(Scanning.__file__)[1] not in ('.py', '.pyc', '.pyo')
+    print("Lexer (%s):" % (compiled and 'compiled' or 'Python'))
+    t = time.time()
+    Scanning.get_lexicon()
+    print("  building the lexicon: %6.3f s" % (time.time() - t))
+    if not compiled:
+        t = time.time()
+        tokens = run(paths, scan)
+        print("  scanning %d files:   %6.3f s (%d tokens)" % (
+            len(paths), time.time() - t, tokens))
+    t = time.time()
+    run(paths, parse)
+    print("  parsing %d files:    %6.3f s" % (len(paths), time.time() - t))
+
+if __name__ == '__main__':
+    main(sys.argv[1:])
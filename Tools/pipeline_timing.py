@@ -0,0 +1,46 @@
+"""
+Measures the time that the compiler takes to compile a large module,
+by default the ExprNodes module of the compiler itself.
+
+Usage::
+
+    $ python pipeline_timing.py [source file] [repetitions]
+"""
+
+import os
+import sys
+import time
+import shutil
+import tempfile
+
+from Cython.Compiler import Main, Visitor
+
+def compile_module(source, directory):
+    target = os.path.join(directory, os.path.basename(source))
+    shutil.copy(source, target)
+    options = Main.CompilationOptions(Main.default_options)
+    options.output_file = os.path.splitext(target)[0] + '.c'
+    t = time.time()
+    result = Main.compile(target, options)
+    elapsed = time.time() - t
+    if result.num_errors:
+        raise RuntimeError("compiling %s failed" % source)
+    return elapsed
+
+def main(source, repetitions):
+    compiled = os.path.splitext(Visitor.__file__)[1] not in ('.py', '.pyc', '.pyo')
+    print("Compiling %s (%s compiler):" % (
+        os.path.basename(source), compiled and 'compiled' or 'Python'))
+    directory = tempfile.mkdtemp()
+    try:
+        times = [compile_module(source, directory) for _ in range(repetitions)]
+    finally:
+        shutil.rmtree(directory)
+    print("  best of %d: %6.2f s" % (repetitions, min(times)))
+
+if __name__ == '__main__':
+    if len(sys.argv) > 1:
+        source = sys.argv[1]
+    else:
+        source = os.path.join(os.path.dirname(os.path.abspath(Main.__file__)), 'ExprNodes.py')
+    main(source, len(sys.argv) > 2 and int(sys.argv[2]) or 3)
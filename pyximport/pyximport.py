@@ -129,6 +129,23 @@ def handle_special_build(modname, pyxfilename):
                        for source in ext.sources]
     return ext, setup_args
 
+def cython_dependencies(pyxfilename):
+    # the cimported .pxd files and the included files, found by the same
+    # dependency scan as cythonize() uses, sharing its index file
+    try:
+        from Cython.Build import Dependencies
+        deps = Dependencies.create_dependency_tree(quiet=True)
+        if deps.index is None:
+            deps.index = Dependencies.DependencyIndex(
+                Dependencies.default_dependency_index())
+        files = deps.all_dependencies(pyxfilename)
+        deps.index.save()
+    except EnvironmentError:
+        _debug("Could not scan the dependencies of %s: %s",
+               pyxfilename, sys.exc_info()[1])
+        return []
+    return [file for file in files if file != pyxfilename]
+
 def handle_dependencies(pyxfilename):
     testing = '_test_files' in globals()
     dependfile = os.path.splitext(pyxfilename)[0] + PYXDEP_EXT
@@ -138,13 +155,14 @@ def handle_dependencies(pyxfilename):
 
     # but we know more about dependencies so force a rebuild if 
     # some of the dependencies are newer than the pyxfile.
+    files = cython_dependencies(pyxfilename)
     if os.path.exists(dependfile):
         depends = open(dependfile).readlines()
         depends = [depend.strip() for depend in depends]
 
         # gather dependencies in the "files" variable
         # the dependency file is itself a dependency
-        files = [dependfile]
+        files.append(dependfile)
         for depend in depends:
             fullpath = os.path.join(os.path.dirname(dependfile),
                                     depend) 
@@ -154,17 +172,17 @@ def handle_dependencies(pyxfilename):
         if testing:
             _test_files[:] = []  #$pycheck_no
 
-        # if any file that the pyxfile depends upon is newer than
-        # the pyx file, 'touch' the pyx file so that distutils will
-        # be tricked into rebuilding it.
-        for file in files:
-            from distutils.dep_util import newer
-            if newer(file, pyxfilename):
-                _debug("Rebuilding %s because of %s", pyxfilename, file)
-                filetime = os.path.getmtime(file)
-                os.utime(pyxfilename, (filetime, filetime))
-                if testing:
-                    _test_files.append(file)
+    # if any file that the pyxfile depends upon is newer than
+    # the pyx file, 'touch' the pyx file so that distutils will
+    # be tricked into rebuilding it.
+    for file in files:
+        from distutils.dep_util import newer
+        if newer(file, pyxfilename):
+            _debug("Rebuilding %s because of %s", pyxfilename, file)
+            filetime = os.path.getmtime(file)
+            os.utime(pyxfilename, (filetime, filetime))
+            if testing:
+                _test_files.append(file)
 
 def build_module(name, pyxfilename, pyxbuild_dir=None, inplace=False, language_level=None):
     assert os.path.exists(pyxfilename), (
@@ -41,6 +41,14 @@ if sys.version_info[0] >= 3:
                ]
     build_py.fixer_names = fixers
     add_command_class("build_py", build_py)
+else:
+    from distutils.command.build_py import build_py as build_py_orig
+    class build_py(build_py_orig):
+        def run(self):
+            build_py_orig.run(self)
+            if not self.dry_run:
+                build_utility_bundle(self.build_lib)
+    add_command_class("build_py", build_py)
 
 pxd_include_dirs = [
     directory for directory, dirs, files in os.walk('Cython/Includes')
@@ -231,6 +239,19 @@ Cython without compiling its own sources.
 ''' % sys.exc_info()[1])
             raise
 
+def build_utility_bundle(build_lib):
+    # Pre-process the utility code files once at build time, into the
+    # build directory only.  The Py3 sources are converted by 2to3
+    # during the build, so the bundle would not match them.
+    utility_dir = os.path.join(build_lib, 'Cython', 'Utility')
+    try:
+        from Cython.Compiler import UtilityBundle
+        UtilityBundle.write_bundle(
+            os.path.join(utility_dir, UtilityBundle.bundle_name), utility_dir,
+            installed=True)
+    except Exception:
+        print("WARNING: Failed to write the utility code bundle: %s" % sys.exc_info()[1])
+
 cython_profile = '--cython-profile' in sys.argv
 if cython_profile:
     sys.argv.remove('--cython-profile')
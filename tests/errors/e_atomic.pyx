@@ -0,0 +1,26 @@
+# mode: error
+
+from cython cimport atomic
+
+cdef atomic.double d = 0
+cdef atomic.ptr p = NULL
+cdef double *dp = &d
+cdef long double ld = 0
+
+d *= 2
+d |= 1
+atomic.fetch_or(dp, 1)
+atomic.fetch_add(&p, 1)
+atomic.load(d)
+atomic.load()
+atomic.store(&ld, 1)
+
+_ERRORS = u"""
+10:2: In-place operator '*=' not supported for atomic type 'atomic.double'
+11:2: Atomic fetch_or() is only supported for integers
+12:18: Atomic fetch_or() is only supported for integers
+13:17: Atomic fetch_add() is not supported for pointers
+14:13: atomic.load() requires a pointer to the value, got 'atomic.double'
+15:11: atomic.load() takes 1 or 2 arguments (0 given)
+16:13: Atomic operations are not supported for type 'long double'
+"""
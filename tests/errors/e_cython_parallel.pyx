@@ -149,6 +149,13 @@ with nogil, cython.parallel.parallel():
     with cython.parallel.parallel():
         pass
 
+for i in prange(10, nogil=True, schedule='adaptive', chunksize=10):
+    pass
+
+with nogil, cython.parallel.parallel():
+    for i in prange(10, schedule='adaptive'):
+        pass
+
 _ERRORS = u"""
 e_cython_parallel.pyx:3:8: cython.parallel.parallel is not a module
 e_cython_parallel.pyx:4:0: No such directive: cython.parallel.something
@@ -183,4 +190,6 @@ e_cython_parallel.pyx:136:62: Chunksize must not be negative
 e_cython_parallel.pyx:139:62: Chunksize not valid for the schedule runtime
 e_cython_parallel.pyx:145:70: Calling gil-requiring function not allowed without gil
 e_cython_parallel.pyx:149:33: Nested parallel with blocks are disallowed
+e_cython_parallel.pyx:152:63: Chunksize not valid for the schedule adaptive
+e_cython_parallel.pyx:156:19: The schedule adaptive is not supported for prange() in a parallel() block
 """
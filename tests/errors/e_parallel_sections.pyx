@@ -0,0 +1,29 @@
+# mode: error
+
+cimport cython.parallel
+from cython.parallel cimport sections, section, prange
+
+cdef int i
+
+with nogil, sections():
+    i = 1
+
+with nogil, cython.parallel.parallel():
+    with section():
+        pass
+
+with nogil, sections():
+    with section():
+        for i in prange(10):
+            pass
+
+with nogil, sections():
+    with section(2):
+        pass
+
+_ERRORS = u"""
+e_parallel_sections.pyx:9:8: Only cython.parallel.section() blocks are allowed in a cython.parallel.sections() block
+e_parallel_sections.pyx:12:16: cython.parallel.section() must be used in a cython.parallel.sections() block
+e_parallel_sections.pyx:17:23: prange() may not be used in a cython.parallel.section()
+e_parallel_sections.pyx:21:16: cython.parallel.section() does not take arguments
+"""
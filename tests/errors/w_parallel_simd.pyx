@@ -0,0 +1,14 @@
+# mode: error
+# tag: werror, openmp
+
+from cython.parallel import simd
+
+def python_body(int n):
+    cdef int i
+    result = []
+    for i in simd(n):
+        result.append(i)
+
+_ERRORS = """
+9:17: simd loop body may interact with Python objects, vectorization hints may be unsafe
+"""
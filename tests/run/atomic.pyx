@@ -0,0 +1,120 @@
+# tag: run
+# tag: openmp
+
+from cython cimport atomic, view
+from cython.parallel cimport prange
+
+cdef atomic.long counter = 0
+
+def test_inplace_in_prange(long n):
+    """
+    >>> test_inplace_in_prange(10000)
+    10000
+    >>> test_inplace_in_prange(10000)
+    20000
+    """
+    global counter
+    cdef long i
+    for i in prange(n, nogil=True):
+        counter += 1
+    return counter
+
+def test_local_inplace_in_prange(long n):
+    """
+    >>> test_local_inplace_in_prange(10000)
+    (10000, -10000, 5000.0)
+    """
+    cdef atomic.llong total = 0
+    cdef atomic.int negative = 0
+    cdef atomic.double half = 0
+    cdef long i
+    for i in prange(n, nogil=True):
+        total += 1
+        negative -= 1
+        half += 0.5
+    return int(total), negative, half
+
+def test_histogram(long n, long nbins):
+    """
+    >>> test_histogram(1000, 3)
+    [334, 333, 333]
+    """
+    cdef long[:] hist = view.array((nbins,), sizeof(long), 'l')
+    cdef long i
+    hist[:] = 0
+    for i in prange(n, nogil=True):
+        atomic.fetch_add(&hist[i % nbins], 1, atomic.relaxed)
+    return list(hist)
+
+def test_load_store():
+    """
+    >>> test_load_store()
+    (5, 7, 2.5)
+    """
+    cdef atomic.int x = 0
+    cdef long plain = 0
+    cdef atomic.float f = 0
+    atomic.store(&x, 5)
+    atomic.store(&plain, 7, atomic.release)
+    atomic.store(&f, 2.5, atomic.seq_cst)
+    return atomic.load(&x), atomic.load(&plain, atomic.acquire), atomic.load(&f)
+
+def test_fetch_ops():
+    """
+    >>> test_fetch_ops()
+    [12, 15, 5, 4, 7, 6]
+    """
+    cdef atomic.int x = 12
+    cdef list results = []
+    results.append(atomic.fetch_add(&x, 3))
+    results.append(atomic.fetch_sub(&x, 10))
+    results.append(atomic.fetch_and(&x, 4))
+    results.append(atomic.fetch_or(&x, 3))
+    results.append(atomic.fetch_xor(&x, 1, atomic.acq_rel))
+    results.append(x)
+    return results
+
+def test_exchange():
+    """
+    >>> test_exchange()
+    (1.5, 2.5)
+    """
+    cdef atomic.double d = 1.5
+    old = atomic.exchange(&d, 2.5)
+    return old, d
+
+def test_compare_exchange():
+    """
+    >>> test_compare_exchange()
+    (False, 3, True, 7)
+    """
+    cdef atomic.ssize_t x = 3
+    cdef Py_ssize_t expected = 1
+    failed = atomic.compare_exchange(&x, &expected, 5)
+    seen = expected
+    succeeded = atomic.compare_exchange(&x, &expected, 7, atomic.acq_rel)
+    return failed, seen, succeeded, x
+
+def test_compare_exchange_loop(long n):
+    """
+    >>> test_compare_exchange_loop(1000)
+    1000
+    """
+    cdef atomic.long value = 0
+    cdef long i, old
+    for i in prange(n, nogil=True):
+        old = atomic.load(&value, atomic.relaxed)
+        while not atomic.compare_exchange(&value, &old, old + 1):
+            pass
+    return value
+
+def test_pointer():
+    """
+    >>> test_pointer()
+    (True, True)
+    """
+    cdef int a = 1, b = 2
+    cdef atomic.ptr p = &a
+    cdef void *expected = &a
+    old = atomic.exchange(&p, &b)
+    return old == <void*>&a, atomic.compare_exchange(&p, &expected, &a) == False
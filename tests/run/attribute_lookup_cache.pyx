@@ -0,0 +1,148 @@
+# mode: run
+# tag: getattr, type_version_tag
+
+import sys
+
+
+class Row(object):
+    kind = 'row'
+    def __init__(self, field):
+        self.field = field
+    def method(self):
+        return 'method'
+
+class Slots(object):
+    __slots__ = ('field', 'other')
+    def __init__(self, field):
+        self.field = field
+
+class Property(object):
+    @property
+    def field(self):
+        return 'property'
+
+class GetAttr(object):
+    def __getattr__(self, name):
+        return 'getattr ' + name
+
+cdef class Ext:
+    cdef public object field
+    def __init__(self, field):
+        self.field = field
+
+class OldStyle:
+    field = 'old style'
+
+
+def get_field(obj):
+    return obj.field
+
+def get_kind(obj):
+    return obj.kind
+
+def get_other(obj):
+    return obj.other
+
+
+def test_types():
+    """
+    >>> test_types()
+    [1, 2, 'property', 'getattr field', 3, 'old style', 4, 1]
+    """
+    objects = [Row(1), Slots(2), Property(), GetAttr(), Ext(3), OldStyle(), Row(4), Slots(1)]
+    return [get_field(obj) for obj in objects]
+
+def test_instance_shadows_class():
+    """
+    >>> test_instance_shadows_class()
+    ('row', 'instance', 'row')
+    """
+    row = Row(1)
+    result = [get_kind(row)]
+    row.kind = 'instance'
+    result.append(get_kind(row))
+    del row.kind
+    result.append(get_kind(row))
+    return tuple(result)
+
+def test_class_modification():
+    """
+    >>> test_class_modification()
+    ('row', 'changed', 'data descriptor', 'row')
+    """
+    class Sub(Row):
+        pass
+    obj = Sub(1)
+    obj.kind = 'instance'
+    del obj.kind
+    result = [get_kind(obj)]
+    Row.kind = 'changed'
+    result.append(get_kind(obj))
+    Sub.kind = property(lambda self: 'data descriptor')
+    obj.__dict__['kind'] = 'hidden by the property'
+    result.append(get_kind(obj))
+    del Sub.kind
+    Row.kind = 'row'
+    del obj.__dict__['kind']
+    result.append(get_kind(obj))
+    return tuple(result)
+
+def test_method():
+    """
+    >>> test_method()
+    ('method', True)
+    """
+    row = Row(1)
+    return row.method(), row.method.__self__ is row
+
+def test_unset_slot():
+    """
+    >>> test_unset_slot()
+    (None, 'other', None, 'other')
+    """
+    slots = Slots(1)
+    result = []
+    for i in range(2):
+        try:
+            get_other(slots)
+        except AttributeError:
+            result.append(None)
+        slots.other = 'other'
+        result.append(get_other(slots))
+        del slots.other
+    return tuple(result)
+
+def test_foreign_slot():
+    """
+    >>> test_foreign_slot()
+    TypeError
+    """
+    class Foreign(object):
+        other = Slots.__dict__['other']
+    try:
+        get_other(Foreign())
+    except TypeError:
+        print('TypeError')
+
+def test_missing_attribute():
+    """
+    >>> test_missing_attribute()
+    "'Row' object has no attribute 'other'"
+    """
+    try:
+        get_other(Row(1))
+    except AttributeError:
+        return str(sys.exc_info()[1])
+
+def test_class_assignment():
+    """
+    >>> test_class_assignment()
+    ('row', 'other kind')
+    """
+    class Other(object):
+        kind = 'other kind'
+    row = Row(1)
+    result = [get_kind(row)]
+    row.__class__ = Other
+    result.append(get_kind(row))
+    return tuple(result)
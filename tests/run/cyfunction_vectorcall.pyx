@@ -0,0 +1,148 @@
+# cython: binding=True
+# mode: run
+# tag: cyfunction, call
+
+import sys
+
+
+def args(a, b, c=3, int d=4):
+    return a, b, c, d
+
+def dynamic_default(a, b=[]):
+    b.append(a)
+    return b
+
+def no_args():
+    return 'no args'
+
+def one_arg(a):
+    return a
+
+
+def test_positional():
+    """
+    >>> test_positional()
+    ((1, 2, 3, 4), (1, 2, 5, 4), (1, 2, 5, 6))
+    """
+    return args(1, 2), args(1, 2, 5), args(1, 2, 5, 6)
+
+def test_positional_variables(a, b, c):
+    """
+    Only calls with non-constant arguments pass them as an array.
+
+    >>> test_positional_variables(1, 2, 5)
+    ((1, 2, 3, 4), (1, 2, 5, 4), (1, 2, 5, 6))
+    """
+    return args(a, b), args(a, b, c), args(a, b, c, 6)
+
+def test_keywords():
+    """
+    >>> test_keywords()
+    ((1, 2, 3, 4), (1, 2, 3, 7), (1, 2, 5, 4), (1, 2, 3, 8))
+    """
+    return args(1, b=2), args(a=1, b=2, d=7), args(c=5, b=2, a=1), args(1, 2, d=8)
+
+def test_defaults():
+    """
+    >>> test_defaults()
+    ([1], [1, 2], [3])
+    """
+    return list(dynamic_default(1)), list(dynamic_default(2)), dynamic_default(3, [])
+
+def test_one_or_no_args():
+    """
+    >>> test_one_or_no_args()
+    ('no args', 1)
+    """
+    x = 1
+    return no_args(), one_arg(x)
+
+def test_argument_errors():
+    """
+    >>> for message in test_argument_errors(): print(message)
+    args() takes at least 2 positional arguments (1 given)
+    args() takes at most 4 positional arguments (5 given)
+    args() got multiple values for keyword argument 'a'
+    args() got an unexpected keyword argument 'e'
+    an integer is required
+    """
+    one = 1
+    calls = [
+        lambda: args(one),
+        lambda: args(one, 2, 3, 4, 5),
+        lambda: args(1, 2, a=3),
+        lambda: args(1, 2, e=3),
+        lambda: args(1, 2, d='x'),
+    ]
+    messages = []
+    for call in calls:
+        try:
+            call()
+        except TypeError:
+            messages.append(str(sys.exc_info()[1]))
+    return messages
+
+def test_closure(x):
+    """
+    >>> test_closure(1)
+    ((1, 1, 2), (1, 1, 2), 3)
+    """
+    def inner(a, b=2):
+        return x, a, b
+    return inner(1), inner(a=1), (lambda a, b: a + b)(x, 2)
+
+
+class Plain(object):
+    def method(self, a, b=2):
+        return type(self).__name__, a, b
+
+def test_method():
+    """
+    >>> test_method()
+    (('Plain', 1, 2), ('Plain', 1, 3), ('Plain', 5, 2))
+    """
+    obj = Plain()
+    one = 1
+    return obj.method(one), obj.method(1, b=3), Plain.method(obj, 5)
+
+
+def test_other_callables():
+    """
+    >>> test_other_callables()
+    (3, [1, 2], 'A', {'a': 1}, (1, 2))
+    """
+    l = [1]
+    append = l.append
+    append(2)
+    return len('abc'), l, 'a'.upper(), dict(a=1), tuple([1, 2])
+
+
+cdef object global_arg
+
+def clear_global_arg(arg):
+    global global_arg
+    global_arg = None
+    return arg
+
+def test_borrowed_argument():
+    """
+    >>> test_borrowed_argument()
+    [1, 2]
+    """
+    global global_arg
+    global_arg = [1, 2]
+    return clear_global_arg(global_arg)
+
+
+def recurse(n):
+    return recurse(n + 1)
+
+def test_recursion_limit():
+    """
+    >>> test_recursion_limit()
+    'recursion limit'
+    """
+    try:
+        recurse(0)
+    except RuntimeError:
+        return 'recursion limit'
@@ -0,0 +1,85 @@
+# cython: frozen_globals=True
+# mode: run
+# tag: globals
+
+import sys
+
+value = 1
+counter = 0
+rebound_later = 'original'
+
+def get_value():
+    return value
+
+def get_len():
+    return len
+
+def increment():
+    global counter
+    counter += 1
+    return counter
+
+def get_counter():
+    return counter
+
+def get_rebound_later():
+    return rebound_later
+
+def get_deleted():
+    return deleted
+
+# Reads during the module init function are not cached.
+init_values = [get_value()]
+value = 2
+init_values.append(get_value())
+
+deleted = 1
+del deleted
+
+
+def test_init_values():
+    """
+    >>> test_init_values()
+    [1, 2]
+    """
+    return init_values
+
+def test_value():
+    """
+    >>> test_value()
+    (2, 2)
+    """
+    return get_value(), get_value()
+
+def test_builtin():
+    """
+    >>> test_builtin() is len
+    True
+    """
+    return get_len()
+
+def test_global_statement():
+    """
+    >>> test_global_statement()
+    (1, 1, 2, 2)
+    """
+    return increment(), get_counter(), increment(), get_counter()
+
+def test_rebinding_after_import():
+    """
+    >>> test_rebinding_after_import()
+    ('original', 'original')
+    """
+    first = get_rebound_later()
+    sys.modules[__name__].rebound_later = 'rebound'
+    return first, get_rebound_later()
+
+def test_deleted_global():
+    """
+    >>> test_deleted_global()
+    'NameError'
+    """
+    try:
+        return get_deleted()
+    except NameError:
+        return 'NameError'
@@ -0,0 +1,144 @@
+# mode: run
+# tag: nogil
+# cython: infer_nogil=True
+
+cimport cython
+from cython.view cimport array
+
+
+cdef int add(int a, int b):
+    return a + b
+
+cdef int twice(int a):
+    # only becomes nogil after add() was inferred nogil
+    return add(a, a)
+
+cdef int checked(int a) except -1:
+    if a < 0:
+        return -1
+    return a
+
+cdef int raises_negative(int a) nogil except -1:
+    if a < 0:
+        with gil:
+            raise ValueError(a)
+    return a
+
+cdef int prints(int a):
+    print a
+    return a
+
+@cython.infer_nogil(False)
+cdef int not_inferred(int a):
+    return a
+
+
+def call_inferred_without_gil(int a):
+    """
+    >>> call_inferred_without_gil(3)
+    12
+    """
+    cdef int result
+    with nogil:
+        result = twice(twice(a))
+    return result
+
+def call_checked_without_gil(int a):
+    """
+    >>> call_checked_without_gil(5)
+    5
+    """
+    cdef int result
+    with nogil:
+        result = checked(a)
+    return result
+
+def call_gil_requiring(int a):
+    """
+    >>> call_gil_requiring(7)
+    7
+    7
+    """
+    return prints(not_inferred(a))
+
+@cython.test_assert_path_exists("//GILStatNode")
+@cython.boundscheck(False)
+@cython.wraparound(False)
+def sum_squares(int n):
+    """
+    >>> sum_squares(4)
+    14.0
+    """
+    cdef double[:] data = array(shape=(n,), itemsize=sizeof(double), format='d')
+    cdef double s = 0
+    cdef Py_ssize_t i
+    for i in range(n):
+        data[i] = i
+    for i in range(data.shape[0]):
+        s += data[i] * data[i]
+    return s
+
+@cython.test_assert_path_exists("//GILStatNode")
+def count_up(int n):
+    """
+    >>> count_up(10)
+    90
+    >>> count_up(-1)
+    Traceback (most recent call last):
+    ValueError: -1
+    """
+    cdef int i, s = 0
+    if n < 0:
+        raise ValueError(n)
+    for i in range(n):
+        s += twice(i)
+    return s
+
+@cython.test_assert_path_exists("//GILStatNode")
+def propagate_error(int n):
+    """
+    >>> propagate_error(3)
+    9999
+    >>> propagate_error(-3)
+    Traceback (most recent call last):
+    ValueError: -3
+    """
+    cdef int i, s = 0
+    for i in range(n, 10000):
+        s = raises_negative(i)
+    return s
+
+@cython.test_fail_if_path_exists("//GILStatNode")
+def cheap_loop():
+    """
+    >>> cheap_loop()
+    3
+    """
+    cdef int i, s = 0
+    for i in range(3):
+        s += i
+    return s
+
+@cython.test_fail_if_path_exists("//GILStatNode")
+def python_loop(int n):
+    """
+    >>> python_loop(10000)
+    10000
+    """
+    cdef int i
+    result = 0
+    for i in range(n):
+        result += 1
+    return result
+
+@cython.test_fail_if_path_exists("//GILStatNode")
+@cython.infer_nogil_loop_cost(1000000000)
+def below_threshold(int n):
+    """
+    >>> below_threshold(100)
+    100
+    """
+    cdef int i, s = 0
+    for i in range(n):
+        s += 1
+    return s
@@ -0,0 +1,153 @@
+# Conversions between Python ints and C integers at the boundaries of
+# the one and two digit fast paths for PyLong objects (15 or 30 bits
+# per digit) and of the small int cache.
+
+import sys
+
+LONG_MAX = <long>((<unsigned long>-1) >> 1)
+LONG_MIN = -LONG_MAX - 1
+ULONG_MAX = <unsigned long>-1
+LONGLONG_MAX = <long long>((<unsigned long long>-1) >> 1)
+LONGLONG_MIN = -LONGLONG_MAX - 1
+ULONGLONG_MAX = <unsigned long long>-1
+SSIZE_T_MAX = <Py_ssize_t>((<size_t>-1) >> 1)
+SSIZE_T_MIN = -SSIZE_T_MAX - 1
+INT_MAX = <int>((<unsigned int>-1) >> 1)
+INT_MIN = -INT_MAX - 1
+
+def boundary_values():
+    values = [0, 1, 255, 256, 257]
+    for bits in (15, 30, 31, 32, 45, 60, 62, 63, 64, 90):
+        for offset in (-1, 0, 1):
+            values.append(2 ** bits + offset)
+    values += [-v for v in values]
+    values.sort()
+    return values
+
+def check(convert, min_value, max_value):
+    """
+    Returns the values that were not converted as expected.
+    """
+    errors = []
+    for value in boundary_values():
+        try:
+            result = convert(value)
+        except OverflowError:
+            if min_value <= value <= max_value:
+                errors.append(value)
+        else:
+            if not min_value <= value <= max_value or result != value:
+                errors.append(value)
+    return errors
+
+def as_int(int x):
+    return x
+
+def as_long(long x):
+    return x
+
+def as_ulong(unsigned long x):
+    return x
+
+def as_longlong(long long x):
+    return x
+
+def as_ulonglong(unsigned long long x):
+    return x
+
+def as_ssize_t(Py_ssize_t x):
+    return x
+
+def test_int():
+    """
+    >>> test_int()
+    []
+    """
+    return check(as_int, INT_MIN, INT_MAX)
+
+def test_long():
+    """
+    >>> test_long()
+    []
+    """
+    return check(as_long, LONG_MIN, LONG_MAX)
+
+def test_ulong():
+    """
+    >>> test_ulong()
+    []
+    """
+    return check(as_ulong, 0, ULONG_MAX)
+
+def test_longlong():
+    """
+    >>> test_longlong()
+    []
+    """
+    return check(as_longlong, LONGLONG_MIN, LONGLONG_MAX)
+
+def test_ulonglong():
+    """
+    >>> test_ulonglong()
+    []
+    """
+    return check(as_ulonglong, 0, ULONGLONG_MAX)
+
+def test_ssize_t():
+    """
+    >>> test_ssize_t()
+    []
+    """
+    return check(as_ssize_t, SSIZE_T_MIN, SSIZE_T_MAX)
+
+
+class Index(object):
+    def __init__(self, value):
+        self.value = value
+    def __index__(self):
+        return self.value
+
+def test_ssize_t_index():
+    """
+    >>> test_ssize_t_index()
+    (5, -3, True)
+    >>> as_ssize_t(1.5)  #doctest: +ELLIPSIS
+    Traceback (most recent call last):
+    TypeError: 'float' object cannot be interpreted as ...
+    """
+    class LongSub(type(2 ** 100)):
+        pass
+    return as_ssize_t(Index(5)), as_ssize_t(LongSub(-3)), as_ssize_t(LongSub(2 ** 40)) == 2 ** 40
+
+
+def small_ints(long a, unsigned long b, long long c, unsigned long long d, Py_ssize_t e):
+    return a, b, c, d, e
+
+def test_small_int_identity():
+    """
+    >>> test_small_int_identity()
+    True
+    """
+    # Python 2 returns a long for the long long and unsigned types
+    for value in (-5, 0, 1, 100, 256):
+        same = int(str(value))
+        result = small_ints(value, abs(value), value, abs(value), value)
+        if result != (value, abs(value), value, abs(value), value):
+            return value
+        if result[0] is not same or result[4] is not same:
+            return value
+        if sys.version_info[0] >= 3 and (
+                result[1] is not abs(same) or result[2] is not same or result[3] is not abs(same)):
+            return value
+    return True
+
+def test_large_ints():
+    """
+    >>> test_large_ints()
+    True
+    """
+    for value in (-6, 257, 2 ** 30, 2 ** 31 - 1):
+        result = small_ints(value, abs(value), value, abs(value), value)
+        if result != (value, abs(value), value, abs(value), value):
+            return value
+    return True
@@ -0,0 +1,90 @@
+cimport cython
+
+def noninterned(s):
+    return ''.join(list(s))
+
+
+def many(a, b, c=3, d=4, e=5, f=6, g=7, h=8, *, timeout=None, verbose=False):
+    """
+    >>> many(1, 2)
+    (1, 2, 3, 4, 5, 6, 7, 8, None, False)
+    >>> many(1, 2, verbose=True, h=80, c=30)
+    (1, 2, 30, 4, 5, 6, 7, 80, None, True)
+    >>> many(b=2, a=1, timeout=10)
+    (1, 2, 3, 4, 5, 6, 7, 8, 10, False)
+    >>> many(1, 2, **{noninterned('timeout'): 10, noninterned('g'): 70})
+    (1, 2, 3, 4, 5, 6, 70, 8, 10, False)
+
+    >>> many(1, 2, a=1)
+    Traceback (most recent call last):
+    TypeError: many() got multiple values for keyword argument 'a'
+    >>> many(1, 2, 3, c=3)
+    Traceback (most recent call last):
+    TypeError: many() got multiple values for keyword argument 'c'
+    >>> many(1, 2, timeouts=10)
+    Traceback (most recent call last):
+    TypeError: many() got an unexpected keyword argument 'timeouts'
+    >>> many(1, 2, **{noninterned('x'): 10})
+    Traceback (most recent call last):
+    TypeError: many() got an unexpected keyword argument 'x'
+    """
+    return a, b, c, d, e, f, g, h, timeout, verbose
+
+
+@cython.binding(True)
+def many_binding(a, b, c=3, d=4, e=5, f=6, g=7, h=8, timeout=None, verbose=False):
+    """
+    >>> many_binding(1, 2, verbose=True, h=80, c=30)
+    (1, 2, 30, 4, 5, 6, 7, 80, None, True)
+    >>> many_binding(b=2, a=1, timeout=10)
+    (1, 2, 3, 4, 5, 6, 7, 8, 10, False)
+    >>> many_binding(1, 2, **{noninterned('timeout'): 10, noninterned('g'): 70})
+    (1, 2, 3, 4, 5, 6, 70, 8, 10, False)
+    >>> many_binding(1, 2, 3, c=3)
+    Traceback (most recent call last):
+    TypeError: many_binding() got multiple values for keyword argument 'c'
+    >>> many_binding(1, 2, timeouts=10)
+    Traceback (most recent call last):
+    TypeError: many_binding() got an unexpected keyword argument 'timeouts'
+    """
+    return a, b, c, d, e, f, g, h, timeout, verbose
+
+
+def colliding(ab_xa=1, ab_ya=2, ab_za=3, ba_xb=4, ba_yb=5, ba_zb=6, ca_xc=7, ca_yc=8):
+    """
+    Names of the same length and with the same first, middle and last
+    character cannot be told apart by the hash table.
+
+    >>> colliding()
+    (1, 2, 3, 4, 5, 6, 7, 8)
+    >>> colliding(ab_za=30, ab_ya=20, ca_yc=80, ab_xa=10)
+    (10, 20, 30, 4, 5, 6, 7, 80)
+    >>> colliding(1, ab_xa=10)
+    Traceback (most recent call last):
+    TypeError: colliding() got multiple values for keyword argument 'ab_xa'
+    >>> colliding(ab_wa=10)
+    Traceback (most recent call last):
+    TypeError: colliding() got an unexpected keyword argument 'ab_wa'
+    """
+    return ab_xa, ab_ya, ab_za, ba_xb, ba_yb, ba_zb, ca_xc, ca_yc
+
+
+def star_kwargs(a, b=2, c=3, d=4, e=5, f=6, g=7, h=8, **kwargs):
+    """
+    >>> star_kwargs(1, h=80, x=1, y=2)
+    (1, 2, 3, 4, 5, 6, 7, 80, [('x', 1), ('y', 2)])
+
+    Many more keywords than arguments.
+
+    >>> kw = dict([('x%d' % i, i) for i in range(20)])
+    >>> kw.update(b=20, g=70)
+    >>> result = star_kwargs(1, **kw)
+    >>> result[:8]
+    (1, 20, 3, 4, 5, 6, 70, 8)
+    >>> result[8] == sorted([('x%d' % i, i) for i in range(20)])
+    True
+    >>> star_kwargs(1, a=1, **kw)
+    Traceback (most recent call last):
+    TypeError: star_kwargs() got multiple values for keyword argument 'a'
+    """
+    return a, b, c, d, e, f, g, h, sorted(kwargs.items())
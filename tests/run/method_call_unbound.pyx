@@ -0,0 +1,148 @@
+# mode: run
+# tag: call, method
+
+import sys
+
+
+class Plain(object):
+    def method(self, a, b=2):
+        return type(self).__name__, a, b
+
+    @staticmethod
+    def static(a):
+        return 'static', a
+
+    @classmethod
+    def cls(cls, a):
+        return cls.__name__, a
+
+    builtin = len
+
+class Sub(Plain):
+    pass
+
+class GetAttr(object):
+    def __getattr__(self, name):
+        return lambda *args: (name,) + args
+
+class OldStyle:
+    def method(self, a):
+        return 'old style', a
+
+cdef class Ext:
+    def noargs(self):
+        return 'noargs'
+    def onearg(self, a):
+        return 'onearg', a
+    def args(self, a, b=2, *, c=3):
+        return 'args', a, b, c
+
+class Foreign(object):
+    append = list.append
+
+
+def test_plain():
+    """
+    >>> test_plain()
+    [('Plain', 1, 2), ('Plain', 1, 3), ('Sub', 1, 4), ('static', 5), ('Plain', 6), ('Sub', 7), 3]
+    """
+    obj, sub = Plain(), Sub()
+    return [obj.method(1), obj.method(1, b=3), sub.method(1, 4),
+            obj.static(5), obj.cls(6), sub.cls(7), obj.builtin('abc')]
+
+def test_shadowed_by_instance():
+    """
+    >>> test_shadowed_by_instance()
+    (('Plain', 1, 2), 'instance', ('Plain', 1, 2))
+    """
+    obj = Plain()
+    result = [obj.method(1)]
+    obj.method = lambda a: 'instance'
+    result.append(obj.method(1))
+    del obj.method
+    result.append(obj.method(1))
+    return tuple(result)
+
+def test_getattr_and_old_style():
+    """
+    >>> test_getattr_and_old_style()
+    (('method', 1), ('old style', 2))
+    """
+    return GetAttr().method(1), OldStyle().method(2)
+
+def test_builtin_methods():
+    """
+    >>> test_builtin_methods()
+    ([1, 2, 3], 'x', None, 'a-b', ['a', 'b'], [1, 2])
+    """
+    l = [1]
+    l.append(2)
+    l.extend([3])
+    d = {'a': 'x'}
+    s = 'a b'
+    return l, d.get('a'), d.get('b', None), '-'.join(s.split()), s.split(' ', 1), sorted(set([2, 1]))
+
+def test_extension_type():
+    """
+    >>> test_extension_type()
+    ('noargs', ('onearg', 1), ('args', 1, 2, 3), ('args', 1, 4, 5))
+    """
+    obj = Ext()
+    return obj.noargs(), obj.onearg(1), obj.args(1), obj.args(1, c=5, b=4)
+
+def append_two(l):
+    return l.append(1, 2)
+
+def test_argument_errors():
+    """
+    >>> for message in test_argument_errors(): print(message)
+    TypeError
+    TypeError
+    TypeError
+    """
+    obj = Ext()
+    messages = []
+    for call in [lambda: obj.noargs(1), lambda: obj.onearg(), lambda: append_two([])]:
+        try:
+            call()
+        except TypeError:
+            messages.append('TypeError')
+    return messages
+
+def test_foreign_method_descriptor():
+    """
+    >>> test_foreign_method_descriptor()
+    'TypeError'
+    """
+    try:
+        Foreign().append(1)
+    except TypeError:
+        return 'TypeError'
+
+def test_evaluation_order():
+    """
+    >>> test_evaluation_order()
+    ([], 'AttributeError')
+    """
+    evaluated = []
+    def arg():
+        evaluated.append(1)
+        return 1
+    try:
+        Plain().missing(arg())
+    except AttributeError:
+        return evaluated, 'AttributeError'
+
+def test_module_function():
+    """
+    >>> test_module_function()
+    True
+    """
+    return sys.getrecursionlimit() > 0
+
+def test_self_reference():
+    """
+    >>> test_self_reference()
+    ('Plain', 1, 2)
+    """
+    return Plain().method(1)
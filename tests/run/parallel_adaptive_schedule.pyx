@@ -0,0 +1,79 @@
+# tag: run
+# tag: openmp
+
+from cython.parallel import prange
+cimport openmp
+
+from libc.string cimport memset, strcmp
+from libc.stdlib cimport getenv
+
+cdef extern from *:
+    ctypedef struct AdaptiveSchedule "__Pyx_AdaptiveSchedule":
+        pass
+    ctypedef struct AdaptiveScheduleCall "__Pyx_AdaptiveScheduleCall":
+        pass
+    void adaptive_schedule_begin "__Pyx_AdaptiveSchedule_Begin" (
+        AdaptiveSchedule *schedule, AdaptiveScheduleCall *call, double nsteps)
+    void adaptive_schedule_end "__Pyx_AdaptiveSchedule_End" (
+        AdaptiveSchedule *schedule, AdaptiveScheduleCall *call)
+
+def adaptive_sum(int n):
+    """
+    >>> adaptive_sum(1000)
+    499500
+    """
+    cdef int i, s = 0
+    for i in prange(n, nogil=True, schedule='adaptive'):
+        s += i
+    return s
+
+def selected_kinds(steps):
+    """
+    Runs the schedule selection of a new call site for each iteration
+    count in 'steps' and returns the selected schedule kinds.
+    """
+    cdef AdaptiveSchedule schedule
+    cdef AdaptiveScheduleCall call
+    cdef openmp.omp_sched_t kind
+    cdef int chunksize
+    memset(&schedule, 0, sizeof(schedule))
+    kinds = []
+    for nsteps in steps:
+        adaptive_schedule_begin(&schedule, &call, nsteps)
+        openmp.omp_get_schedule(&kind, &chunksize)
+        kinds.append(<int> kind)
+        adaptive_schedule_end(&schedule, &call)
+    return kinds
+
+def test_exploration():
+    """
+    The first executions of a call site try the static, dynamic and guided
+    schedules, a large change of the iteration count restarts the search.
+    The runtime schedule of the caller is restored afterwards.
+
+    >>> test_exploration()
+    """
+    cdef openmp.omp_sched_t kind
+    cdef int chunksize
+    openmp.omp_set_schedule(openmp.omp_sched_dynamic, 7)
+    kinds = selected_kinds([100, 100, 100, 1000, 1000])
+    openmp.omp_get_schedule(&kind, &chunksize)
+    assert kind == openmp.omp_sched_dynamic and chunksize == 7, (kind, chunksize)
+    mode = getenv("CYTHON_ADAPTIVE_SCHEDULE")
+    if mode and strcmp(mode, "deterministic") == 0:
+        expected = [openmp.omp_sched_static] * 5
+    else:
+        expected = [openmp.omp_sched_static, openmp.omp_sched_dynamic,
+                    openmp.omp_sched_guided, openmp.omp_sched_static,
+                    openmp.omp_sched_dynamic]
+    assert kinds == expected, kinds
+
+def test_many_calls():
+    """
+    >>> test_many_calls()
+    """
+    cdef int n
+    for n in range(1, 2000, 7):
+        assert adaptive_sum(n) == n * (n - 1) // 2, n
+    for n in range(400):
+        assert adaptive_sum(1000) == 499500
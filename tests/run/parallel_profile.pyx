@@ -0,0 +1,75 @@
+# tag: run
+# tag: openmp
+# cython: parallel_profile=True
+
+cimport cython.parallel
+from cython.parallel import prange, parallel
+cimport openmp
+
+def sum_range(int n):
+    """
+    >>> sum_range(1000)
+    499500
+    """
+    cdef int i, s = 0
+    for i in prange(n, nogil=True, num_threads=4, schedule='static'):
+        s += i
+    return s
+
+def parallel_block():
+    """
+    >>> parallel_block()
+    """
+    cdef int x = 0
+    with nogil, parallel(num_threads=2):
+        x = 1
+
+def nested(int n):
+    """
+    >>> nested(10)
+    100
+    """
+    cdef int i, j, s = 0
+    with nogil, parallel(num_threads=2):
+        for i in prange(n):
+            for j in prange(n):
+                s += 1
+    return s
+
+def profile_stats():
+    """
+    >>> _ = profile_stats()
+    >>> sum_range(1000)
+    499500
+    >>> sum_range(1000)
+    499500
+    >>> sum_range(0)
+    0
+    >>> parallel_block()
+    >>> nested(10)
+    100
+    >>> stats = profile_stats()
+    >>> [(s['kind'], s['line']) for s in stats]
+    [('prange', 15), ('parallel', 24), ('parallel', 33), ('prange', 34)]
+    >>> [int(s['calls']) for s in stats]
+    [3, 1, 1, 0]
+    >>> [int(sum(t['iterations'] for t in s['threads'])) for s in stats]
+    [2000, 0, 0, 10]
+    >>> all(t['chunks'] <= t['iterations'] for s in stats for t in s['threads'])
+    True
+    >>> all(s['imbalance'] >= 1.0 for s in stats)
+    True
+    >>> all(1 <= s['max_threads'] <= 4 for s in stats[:3])
+    True
+    >>> sorted(stats[0]['threads'][0])
+    ['busy_time', 'calls', 'chunks', 'iterations', 'thread', 'wait_time']
+
+    >>> stats = profile_stats()
+    >>> [int(s['calls']) for s in stats]
+    [0, 0, 0, 0]
+    >>> [s['threads'] for s in stats]
+    [[], [], [], []]
+    """
+    stats = globals()['__pyx_parallel_profile__'](True)
+    stats.sort(key=lambda s: s['line'])
+    return stats
@@ -0,0 +1,133 @@
+# tag: run
+# tag: openmp
+
+cimport cython.parallel
+from cython.parallel import sections, section, threadid
+from cython.ringbuffer cimport *
+cimport openmp
+
+def test_sections():
+    """
+    >>> test_sections()
+    (1, 2, 3)
+    """
+    cdef int a = 0, b = 0, c = 0
+    cdef int *pa = &a, *pb = &b, *pc = &c
+    with nogil, sections(num_threads=3):
+        with section():
+            pa[0] = 1
+        with section():
+            pb[0] = 2
+        with section():
+            pc[0] = 3
+    return a, b, c
+
+def test_pipeline(int n):
+    """
+    Three stages connected by single-producer/single-consumer ring buffers.
+
+    >>> test_pipeline(10000) == sum(i * i for i in range(10000))
+    True
+    """
+    cdef spsc_ring *parsed = spsc_ring_new(16, sizeof(long))
+    cdef spsc_ring *transformed = spsc_ring_new(16, sizeof(long))
+    cdef long item, i, total = 0
+    cdef long *ptotal = &total
+
+    openmp.omp_set_dynamic(0)
+    with nogil, sections(num_threads=3):
+        with section():
+            for i in range(n):
+                spsc_ring_push_wait(parsed, &i)
+            spsc_ring_close(parsed)
+        with section():
+            while spsc_ring_pop_wait(parsed, &item):
+                item = item * item
+                spsc_ring_push_wait(transformed, &item)
+            spsc_ring_close(transformed)
+        with section():
+            while spsc_ring_pop_wait(transformed, &item):
+                ptotal[0] += item
+
+    spsc_ring_free(parsed)
+    spsc_ring_free(transformed)
+    return total
+
+def test_mpmc(int n):
+    """
+    >>> test_mpmc(5000) == 2 * sum(range(5000))
+    True
+    """
+    cdef mpmc_ring *ring = mpmc_ring_new(8, sizeof(int))
+    cdef int i, j, item, consumed = 0
+    cdef long total = 0
+    cdef long *ptotal = &total
+    cdef int *pconsumed = &consumed
+
+    openmp.omp_set_dynamic(0)
+    with nogil, sections(num_threads=3):
+        with section():
+            for i in range(n):
+                mpmc_ring_push_wait(ring, &i)
+        with section():
+            for j in range(n):
+                mpmc_ring_push_wait(ring, &j)
+        with section():
+            while pconsumed[0] < 2 * n:
+                if mpmc_ring_pop(ring, &item):
+                    ptotal[0] += item
+                    pconsumed[0] += 1
+
+    mpmc_ring_free(ring)
+    return total
+
+def test_ring_capacity():
+    """
+    >>> test_ring_capacity()
+    (8, 8, False, [0, 1, 2, 3, 4, 5, 6, 7], False)
+    """
+    cdef spsc_ring *ring = spsc_ring_new(5, sizeof(int))
+    cdef int i, item
+    cdef size_t capacity = spsc_ring_capacity(ring)
+    for i in range(10):
+        if not spsc_ring_push(ring, &i):
+            break
+    size = spsc_ring_size(ring)
+    full = spsc_ring_push(ring, &i)
+    items = []
+    while spsc_ring_pop(ring, &item):
+        items.append(item)
+    spsc_ring_close(ring)
+    closed_pop = spsc_ring_pop_wait(ring, &item)
+    spsc_ring_free(ring)
+    return capacity, size, full, items, closed_pop
+
+def test_sections_exception():
+    """
+    >>> test_sections_exception()
+    Traceback (most recent call last):
+    ValueError: raised in a section
+    """
+    cdef int x = 0
+    with nogil, sections():
+        with section():
+            x = 1
+        with section():
+            with gil:
+                raise ValueError("raised in a section")
+
+cdef int sections_return() nogil:
+    cdef int x = 0
+    with sections(num_threads=2):
+        with section():
+            x = 1
+        with section():
+            return 2
+    return 0
+
+def test_sections_return():
+    """
+    >>> test_sections_return()
+    2
+    """
+    return sections_return()
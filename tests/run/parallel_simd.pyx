@@ -0,0 +1,100 @@
+# tag: run
+# tag: openmp
+
+cimport cython
+from cython.parallel import prange, simd
+from libc.stdlib cimport malloc, free
+
+
+def test_simd_loop(int n):
+    """
+    >>> test_simd_loop(10)
+    (45, 9)
+    >>> test_simd_loop(0)
+    (0, -1)
+    """
+    cdef int i = -1
+    cdef int total = 0
+
+    for i in simd(n):
+        total += i
+
+    return total, i
+
+
+def test_simd_lastprivate(int n):
+    """
+    >>> test_simd_lastprivate(4)
+    (20.0, 8.0)
+    """
+    cdef double *x = <double *> malloc(n * sizeof(double))
+    cdef Py_ssize_t i
+    cdef double y = 0, total = 0
+
+    for i in range(n):
+        x[i] = i + 1
+
+    for i in simd(n, safelen=4):
+        y = 2 * x[i]
+        total += y
+
+    free(x)
+    return total, y
+
+
+def test_simd_with_gil(int n):
+    """
+    >>> test_simd_with_gil(4)
+    [0, 1, 2, 3]
+    """
+    cdef int i
+    result = []
+    for i in simd(n):
+        result.append(i)
+    return result
+
+
+def test_simd_break(int n):
+    """
+    >>> test_simd_break(10)
+    5
+    """
+    cdef int i
+    for i in simd(n):
+        if i == 5:
+            break
+    return i
+
+
+def test_prange_simd(int n):
+    """
+    >>> test_prange_simd(100)
+    9900.0
+    """
+    cdef double *x = <double *> malloc(n * sizeof(double))
+    cdef Py_ssize_t i
+    cdef double total = 0
+
+    for i in range(n):
+        x[i] = i
+
+    for i in prange(n, nogil=True, simd=True, safelen=8):
+        total += 2 * x[i]
+
+    free(x)
+    return total
+
+
+def test_nested_simd(int n, int m):
+    """
+    >>> test_nested_simd(10, 10)
+    2025
+    """
+    cdef int i, j
+    cdef long total = 0
+
+    for i in prange(n, nogil=True):
+        for j in simd(m):
+            total += i * j
+
+    return total
@@ -505,6 +505,39 @@ def test_parallel_exc_cpdef():
     parallel_exc_cpdef_unnested()
     parallel_exc_cpdef()
 
+@cython.cdivision(False)
+def test_parallel_exceptions_repeated(int zero):
+    """
+    Exceptions raised without the GIL must survive until they are saved for
+    the master thread, and exceptions of other threads that lost the race
+    must not leak into later parallel sections.
+
+    >>> test_parallel_exceptions_repeated(0)
+    (20, 20)
+    """
+    cdef int i, k, x = 0
+    cdef int nogil_errors = 0, gil_errors = 0
+
+    for k in range(20):
+        try:
+            for i in prange(100, nogil=True, num_threads=4):
+                x = i // zero
+        except ZeroDivisionError:
+            nogil_errors += 1
+
+        try:
+            for i in prange(100, nogil=True, num_threads=4):
+                with gil:
+                    raise ValueError(i)
+        except ValueError:
+            gil_errors += 1
+
+    for i in prange(100, nogil=True, num_threads=4):
+        with gil:
+            x = i
+
+    return nogil_errors, gil_errors
+
 cdef int parallel_exc_nogil_swallow() except -1:
     cdef int i, j
     for i in prange(10, nogil=True):